@@ -0,0 +1,441 @@
+/**
+ * @file
+ * @brief Measures the cost of the %cpuidpp queries.
+ *
+ * The results are written as JSON to the standard output or to the file given
+ * as the first command line argument.
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif // defined(_MSC_VER)
+
+#include <cpuidpp/cpuidpp.hpp>
+#include <cpuidpp/dump.hpp>
+#include <cpuidpp/feature.hpp>
+#include <cpuidpp/memops.hpp>
+#include <cpuidpp/pmu.hpp>
+#include <cpuidpp/source.hpp>
+#include <cpuidpp/version.hpp>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+//! Number of times each measurement is repeated.
+constexpr int Repetitions = 15;
+
+struct Result
+{
+    std::string name;
+    std::uint64_t iterations;
+    unsigned threads;
+    double median;
+    double min;
+    double max;
+};
+
+//! Prevents the compiler from discarding the benchmarked computation.
+std::atomic<unsigned> sink{0};
+
+void raw_cpuid(unsigned leaf, unsigned subleaf, unsigned* info)
+{
+#if defined(_MSC_VER)
+    __cpuidex(reinterpret_cast<int*>(info), static_cast<int>(leaf),
+              static_cast<int>(subleaf));
+#else
+    __cpuid_count(leaf, subleaf, info[0], info[1], info[2], info[3]);
+#endif // defined(_MSC_VER)
+}
+
+double elapsed_ns(Clock::time_point start, Clock::time_point stop)
+{
+    return static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start)
+            .count());
+}
+
+Result summarize(std::string name, std::uint64_t iterations, unsigned threads,
+                 std::vector<double> samples)
+{
+    std::sort(samples.begin(), samples.end());
+
+    Result result;
+    result.name = std::move(name);
+    result.iterations = iterations;
+    result.threads = threads;
+    result.median = samples[samples.size() / 2];
+    result.min = samples.front();
+    result.max = samples.back();
+
+    return result;
+}
+
+/**
+ * @brief Measures the average time of a single invocation of @p fn in
+ *        nanoseconds.
+ *
+ * @p fn returns a value that is accumulated to keep the call alive.
+ */
+template<class F>
+Result measure(std::string name, std::uint64_t iterations, F fn)
+{
+    std::vector<double> samples;
+    samples.reserve(Repetitions);
+
+    for (int r = 0; r != Repetitions; ++r) {
+        unsigned accumulated = 0;
+
+        const Clock::time_point start = Clock::now();
+
+        for (std::uint64_t i = 0; i != iterations; ++i) {
+            accumulated += static_cast<unsigned>(fn());
+        }
+
+        const Clock::time_point stop = Clock::now();
+
+        sink.fetch_add(accumulated, std::memory_order_relaxed);
+        samples.push_back(elapsed_ns(start, stop) /
+                          static_cast<double>(iterations));
+    }
+
+    return summarize(std::move(name), iterations, 1, std::move(samples));
+}
+
+/**
+ * @brief Measures the average time of a single invocation of @p fn while @p
+ *        threads threads invoke it concurrently.
+ */
+template<class F>
+Result measure_concurrent(std::string name, std::uint64_t iterations,
+                          unsigned threads, F fn)
+{
+    std::vector<double> samples;
+    samples.reserve(Repetitions);
+
+    for (int r = 0; r != Repetitions; ++r) {
+        std::atomic<unsigned> ready{0};
+        std::atomic<bool> go{false};
+        std::vector<double> per_thread(threads);
+        std::vector<std::thread> workers;
+
+        for (unsigned t = 0; t != threads; ++t) {
+            workers.emplace_back([&, t]
+            {
+                ready.fetch_add(1);
+
+                while (!go.load()) {
+                    std::this_thread::yield();
+                }
+
+                unsigned accumulated = 0;
+                const Clock::time_point start = Clock::now();
+
+                for (std::uint64_t i = 0; i != iterations; ++i) {
+                    accumulated += static_cast<unsigned>(fn());
+                }
+
+                const Clock::time_point stop = Clock::now();
+
+                sink.fetch_add(accumulated, std::memory_order_relaxed);
+                per_thread[t] = elapsed_ns(start, stop) /
+                    static_cast<double>(iterations);
+            });
+        }
+
+        while (ready.load() != threads) {
+            std::this_thread::yield();
+        }
+
+        go.store(true);
+
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        // The slowest thread determines the latency under contention
+        samples.push_back(*std::max_element(per_thread.begin(),
+                                            per_thread.end()));
+    }
+
+    return summarize(std::move(name), iterations, threads, std::move(samples));
+}
+
+std::string escape(const std::string& value)
+{
+    std::string result;
+
+    for (char ch : value) {
+        if (ch == '"' || ch == '\\') {
+            result += '\\';
+        }
+
+        result += ch;
+    }
+
+    return result;
+}
+
+void write_json(std::ostream& out, double first_call,
+                const std::vector<Result>& results)
+{
+    out << "{\n"
+        << "  \"context\": {\n"
+        << "    \"library_version\": \"" CPUIDPP_VERSION_STRING "\",\n"
+        << "    \"vendor\": \"" << escape(cpuidpp::vendor()) << "\",\n"
+        << "    \"model\": \"" << escape(cpuidpp::model()) << "\",\n"
+        << "    \"hypervisor\": "
+        << (cpuidpp::hypervisor() ? "true" : "false") << ",\n"
+        << "    \"hardware_concurrency\": "
+        << std::thread::hardware_concurrency() << ",\n"
+        << "    \"rep_movsb_threshold\": "
+        << cpuidpp::memory_operations().rep_movsb_threshold << ",\n"
+        << "    \"non_temporal_threshold\": "
+        << cpuidpp::memory_operations().non_temporal_threshold << ",\n"
+        << "    \"repetitions\": " << Repetitions << ",\n"
+        << "    \"time_unit\": \"ns\"\n"
+        << "  },\n"
+        << "  \"first_call\": " << first_call << ",\n"
+        << "  \"benchmarks\": [\n";
+
+    for (std::size_t i = 0; i != results.size(); ++i) {
+        const Result& r = results[i];
+
+        out << "    {"
+            << "\"name\": \"" << escape(r.name) << "\", "
+            << "\"threads\": " << r.threads << ", "
+            << "\"iterations\": " << r.iterations << ", "
+            << "\"median\": " << r.median << ", "
+            << "\"min\": " << r.min << ", "
+            << "\"max\": " << r.max << "}"
+            << (i + 1 != results.size() ? ",\n" : "\n");
+    }
+
+    out << "  ]\n"
+        << "}\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    // The library state is constructed during static initialization, before
+    // main runs. Measure an equivalent construction from scratch instead: the
+    // feature detection and the cache enumeration executing CPUID.
+    const Clock::time_point start = Clock::now();
+    const std::vector<cpuidpp::cache> caches =
+        cpuidpp::cache_info(cpuidpp::hardware_cpuid());
+    const Clock::time_point stop = Clock::now();
+
+    sink.fetch_add(static_cast<unsigned>(caches.size()));
+
+    const double first_call = elapsed_ns(start, stop);
+
+    std::vector<Result> results;
+
+    results.push_back(measure("detect", 1000, []
+    {
+        cpuidpp::snapshot s;
+        cpuidpp::detect(s);
+        return s.words[cpuidpp::snapshot::leaf1_ecx];
+    }));
+
+    const cpuidpp::cpuid_dump dump = cpuidpp::cpuid_dump::capture();
+
+    results.push_back(measure("detect/dump", 1000, [&dump]
+    {
+        cpuidpp::snapshot s;
+        cpuidpp::detect(s, dump);
+        return s.words[cpuidpp::snapshot::leaf1_ecx];
+    }));
+
+    constexpr std::uint64_t Queries = 10000000;
+
+    results.push_back(measure("flag/avx2", Queries, []
+    {
+        return cpuidpp::avx2();
+    }));
+    results.push_back(measure("flag/sse4_2", Queries, []
+    {
+        return cpuidpp::sse4_2();
+    }));
+    results.push_back(measure("flag/lahf_lm", Queries, []
+    {
+        return cpuidpp::lahf_lm();
+    }));
+    results.push_back(measure("flag/avx512f_usable", Queries, []
+    {
+        return cpuidpp::avx512f_usable();
+    }));
+    results.push_back(measure("snapshot/avx2", Queries, []
+    {
+        return cpuidpp::features().avx2();
+    }));
+    results.push_back(measure("snapshot/avx512f_usable", Queries, []
+    {
+        return cpuidpp::features().avx512f_usable();
+    }));
+    results.push_back(measure("flags/v3_kernel", Queries, []
+    {
+        return cpuidpp::avx2_usable() && cpuidpp::bmi2() &&
+            cpuidpp::fma_usable() && cpuidpp::f16c_usable() &&
+            cpuidpp::movbe();
+    }));
+    results.push_back(measure("supports_all/v3_kernel", Queries, []
+    {
+        constexpr cpuidpp::feature_set required{
+            cpuidpp::feature::avx2, cpuidpp::feature::bmi2,
+            cpuidpp::feature::fma, cpuidpp::feature::f16c,
+            cpuidpp::feature::movbe
+        };
+
+        return cpuidpp::supports_all(required);
+    }));
+    results.push_back(measure("vendor", Queries, []
+    {
+        return cpuidpp::vendor().size();
+    }));
+    results.push_back(measure("model", Queries, []
+    {
+        return cpuidpp::model().size();
+    }));
+    results.push_back(measure("vendor_name", Queries, []
+    {
+        return cpuidpp::vendor_name()[0];
+    }));
+    results.push_back(measure("model_name", Queries, []
+    {
+        return cpuidpp::model_name()[0];
+    }));
+
+    // Executing CPUID causes a VM exit under virtualization which dominates
+    // its latency.
+    const unsigned leaves[][2] = {
+        {0x0, 0}, {0x1, 0}, {0x4, 0}, {0x7, 0}, {0xb, 0},
+        {0x80000000, 0}, {0x80000001, 0}, {0x80000002, 0}
+    };
+
+    for (const auto& leaf : leaves) {
+        char name[32];
+        std::snprintf(name, sizeof name, "cpuid/0x%x.%u", leaf[0], leaf[1]);
+
+        results.push_back(measure(name, 10000, [&leaf]
+        {
+            unsigned info[4];
+            raw_cpuid(leaf[0], leaf[1], info);
+            return info[0];
+        }));
+    }
+
+    // Compare the dispatched memory operations against the C library on both
+    // sides of each threshold. The dispatched variant should not be slower.
+    const cpuidpp::memory_strategy& memops = cpuidpp::memory_operations();
+    std::vector<std::size_t> sizes;
+
+    for (std::size_t threshold : {memops.rep_movsb_threshold,
+                                  memops.non_temporal_threshold}) {
+        if (threshold != 0 && threshold <= 64 * 1024 * 1024) {
+            sizes.push_back(threshold / 2);
+            sizes.push_back(threshold * 2);
+        }
+    }
+
+    for (std::size_t n : sizes) {
+        std::vector<unsigned char> src(n, 1);
+        std::vector<unsigned char> dst(n);
+        const std::uint64_t iterations =
+            std::max<std::uint64_t>(1, 256 * 1024 * 1024 / n);
+        const std::string size = std::to_string(n);
+
+        results.push_back(measure("memops/copy/" + size, iterations,
+            [&src, &dst, n]
+        {
+            cpuidpp::copy(dst.data(), src.data(), n);
+            return dst[n - 1];
+        }));
+        results.push_back(measure("memops/memcpy/" + size, iterations,
+            [&src, &dst, n]
+        {
+            std::memcpy(dst.data(), src.data(), n);
+            return dst[n - 1];
+        }));
+        results.push_back(measure("memops/fill/" + size, iterations,
+            [&dst, n]
+        {
+            cpuidpp::fill(dst.data(), 2, n);
+            return dst[n - 1];
+        }));
+        results.push_back(measure("memops/memset/" + size, iterations,
+            [&dst, n]
+        {
+            std::memset(dst.data(), 3, n);
+            return dst[n - 1];
+        }));
+    }
+
+    // Cost of measuring an empty region
+    cpuidpp::profiler profiler;
+    const std::size_t region = profiler.region("empty");
+
+    results.push_back(measure(profiler.available() ? "profiler/scope/rdpmc"
+                                                   : "profiler/scope/tsc",
+                              Queries / 10, [&profiler, region]
+    {
+        cpuidpp::profiler::scope s{profiler, region};
+        return true;
+    }));
+
+    const unsigned max_threads =
+        std::max(2U, std::thread::hardware_concurrency());
+
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        results.push_back(measure_concurrent("concurrent/flag/avx2", Queries / 10,
+            threads, []
+        {
+            return cpuidpp::avx2();
+        }));
+        results.push_back(measure_concurrent("concurrent/snapshot/avx2",
+            Queries / 10, threads, []
+        {
+            return cpuidpp::features().avx2();
+        }));
+        results.push_back(measure_concurrent("concurrent/model", Queries / 10,
+            threads, []
+        {
+            return cpuidpp::model().size();
+        }));
+    }
+
+    if (argc > 1) {
+        std::ofstream out{argv[1]};
+        write_json(out, first_call, results);
+
+        if (!out) {
+            std::cerr << "cannot write " << argv[1] << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+    else {
+        write_json(std::cout, first_call, results);
+    }
+}
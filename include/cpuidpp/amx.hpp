@@ -0,0 +1,119 @@
+/**
+ * @brief %cpuidpp Advanced Matrix Extensions enumeration.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef CPUIDPP_AMX_HPP
+#define CPUIDPP_AMX_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <cpuidpp/export.hpp>
+
+namespace cpuidpp {
+
+class cpuid_source;
+
+//! Tile register dimensions of a palette enumerated by leaf 0x1D.
+struct tile_palette
+{
+    //! Size of all tile registers in bytes.
+    std::uint32_t total_tile_bytes;
+    //! Size of a single tile register in bytes.
+    std::uint32_t bytes_per_tile;
+    //! Maximum size of a tile row in bytes.
+    std::uint32_t bytes_per_row;
+    //! Number of tile registers.
+    std::uint32_t max_names;
+    //! Maximum number of rows of a tile.
+    std::uint32_t max_rows;
+};
+
+/**
+ * @brief Advanced Matrix Extensions supported by the processor along with the
+ *        tile palettes (leaf 0x1D) and the limits of the tile matrix multiply
+ *        unit (leaf 0x1E).
+ */
+struct amx_info
+{
+    //! Indicates whether the tile architecture (@c AMX-TILE) is supported.
+    bool tile;
+    //! Indicates whether 8-bit integer multiplication (@c AMX-INT8) is supported.
+    bool int8;
+    //! Indicates whether bfloat16 multiplication (@c AMX-BF16) is supported.
+    bool bf16;
+    //! Indicates whether half-precision multiplication (@c AMX-FP16) is supported.
+    bool fp16;
+    //! Indicates whether the OS enables the @c XTILECFG and @c XTILEDATA state in @c XCR0.
+    bool os_support;
+    /**
+     * @brief Indicates whether the @c XTILEDATA state supports extended
+     *        feature disable (@c XFD).
+     *
+     * An OS using @c XFD traps the first access to the tile registers. Linux
+     * relies on it to refuse the access unless the process has requested the
+     * permission.
+     */
+    bool xfd;
+    //! Palettes starting with palette 1. Palette 0 denotes the initial state.
+    std::vector<tile_palette> palettes;
+    //! Maximum number of rows or columns of the multiply unit.
+    std::uint32_t tmul_max_k;
+    //! Maximum number of column bytes of the multiply unit.
+    std::uint32_t tmul_max_n;
+
+    /**
+     * @brief Indicates whether the processor supports the tile architecture
+     *        and the OS enables its register state.
+     *
+     * The tile registers may still be inaccessible until the process requests
+     * the permission (see @ref request_amx_permission()).
+     */
+    bool supported() const noexcept
+    {
+        return tile && os_support && !palettes.empty();
+    }
+};
+
+/**
+ * @brief Returns the Advanced Matrix Extensions of the processor.
+ *
+ * The leaves are queried once on first use.
+ */
+CPUIDPP_EXPORT const amx_info& amx_capabilities();
+
+//! Decodes the Advanced Matrix Extensions from the @c CPUID values provided by @p source.
+CPUIDPP_EXPORT amx_info amx_capabilities(const cpuid_source& source);
+
+/**
+ * @brief Requests the permission to use the tile data state for all threads
+ *        of the process.
+ *
+ * Linux enables the @c XTILEDATA state lazily and raises @c SIGILL on the
+ * first tile instruction unless the process has called
+ * @c arch_prctl(ARCH_REQ_XCOMP_PERM). The function issues the request and
+ * verifies that the kernel has granted it. The request may be repeated. Other
+ * operating systems enable the state on demand and the function only checks
+ * the processor and @c XCR0.
+ *
+ * @return @c true if tile instructions can be executed.
+ */
+CPUIDPP_EXPORT bool request_amx_permission() noexcept;
+
+/**
+ * @brief Indicates whether tile matrix multiplication kernels can be run.
+ *
+ * The processor must support the tile architecture, the OS must enable its
+ * register state and grant the process the permission to use it. The
+ * permission is requested on the first call.
+ */
+CPUIDPP_EXPORT bool amx_usable();
+
+} // namespace cpuidpp
+
+#endif // !defined(CPUIDPP_AMX_HPP)
@@ -0,0 +1,270 @@
+/**
+ * @brief %cpuidpp cache line sizes and storage padded against false sharing.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef CPUIDPP_CACHELINE_HPP
+#define CPUIDPP_CACHELINE_HPP
+
+#include <cstddef>
+#include <new>
+
+#include <cpuidpp/export.hpp>
+
+namespace cpuidpp {
+
+class cpuid_source;
+
+/**
+ * @brief Cache line sizes of the processor along with the resulting
+ *        interference sizes.
+ *
+ * Unlike @c std::hardware_destructive_interference_size, which is fixed at
+ * compile time, the interference sizes describe the processor the program
+ * runs on.
+ */
+struct cache_line_info
+{
+    //! Line size flushed by @c CLFLUSH (leaf 1 @c EBX[15:8]), or zero if @c CLFLUSH is not supported.
+    unsigned clflush_size;
+    //! Line size of the L1 data cache, or zero if the caches are not enumerated.
+    unsigned l1d_line_size;
+    /**
+     * @brief Granularity of the hardware prefetcher reported by the leaf 2
+     *        descriptors 0xF0 (64 bytes) and 0xF1 (128 bytes), or zero if not
+     *        reported.
+     *
+     * A granularity of 128 bytes indicates that the adjacent line of each
+     * pair is prefetched as well. Only Intel processors provide the
+     * descriptors.
+     */
+    unsigned prefetch_size;
+    /**
+     * @brief Maximum size of contiguous memory promoting true sharing.
+     *
+     * Equals the L1 data cache line size, the @c CLFLUSH line size or 64
+     * bytes, whichever is known first.
+     */
+    unsigned constructive_interference_size;
+    /**
+     * @brief Minimum offset between two objects avoiding false sharing.
+     *
+     * The larger of @ref constructive_interference_size and
+     * @ref prefetch_size.
+     */
+    unsigned destructive_interference_size;
+};
+
+/**
+ * @brief Returns the cache line sizes of the processor.
+ *
+ * The leaves are queried once on first use.
+ */
+CPUIDPP_EXPORT const cache_line_info& cache_lines();
+
+//! Decodes the cache line sizes from the @c CPUID values provided by @p source.
+CPUIDPP_EXPORT cache_line_info cache_lines(const cpuid_source& source);
+
+/**
+ * @brief Allocates @p size bytes aligned to @p alignment.
+ *
+ * @param alignment Power of two.
+ *
+ * @throw std::bad_alloc if the memory cannot be allocated.
+ */
+CPUIDPP_EXPORT void* aligned_allocate(std::size_t size, std::size_t alignment);
+
+//! Releases the memory returned by @ref aligned_allocate().
+CPUIDPP_EXPORT void aligned_deallocate(void* p) noexcept;
+
+/**
+ * @brief Rounds @p size up to a multiple of the destructive interference size
+ *        of the processor.
+ */
+inline std::size_t padded_size(std::size_t size)
+{
+    const std::size_t line = cache_lines().destructive_interference_size;
+    return size == 0 ? line : (size + line - 1) / line * line;
+}
+
+/**
+ * @brief Allocator aligning the storage to the destructive interference size
+ *        of the processor.
+ *
+ * Containers using the allocator start on a boundary no other allocation
+ * shares a cache line or prefetched line pair with. The elements themselves
+ * are not padded; see @ref padded_array for this purpose.
+ */
+template<class T>
+class cache_aligned_allocator
+{
+public:
+    using value_type = T;
+
+    cache_aligned_allocator() = default;
+
+    template<class U>
+    cache_aligned_allocator(const cache_aligned_allocator<U>& /*other*/) noexcept
+    {
+    }
+
+    //! Returns the alignment of the allocated storage.
+    static std::size_t alignment()
+    {
+        const std::size_t line = cache_lines().destructive_interference_size;
+        return line < alignof(T) ? alignof(T) : line;
+    }
+
+    T* allocate(std::size_t n)
+    {
+        if (n > static_cast<std::size_t>(-1) / sizeof(T)) {
+            throw std::bad_alloc{};
+        }
+
+        return static_cast<T*>(aligned_allocate(n * sizeof(T), alignment()));
+    }
+
+    void deallocate(T* p, std::size_t /*n*/) noexcept
+    {
+        aligned_deallocate(p);
+    }
+};
+
+template<class T, class U>
+bool operator==(const cache_aligned_allocator<T>& /*lhs*/,
+                const cache_aligned_allocator<U>& /*rhs*/) noexcept
+{
+    return true;
+}
+
+template<class T, class U>
+bool operator!=(const cache_aligned_allocator<T>& /*lhs*/,
+                const cache_aligned_allocator<U>& /*rhs*/) noexcept
+{
+    return false;
+}
+
+/**
+ * @brief Fixed number of elements, each placed on its own destructive
+ *        interference boundary.
+ *
+ * The stride between the elements is determined at run time which allows
+ * per-thread counters and queue slots to occupy 64 bytes on most processors
+ * and 128 bytes on those prefetching line pairs.
+ *
+ * @code
+ * cpuidpp::padded_array<std::atomic<std::uint64_t>> counters{threads};
+ * counters[thread].fetch_add(1, std::memory_order_relaxed);
+ * @endcode
+ */
+template<class T>
+class padded_array
+{
+public:
+    //! Value-initializes @p count elements.
+    explicit padded_array(std::size_t count)
+        : stride_{cache_aligned_allocator<T>::alignment()}
+        , size_{0}
+        , data_{nullptr}
+    {
+        const std::size_t alignment = stride_;
+
+        stride_ = (sizeof(T) + alignment - 1) / alignment * alignment;
+
+        if (count > static_cast<std::size_t>(-1) / stride_) {
+            throw std::bad_alloc{};
+        }
+
+        data_ = static_cast<char*>(aligned_allocate(count * stride_,
+                                                    alignment));
+
+        try {
+            for (; size_ != count; ++size_) {
+                ::new (data_ + size_ * stride_) T();
+            }
+        }
+        catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    padded_array(padded_array&& other) noexcept
+        : stride_{other.stride_}
+        , size_{other.size_}
+        , data_{other.data_}
+    {
+        other.size_ = 0;
+        other.data_ = nullptr;
+    }
+
+    padded_array(const padded_array&) = delete;
+    padded_array& operator=(const padded_array&) = delete;
+
+    padded_array& operator=(padded_array&& other) noexcept
+    {
+        if (this != &other) {
+            clear();
+
+            stride_ = other.stride_;
+            size_ = other.size_;
+            data_ = other.data_;
+
+            other.size_ = 0;
+            other.data_ = nullptr;
+        }
+
+        return *this;
+    }
+
+    ~padded_array()
+    {
+        clear();
+    }
+
+    T& operator[](std::size_t index) noexcept
+    {
+        return *reinterpret_cast<T*>(data_ + index * stride_);
+    }
+
+    const T& operator[](std::size_t index) const noexcept
+    {
+        return *reinterpret_cast<const T*>(data_ + index * stride_);
+    }
+
+    //! Returns the number of elements.
+    std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    //! Returns the distance between two consecutive elements in bytes.
+    std::size_t stride() const noexcept
+    {
+        return stride_;
+    }
+
+private:
+    void clear() noexcept
+    {
+        while (size_ != 0) {
+            --size_;
+            (*this)[size_].~T();
+        }
+
+        aligned_deallocate(data_);
+        data_ = nullptr;
+    }
+
+    std::size_t stride_;
+    std::size_t size_;
+    char* data_;
+};
+
+} // namespace cpuidpp
+
+#endif // !defined(CPUIDPP_CACHELINE_HPP)
@@ -14,7 +14,10 @@
 #error cpuidpp requires a C++11 compiler
 #endif // defined(_MSVC_LANG) && _MSVC_LANG <= 201103L
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include <cpuidpp/export.hpp>
 
@@ -26,16 +29,38 @@ CPUIDPP_EXPORT bool acpi();
 CPUIDPP_EXPORT bool adx();
 //! Indicates whether the AES instruction set is supported.
 CPUIDPP_EXPORT bool aes();
+//! Indicates whether AMX bfloat16 tile multiplication is supported.
+CPUIDPP_EXPORT bool amx_bf16();
+//! Indicates whether AMX half-precision tile multiplication is supported.
+CPUIDPP_EXPORT bool amx_fp16();
+//! Indicates whether AMX 8-bit integer tile multiplication is supported.
+CPUIDPP_EXPORT bool amx_int8();
+//! Indicates whether Advanced Matrix Extensions tile architecture is supported.
+CPUIDPP_EXPORT bool amx_tile();
 //! Indicates whether Onboard Advanced Programmable Interrupt Controller is supported.
 CPUIDPP_EXPORT bool apic();
 //! Indicates whether Advanced Vector Extensions are supported.
 CPUIDPP_EXPORT bool avx();
+//! Indicates whether Advanced Vector Extensions 10 are supported.
+CPUIDPP_EXPORT bool avx10();
+//! Indicates whether AVX10 supports 128-bit vectors.
+CPUIDPP_EXPORT bool avx10_128();
+//! Indicates whether AVX10 supports 256-bit vectors.
+CPUIDPP_EXPORT bool avx10_256();
+//! Indicates whether AVX10 supports 512-bit vectors.
+CPUIDPP_EXPORT bool avx10_512();
+//! Returns the AVX10 version or zero if AVX10 is not supported.
+CPUIDPP_EXPORT unsigned avx10_version();
 //! Indicates whether Advanced Vector Extensions 2 are supported.
 CPUIDPP_EXPORT bool avx2();
 //! Indicates whether AVX-512 Multiply Accumulation Single precision is supported.
 CPUIDPP_EXPORT bool avx512_4fmaps();
 //! Indicates whether AVX-512 Neural Network instructions are supported.
 CPUIDPP_EXPORT bool avx512_4vnniw();
+//! Indicates whether AVX-512 BFloat16 Instructions are supported.
+CPUIDPP_EXPORT bool avx512bf16();
+//! Indicates whether AVX-512 Bit Algorithms are supported.
+CPUIDPP_EXPORT bool avx512bitalg();
 //! Indicates whether AVX-512 Byte and Word instructions are supported.
 CPUIDPP_EXPORT bool avx512bw();
 //! Indicates whether AVX-512 Conflict Detection Instructions are supported.
@@ -46,16 +71,28 @@ CPUIDPP_EXPORT bool avx512dq();
 CPUIDPP_EXPORT bool avx512er();
 //! Indicates whether AVX-512 Foundation is supported.
 CPUIDPP_EXPORT bool avx512f();
+//! Indicates whether AVX-512 Half-Precision Floating-Point Instructions are supported.
+CPUIDPP_EXPORT bool avx512fp16();
 //! Indicates whether AVX-512 Integer Fused Multiply-Add Instructions are supported.
 CPUIDPP_EXPORT bool avx512ifma();
 //! Indicates whether AVX-512 Prefetch Instructions are supported.
 CPUIDPP_EXPORT bool avx512pf();
 //! Indicates whether AVX-512 Vector Bit Manipulation Instructions are supported.
 CPUIDPP_EXPORT bool avx512vbmi();
+//! Indicates whether AVX-512 Vector Bit Manipulation Instructions 2 are supported.
+CPUIDPP_EXPORT bool avx512vbmi2();
 //! Indicates whether AVX-512 Vector Length Extensions are supported.
 CPUIDPP_EXPORT bool avx512vl();
+//! Indicates whether AVX-512 Vector Neural Network Instructions are supported.
+CPUIDPP_EXPORT bool avx512vnni();
 //! Indicates whether AVX-512 Vector Population Count D/Q are supported.
 CPUIDPP_EXPORT bool avx512vpopcntdq();
+//! Indicates whether AVX Integer Fused Multiply-Add Instructions are supported.
+CPUIDPP_EXPORT bool avx_ifma();
+//! Indicates whether AVX No-Exception Floating-Point Conversion Instructions are supported.
+CPUIDPP_EXPORT bool avx_ne_convert();
+//! Indicates whether AVX Vector Neural Network Instructions are supported.
+CPUIDPP_EXPORT bool avx_vnni();
 //! Indicates whether the Bit Manipulation Instruction Set 1 is supported.
 CPUIDPP_EXPORT bool bmi1();
 //! Indicates whether the Bit Manipulation Instruction Set 2 is supported.
@@ -100,20 +137,34 @@ CPUIDPP_EXPORT bool fma();
 CPUIDPP_EXPORT bool fpu();
 //! Indicates whether access to base of @c %fs and @c %gs is supported.
 CPUIDPP_EXPORT bool fsgsbase();
+//! Indicates whether Fast Short REP CMPSB and REP SCASB are supported.
+CPUIDPP_EXPORT bool fsrc();
+//! Indicates whether Fast Short REP MOVSB is supported.
+CPUIDPP_EXPORT bool fsrm();
+//! Indicates whether Fast Short REP STOSB is supported.
+CPUIDPP_EXPORT bool fsrs();
 //! Indicates whether @c FXSAVE, @c FXRESTOR instructions, CR4 bit 9 are supported.
 CPUIDPP_EXPORT bool fxsr();
 //! Indicates whether FXSAVE/FXRSTOR optimizations are supported.
 CPUIDPP_EXPORT bool fxsr_opt();
+//! Indicates whether Fast Zero-Length REP MOVSB is supported.
+CPUIDPP_EXPORT bool fzrm();
+//! Indicates whether Galois Field New Instructions are supported.
+CPUIDPP_EXPORT bool gfni();
 //! Indicates whether Transactional Synchronization Extensions are supported.
 CPUIDPP_EXPORT bool hle();
 //! Indicates whether Hyper-threading is supported.
 CPUIDPP_EXPORT bool htt();
+//! Indicates whether the processor combines different core types (hybrid architecture).
+CPUIDPP_EXPORT bool hybrid();
 //! Indicates whether we are running on a hypervisor (always 0 on a real CPU, but also with some hypervisors).
 CPUIDPP_EXPORT bool hypervisor();
 //! Indicates whether this is a IA64 processor emulating x86.
 CPUIDPP_EXPORT bool ia64();
 //! Indicates whether Intel Processor Trace is supported.
 CPUIDPP_EXPORT bool intel_pt();
+//! Indicates whether the Time Stamp Counter runs at a constant rate in all P-, C- and T-states.
+CPUIDPP_EXPORT bool invariant_tsc();
 //! Indicates whether the @c INVPCID instruction is supported.
 CPUIDPP_EXPORT bool invpcid();
 //! Indicates whether Long mode is active.
@@ -236,6 +287,10 @@ CPUIDPP_EXPORT bool tsc();
 CPUIDPP_EXPORT bool tsc_deadline();
 //! Indicates whether User-mode Instruction Prevention is supported.
 CPUIDPP_EXPORT bool umip();
+//! Indicates whether Vector AES instructions are supported.
+CPUIDPP_EXPORT bool vaes();
+//! Indicates whether Carry-Less Multiplication of vectors is supported.
+CPUIDPP_EXPORT bool vpclmulqdq();
 //! Indicates whether virtual 8086 mode extensions (such as VIF, VIP, PIV) are supported.
 CPUIDPP_EXPORT bool vme();
 //! Indicates whether Virtual Machine eXtensions are supported.
@@ -279,10 +334,61 @@ CPUIDPP_EXPORT const std::string& model();
     */
 CPUIDPP_EXPORT const std::string& vendor();
 
+//! Type of a cache.
+enum class cache_type
+{
+    data = 1,           //!< Data cache.
+    instruction = 2,    //!< Instruction cache.
+    unified = 3         //!< Unified cache.
+};
+
+//! Describes a single cache of the processor.
+struct cache
+{
+    //! Type of the cache.
+    cache_type type;
+    //! Cache level starting at 1.
+    unsigned level;
+    //! Total size in bytes.
+    std::size_t size;
+    //! Coherency line size in bytes.
+    unsigned line_size;
+    //! Number of ways of associativity.
+    unsigned ways;
+    //! Number of physical line partitions.
+    unsigned partitions;
+    //! Number of sets.
+    unsigned sets;
+    //! Indicates whether the cache is fully associative.
+    bool fully_associative;
+    //! Indicates whether the cache is inclusive of the lower cache levels.
+    bool inclusive;
+    //! Maximum number of logical processors sharing the cache.
+    unsigned shared_by;
+};
+
+/**
+ * @brief Returns the caches of the processor.
+ *
+ * The caches are decoded from the deterministic cache parameters reported in
+ * leaf 4 on Intel processors and in leaf 0x8000001D on AMD processors
+ * supporting topology extensions. Older AMD processors fall back to the
+ * legacy L1, L2 and L3 descriptors in which case @ref cache::inclusive is not
+ * available.
+ *
+ * The caches are ordered as reported by the processor, i.e., typically by
+ * increasing level.
+ */
+CPUIDPP_EXPORT const std::vector<cache>& cache_info();
+
 /**
  * @{
  * @name AMD feature flags
- * @brief CPU features specific to AMD processors.
+ * @brief CPU features reported in the extended leaf 0x80000001.
+ *
+ * The leaf originates from AMD. Intel processors report the subset they
+ * implement, e.g., @ref lahf_lm(), @ref abm() (@c LZCNT), @ref nx(), @ref
+ * rdtscp() and @ref lm(), at the same positions.
  */
 
 //! Indicates whether Advanced bit manipulation (@c LZCNT and @c POPCNT) is supported.
@@ -332,6 +438,507 @@ CPUIDPP_EXPORT bool topoext();
 
 //! @}
 
+/**
+ * @{
+ * @name Usable vector extensions
+ * @brief Vector extensions that are both supported by the CPU and whose
+ *        register state is saved by the OS.
+ *
+ * The plain feature flags only reflect the @c CPUID bits. Executing the
+ * corresponding instructions additionally requires the OS to enable the
+ * register state in @c XCR0 which may not be the case, e.g., in restricted
+ * virtual machines.
+ */
+
+//! Indicates whether the OS saves the @c XMM and @c YMM register state.
+CPUIDPP_EXPORT bool os_avx();
+//! Indicates whether the OS saves the @c XMM, @c YMM, @c ZMM and opmask register state.
+CPUIDPP_EXPORT bool os_avx512();
+//! Indicates whether the OS enables the AMX tile configuration and tile data state (see also @ref amx_usable()).
+CPUIDPP_EXPORT bool os_amx();
+//! Indicates whether Advanced Vector Extensions can be used, i.e., the @c YMM state is enabled by the OS.
+CPUIDPP_EXPORT bool avx_usable();
+//! Indicates whether Advanced Vector Extensions 10 can be used, i.e., the @c ZMM and opmask state is enabled by the OS.
+CPUIDPP_EXPORT bool avx10_usable();
+//! Indicates whether Advanced Vector Extensions 2 can be used, i.e., the @c YMM state is enabled by the OS.
+CPUIDPP_EXPORT bool avx2_usable();
+//! Indicates whether AVX-512 Multiply Accumulation Single precision can be used, i.e., the @c ZMM and opmask state is enabled by the OS.
+CPUIDPP_EXPORT bool avx512_4fmaps_usable();
+//! Indicates whether AVX-512 Neural Network instructions can be used, i.e., the @c ZMM and opmask state is enabled by the OS.
+CPUIDPP_EXPORT bool avx512_4vnniw_usable();
+//! Indicates whether AVX-512 BFloat16 Instructions can be used, i.e., the @c ZMM and opmask state is enabled by the OS.
+CPUIDPP_EXPORT bool avx512bf16_usable();
+//! Indicates whether AVX-512 Bit Algorithms can be used, i.e., the @c ZMM and opmask state is enabled by the OS.
+CPUIDPP_EXPORT bool avx512bitalg_usable();
+//! Indicates whether AVX-512 Byte and Word instructions can be used, i.e., the @c ZMM and opmask state is enabled by the OS.
+CPUIDPP_EXPORT bool avx512bw_usable();
+//! Indicates whether AVX-512 Conflict Detection Instructions can be used, i.e., the @c ZMM and opmask state is enabled by the OS.
+CPUIDPP_EXPORT bool avx512cd_usable();
+//! Indicates whether AVX-512 Doubleword and Quadword Instructions can be used, i.e., the @c ZMM and opmask state is enabled by the OS.
+CPUIDPP_EXPORT bool avx512dq_usable();
+//! Indicates whether AVX-512 Exponential and Reciprocal Instructions can be used, i.e., the @c ZMM and opmask state is enabled by the OS.
+CPUIDPP_EXPORT bool avx512er_usable();
+//! Indicates whether AVX-512 Foundation can be used, i.e., the @c ZMM and opmask state is enabled by the OS.
+CPUIDPP_EXPORT bool avx512f_usable();
+//! Indicates whether AVX-512 Half-Precision Floating-Point Instructions can be used, i.e., the @c ZMM and opmask state is enabled by the OS.
+CPUIDPP_EXPORT bool avx512fp16_usable();
+//! Indicates whether AVX-512 Integer Fused Multiply-Add Instructions can be used, i.e., the @c ZMM and opmask state is enabled by the OS.
+CPUIDPP_EXPORT bool avx512ifma_usable();
+//! Indicates whether AVX-512 Prefetch Instructions can be used, i.e., the @c ZMM and opmask state is enabled by the OS.
+CPUIDPP_EXPORT bool avx512pf_usable();
+//! Indicates whether AVX-512 Vector Bit Manipulation Instructions can be used, i.e., the @c ZMM and opmask state is enabled by the OS.
+CPUIDPP_EXPORT bool avx512vbmi_usable();
+//! Indicates whether AVX-512 Vector Bit Manipulation Instructions 2 can be used, i.e., the @c ZMM and opmask state is enabled by the OS.
+CPUIDPP_EXPORT bool avx512vbmi2_usable();
+//! Indicates whether AVX-512 Vector Length Extensions can be used, i.e., the @c ZMM and opmask state is enabled by the OS.
+CPUIDPP_EXPORT bool avx512vl_usable();
+//! Indicates whether AVX-512 Vector Neural Network Instructions can be used, i.e., the @c ZMM and opmask state is enabled by the OS.
+CPUIDPP_EXPORT bool avx512vnni_usable();
+//! Indicates whether AVX-512 Vector Population Count D/Q can be used, i.e., the @c ZMM and opmask state is enabled by the OS.
+CPUIDPP_EXPORT bool avx512vpopcntdq_usable();
+//! Indicates whether AVX Integer Fused Multiply-Add Instructions can be used, i.e., the @c YMM state is enabled by the OS.
+CPUIDPP_EXPORT bool avx_ifma_usable();
+//! Indicates whether AVX No-Exception Floating-Point Conversion Instructions can be used, i.e., the @c YMM state is enabled by the OS.
+CPUIDPP_EXPORT bool avx_ne_convert_usable();
+//! Indicates whether AVX Vector Neural Network Instructions can be used, i.e., the @c YMM state is enabled by the OS.
+CPUIDPP_EXPORT bool avx_vnni_usable();
+//! Indicates whether F16C (half-precision) FP can be used, i.e., the @c YMM state is enabled by the OS.
+CPUIDPP_EXPORT bool f16c_usable();
+//! Indicates whether Fused multiply-add (FMA3) can be used, i.e., the @c YMM state is enabled by the OS.
+CPUIDPP_EXPORT bool fma_usable();
+//! Indicates whether Vector AES instructions can be used, i.e., the @c YMM state is enabled by the OS.
+CPUIDPP_EXPORT bool vaes_usable();
+//! Indicates whether Carry-Less Multiplication of vectors can be used, i.e., the @c YMM state is enabled by the OS.
+CPUIDPP_EXPORT bool vpclmulqdq_usable();
+
+//! @}
+
+/**
+ * @brief Raw CPUID register words captured once at startup.
+ *
+ * The structure is trivially copyable and holds the leaf words the feature
+ * flags are decoded from. Its accessors are inline so that checking a feature
+ * against @ref features() amounts to a single load and a bit test.
+ */
+struct snapshot
+{
+    //! Indices of the captured register words.
+    enum word
+    {
+        leaf1_ecx,          //!< @c EAX=1: @c ECX
+        leaf1_edx,          //!< @c EAX=1: @c EDX
+        leaf7_ebx,          //!< @c EAX=7, @c ECX=0: @c EBX
+        leaf7_ecx,          //!< @c EAX=7, @c ECX=0: @c ECX
+        leaf7_edx,          //!< @c EAX=7, @c ECX=0: @c EDX
+        leaf7_1_eax,        //!< @c EAX=7, @c ECX=1: @c EAX
+        leaf7_1_edx,        //!< @c EAX=7, @c ECX=1: @c EDX
+        leaf24_ebx,         //!< @c EAX=0x24, @c ECX=0: @c EBX (zero unless AVX10 is supported)
+        leaf80000001_ecx,   //!< @c EAX=0x80000001: @c ECX
+        leaf80000001_edx,   //!< @c EAX=0x80000001: @c EDX
+        leaf80000007_edx,   //!< @c EAX=0x80000007: @c EDX
+        xcr0,               //!< @c XGETBV with @c ECX=0: @c EAX (zero unless @c OSXSAVE is set)
+        word_count          //!< Number of captured words.
+    };
+
+    //! Captured register words indexed by @ref word.
+    std::uint32_t words[word_count];
+    //! Highest basic leaf (@c EAX=0: @c EAX).
+    std::uint32_t max_leaf;
+    //! Highest extended leaf (@c EAX=0x80000000: @c EAX).
+    std::uint32_t max_extended_leaf;
+    //! Null-terminated vendor ID (@c EAX=0: @c EBX, @c EDX, @c ECX).
+    char vendor_id[13];
+    /**
+     * @brief Null-terminated processor brand string (@c EAX=0x80000002
+     *        through @c EAX=0x80000004) without surrounding whitespace.
+     */
+    char brand[49];
+
+    //! Returns the value of @p bit in the register word @p index.
+    bool test(word index, unsigned bit) const noexcept
+    {
+        return ((words[index] >> bit) & 1U) != 0;
+    }
+
+/**
+ * @{
+ * @name Feature accessors
+ * @brief Inline counterparts of the free feature functions.
+ */
+
+#define CPUIDPP_SNAPSHOT_FLAG(name, index, bit) \
+    bool name() const noexcept                  \
+    {                                           \
+        return test(index, bit);                \
+    }
+
+    CPUIDPP_SNAPSHOT_FLAG(fpu,              leaf1_edx,        0)
+    CPUIDPP_SNAPSHOT_FLAG(vme,              leaf1_edx,        1)
+    CPUIDPP_SNAPSHOT_FLAG(de,               leaf1_edx,        2)
+    CPUIDPP_SNAPSHOT_FLAG(pse,              leaf1_edx,        3)
+    CPUIDPP_SNAPSHOT_FLAG(tsc,              leaf1_edx,        4)
+    CPUIDPP_SNAPSHOT_FLAG(msr,              leaf1_edx,        5)
+    CPUIDPP_SNAPSHOT_FLAG(pae,              leaf1_edx,        6)
+    CPUIDPP_SNAPSHOT_FLAG(mce,              leaf1_edx,        7)
+    CPUIDPP_SNAPSHOT_FLAG(cx8,              leaf1_edx,        8)
+    CPUIDPP_SNAPSHOT_FLAG(apic,             leaf1_edx,        9)
+    CPUIDPP_SNAPSHOT_FLAG(sep,              leaf1_edx,        11)
+    CPUIDPP_SNAPSHOT_FLAG(mtrr,             leaf1_edx,        12)
+    CPUIDPP_SNAPSHOT_FLAG(pge,              leaf1_edx,        13)
+    CPUIDPP_SNAPSHOT_FLAG(mca,              leaf1_edx,        14)
+    CPUIDPP_SNAPSHOT_FLAG(cmov,             leaf1_edx,        15)
+    CPUIDPP_SNAPSHOT_FLAG(pat,              leaf1_edx,        16)
+    CPUIDPP_SNAPSHOT_FLAG(pse36,            leaf1_edx,        17)
+    CPUIDPP_SNAPSHOT_FLAG(psn,              leaf1_edx,        18)
+    CPUIDPP_SNAPSHOT_FLAG(clfsh,            leaf1_edx,        19)
+    CPUIDPP_SNAPSHOT_FLAG(ds,               leaf1_edx,        21)
+    CPUIDPP_SNAPSHOT_FLAG(acpi,             leaf1_edx,        22)
+    CPUIDPP_SNAPSHOT_FLAG(mmx,              leaf1_edx,        23)
+    CPUIDPP_SNAPSHOT_FLAG(fxsr,             leaf1_edx,        24)
+    CPUIDPP_SNAPSHOT_FLAG(sse,              leaf1_edx,        25)
+    CPUIDPP_SNAPSHOT_FLAG(sse2,             leaf1_edx,        26)
+    CPUIDPP_SNAPSHOT_FLAG(ss,               leaf1_edx,        27)
+    CPUIDPP_SNAPSHOT_FLAG(htt,              leaf1_edx,        28)
+    CPUIDPP_SNAPSHOT_FLAG(tm,               leaf1_edx,        29)
+    CPUIDPP_SNAPSHOT_FLAG(ia64,             leaf1_edx,        30)
+    CPUIDPP_SNAPSHOT_FLAG(pbe,              leaf1_edx,        31)
+
+    CPUIDPP_SNAPSHOT_FLAG(sse3,             leaf1_ecx,        0)
+    CPUIDPP_SNAPSHOT_FLAG(pclmulqdq,        leaf1_ecx,        1)
+    CPUIDPP_SNAPSHOT_FLAG(dtes64,           leaf1_ecx,        2)
+    CPUIDPP_SNAPSHOT_FLAG(monitor,          leaf1_ecx,        3)
+    CPUIDPP_SNAPSHOT_FLAG(ds_cpl,           leaf1_ecx,        4)
+    CPUIDPP_SNAPSHOT_FLAG(vmx,              leaf1_ecx,        5)
+    CPUIDPP_SNAPSHOT_FLAG(smx,              leaf1_ecx,        6)
+    CPUIDPP_SNAPSHOT_FLAG(eist,             leaf1_ecx,        7)
+    CPUIDPP_SNAPSHOT_FLAG(tm2,              leaf1_ecx,        8)
+    CPUIDPP_SNAPSHOT_FLAG(ssse3,            leaf1_ecx,        9)
+    CPUIDPP_SNAPSHOT_FLAG(cnxt_id,          leaf1_ecx,        10)
+    CPUIDPP_SNAPSHOT_FLAG(sdbg,             leaf1_ecx,        11)
+    CPUIDPP_SNAPSHOT_FLAG(fma,              leaf1_ecx,        12)
+    CPUIDPP_SNAPSHOT_FLAG(cx16,             leaf1_ecx,        13)
+    CPUIDPP_SNAPSHOT_FLAG(xtpr,             leaf1_ecx,        14)
+    CPUIDPP_SNAPSHOT_FLAG(pdcm,             leaf1_ecx,        15)
+
+    CPUIDPP_SNAPSHOT_FLAG(pcid,             leaf1_ecx,        17)
+    CPUIDPP_SNAPSHOT_FLAG(dca,              leaf1_ecx,        18)
+    CPUIDPP_SNAPSHOT_FLAG(sse4_1,           leaf1_ecx,        19)
+    CPUIDPP_SNAPSHOT_FLAG(sse4_2,           leaf1_ecx,        20)
+    CPUIDPP_SNAPSHOT_FLAG(x2apic,           leaf1_ecx,        21)
+    CPUIDPP_SNAPSHOT_FLAG(movbe,            leaf1_ecx,        22)
+    CPUIDPP_SNAPSHOT_FLAG(popcnt,           leaf1_ecx,        23)
+    CPUIDPP_SNAPSHOT_FLAG(tsc_deadline,     leaf1_ecx,        24)
+    CPUIDPP_SNAPSHOT_FLAG(aes,              leaf1_ecx,        25)
+    CPUIDPP_SNAPSHOT_FLAG(xsave,            leaf1_ecx,        26)
+    CPUIDPP_SNAPSHOT_FLAG(oxsave,           leaf1_ecx,        27)
+    CPUIDPP_SNAPSHOT_FLAG(avx,              leaf1_ecx,        28)
+    CPUIDPP_SNAPSHOT_FLAG(f16c,             leaf1_ecx,        29)
+    CPUIDPP_SNAPSHOT_FLAG(rdrnd,            leaf1_ecx,        30)
+    CPUIDPP_SNAPSHOT_FLAG(hypervisor,       leaf1_ecx,        31)
+
+    CPUIDPP_SNAPSHOT_FLAG(fsgsbase,         leaf7_ebx,        0)
+
+    CPUIDPP_SNAPSHOT_FLAG(sgx,              leaf7_ebx,        2)
+    CPUIDPP_SNAPSHOT_FLAG(bmi1,             leaf7_ebx,        3)
+    CPUIDPP_SNAPSHOT_FLAG(hle,              leaf7_ebx,        4)
+    CPUIDPP_SNAPSHOT_FLAG(avx2,             leaf7_ebx,        5)
+
+    CPUIDPP_SNAPSHOT_FLAG(smep,             leaf7_ebx,        7)
+    CPUIDPP_SNAPSHOT_FLAG(bmi2,             leaf7_ebx,        8)
+    CPUIDPP_SNAPSHOT_FLAG(erms,             leaf7_ebx,        9)
+    CPUIDPP_SNAPSHOT_FLAG(invpcid,          leaf7_ebx,        10)
+    CPUIDPP_SNAPSHOT_FLAG(rtm,              leaf7_ebx,        11)
+    CPUIDPP_SNAPSHOT_FLAG(pqm,              leaf7_ebx,        12)
+
+    CPUIDPP_SNAPSHOT_FLAG(mpx,              leaf7_ebx,        14)
+    CPUIDPP_SNAPSHOT_FLAG(pqe,              leaf7_ebx,        15)
+    CPUIDPP_SNAPSHOT_FLAG(avx512f,          leaf7_ebx,        16)
+    CPUIDPP_SNAPSHOT_FLAG(avx512dq,         leaf7_ebx,        17)
+    CPUIDPP_SNAPSHOT_FLAG(rdseed,           leaf7_ebx,        18)
+    CPUIDPP_SNAPSHOT_FLAG(adx,              leaf7_ebx,        19)
+    CPUIDPP_SNAPSHOT_FLAG(smap,             leaf7_ebx,        20)
+    CPUIDPP_SNAPSHOT_FLAG(avx512ifma,       leaf7_ebx,        21)
+    CPUIDPP_SNAPSHOT_FLAG(pcommit,          leaf7_ebx,        22)
+    CPUIDPP_SNAPSHOT_FLAG(clflushopt,       leaf7_ebx,        23)
+    CPUIDPP_SNAPSHOT_FLAG(clwb,             leaf7_ebx,        24)
+    CPUIDPP_SNAPSHOT_FLAG(intel_pt,         leaf7_ebx,        25)
+    CPUIDPP_SNAPSHOT_FLAG(avx512pf,         leaf7_ebx,        26)
+    CPUIDPP_SNAPSHOT_FLAG(avx512er,         leaf7_ebx,        27)
+    CPUIDPP_SNAPSHOT_FLAG(avx512cd,         leaf7_ebx,        28)
+    CPUIDPP_SNAPSHOT_FLAG(sha,              leaf7_ebx,        29)
+    CPUIDPP_SNAPSHOT_FLAG(avx512bw,         leaf7_ebx,        30)
+    CPUIDPP_SNAPSHOT_FLAG(avx512vl,         leaf7_ebx,        31)
+
+
+    CPUIDPP_SNAPSHOT_FLAG(prefetchwt1,      leaf7_ecx,        0)
+    CPUIDPP_SNAPSHOT_FLAG(avx512vbmi,       leaf7_ecx,        1)
+    CPUIDPP_SNAPSHOT_FLAG(umip,             leaf7_ecx,        2)
+    CPUIDPP_SNAPSHOT_FLAG(pku,              leaf7_ecx,        3)
+    CPUIDPP_SNAPSHOT_FLAG(ospke,            leaf7_ecx,        4)
+
+    CPUIDPP_SNAPSHOT_FLAG(avx512vbmi2,      leaf7_ecx,        6)
+
+    CPUIDPP_SNAPSHOT_FLAG(gfni,             leaf7_ecx,        8)
+    CPUIDPP_SNAPSHOT_FLAG(vaes,             leaf7_ecx,        9)
+    CPUIDPP_SNAPSHOT_FLAG(vpclmulqdq,       leaf7_ecx,        10)
+    CPUIDPP_SNAPSHOT_FLAG(avx512vnni,       leaf7_ecx,        11)
+    CPUIDPP_SNAPSHOT_FLAG(avx512bitalg,     leaf7_ecx,        12)
+
+    CPUIDPP_SNAPSHOT_FLAG(avx512vpopcntdq,  leaf7_ecx,        14)
+
+    CPUIDPP_SNAPSHOT_FLAG(rdpid,            leaf7_ecx,        22)
+
+    CPUIDPP_SNAPSHOT_FLAG(sgx_lc,           leaf7_ecx,        30)
+
+    CPUIDPP_SNAPSHOT_FLAG(avx512_4vnniw,    leaf7_edx,        2)
+    CPUIDPP_SNAPSHOT_FLAG(avx512_4fmaps,    leaf7_edx,        3)
+    CPUIDPP_SNAPSHOT_FLAG(fsrm,             leaf7_edx,        4)
+
+    CPUIDPP_SNAPSHOT_FLAG(hybrid,           leaf7_edx,        15)
+
+    CPUIDPP_SNAPSHOT_FLAG(amx_bf16,         leaf7_edx,        22)
+
+    CPUIDPP_SNAPSHOT_FLAG(avx512fp16,       leaf7_edx,        23)
+    CPUIDPP_SNAPSHOT_FLAG(amx_tile,         leaf7_edx,        24)
+    CPUIDPP_SNAPSHOT_FLAG(amx_int8,         leaf7_edx,        25)
+
+    CPUIDPP_SNAPSHOT_FLAG(avx_vnni,         leaf7_1_eax,      4)
+    CPUIDPP_SNAPSHOT_FLAG(avx512bf16,       leaf7_1_eax,      5)
+
+    CPUIDPP_SNAPSHOT_FLAG(fzrm,             leaf7_1_eax,      10)
+    CPUIDPP_SNAPSHOT_FLAG(fsrs,             leaf7_1_eax,      11)
+    CPUIDPP_SNAPSHOT_FLAG(fsrc,             leaf7_1_eax,      12)
+
+    CPUIDPP_SNAPSHOT_FLAG(amx_fp16,         leaf7_1_eax,      21)
+
+    CPUIDPP_SNAPSHOT_FLAG(avx_ifma,         leaf7_1_eax,      23)
+
+    CPUIDPP_SNAPSHOT_FLAG(avx_ne_convert,   leaf7_1_edx,      5)
+
+    CPUIDPP_SNAPSHOT_FLAG(avx10,            leaf7_1_edx,      19)
+
+    CPUIDPP_SNAPSHOT_FLAG(avx10_128,        leaf24_ebx,       16)
+    CPUIDPP_SNAPSHOT_FLAG(avx10_256,        leaf24_ebx,       17)
+    CPUIDPP_SNAPSHOT_FLAG(avx10_512,        leaf24_ebx,       18)
+
+    // AMD specific
+
+    CPUIDPP_SNAPSHOT_FLAG(syscall,          leaf80000001_edx, 11)
+
+    CPUIDPP_SNAPSHOT_FLAG(mp,               leaf80000001_edx, 19)
+    CPUIDPP_SNAPSHOT_FLAG(nx,               leaf80000001_edx, 20)
+
+    CPUIDPP_SNAPSHOT_FLAG(mmxext,           leaf80000001_edx, 22)
+
+    CPUIDPP_SNAPSHOT_FLAG(fxsr_opt,         leaf80000001_edx, 25)
+    CPUIDPP_SNAPSHOT_FLAG(pdpe1gb,          leaf80000001_edx, 26)
+    CPUIDPP_SNAPSHOT_FLAG(rdtscp,           leaf80000001_edx, 27)
+
+    CPUIDPP_SNAPSHOT_FLAG(lm,               leaf80000001_edx, 29)
+    CPUIDPP_SNAPSHOT_FLAG(amd_3dnowext,     leaf80000001_edx, 30)
+    CPUIDPP_SNAPSHOT_FLAG(amd_3dnow,        leaf80000001_edx, 31)
+
+    CPUIDPP_SNAPSHOT_FLAG(lahf_lm,          leaf80000001_ecx, 0)
+    CPUIDPP_SNAPSHOT_FLAG(cmp_legacy,       leaf80000001_ecx, 1)
+    CPUIDPP_SNAPSHOT_FLAG(svm,              leaf80000001_ecx, 2)
+    CPUIDPP_SNAPSHOT_FLAG(extapic,          leaf80000001_ecx, 3)
+    CPUIDPP_SNAPSHOT_FLAG(cr8_legacy,       leaf80000001_ecx, 4)
+    CPUIDPP_SNAPSHOT_FLAG(abm,              leaf80000001_ecx, 5)
+    CPUIDPP_SNAPSHOT_FLAG(sse4a,            leaf80000001_ecx, 6)
+    CPUIDPP_SNAPSHOT_FLAG(misalignsse,      leaf80000001_ecx, 7)
+    CPUIDPP_SNAPSHOT_FLAG(amd_3dnowprefetch,leaf80000001_ecx, 8)
+    CPUIDPP_SNAPSHOT_FLAG(osvw,             leaf80000001_ecx, 9)
+    CPUIDPP_SNAPSHOT_FLAG(ibs,              leaf80000001_ecx, 10)
+    CPUIDPP_SNAPSHOT_FLAG(xop,              leaf80000001_ecx, 11)
+    CPUIDPP_SNAPSHOT_FLAG(skinit,           leaf80000001_ecx, 12)
+    CPUIDPP_SNAPSHOT_FLAG(wdt,              leaf80000001_ecx, 13)
+
+    CPUIDPP_SNAPSHOT_FLAG(lwp,              leaf80000001_ecx, 15)
+    CPUIDPP_SNAPSHOT_FLAG(fma4,             leaf80000001_ecx, 16)
+    CPUIDPP_SNAPSHOT_FLAG(tce,              leaf80000001_ecx, 17)
+
+    CPUIDPP_SNAPSHOT_FLAG(nodeid_msr,       leaf80000001_ecx, 19)
+
+    CPUIDPP_SNAPSHOT_FLAG(tbm,              leaf80000001_ecx, 21)
+    CPUIDPP_SNAPSHOT_FLAG(topoext,          leaf80000001_ecx, 22)
+    CPUIDPP_SNAPSHOT_FLAG(perfctr_core,     leaf80000001_ecx, 23)
+    CPUIDPP_SNAPSHOT_FLAG(perfctr_nb,       leaf80000001_ecx, 24)
+
+    CPUIDPP_SNAPSHOT_FLAG(dbx,              leaf80000001_ecx, 26)
+    CPUIDPP_SNAPSHOT_FLAG(perftsc,          leaf80000001_ecx, 27)
+    CPUIDPP_SNAPSHOT_FLAG(pcx_l2i,          leaf80000001_ecx, 28)
+
+    // Advanced power management
+
+    CPUIDPP_SNAPSHOT_FLAG(invariant_tsc,    leaf80000007_edx, 8)
+
+#undef CPUIDPP_SNAPSHOT_FLAG
+
+//! @}
+
+    //! Returns the AVX10 version or zero if AVX10 is not supported.
+    unsigned avx10_version() const noexcept
+    {
+        return avx10() ? words[leaf24_ebx] & 0xffU : 0U;
+    }
+
+    //! Indicates whether the OS saves the @c XMM and @c YMM register state.
+    bool os_avx() const noexcept
+    {
+        return (words[xcr0] & 0x6U) == 0x6U;
+    }
+
+    /**
+     * @brief Indicates whether the OS saves the @c XMM, @c YMM, @c ZMM and
+     *        opmask register state.
+     */
+    bool os_avx512() const noexcept
+    {
+        return (words[xcr0] & 0xe6U) == 0xe6U;
+    }
+
+    /**
+     * @brief Indicates whether the OS enables the AMX tile configuration
+     *        (@c XTILECFG) and tile data (@c XTILEDATA) state.
+     *
+     * On Linux, the process must additionally request the permission to use
+     * the tile data state (see @ref amx_usable()).
+     */
+    bool os_amx() const noexcept
+    {
+        return (words[xcr0] & 0x60000U) == 0x60000U;
+    }
+
+/**
+ * @{
+ * @name Usable vector extensions
+ * @brief Feature accessors combined with the register state enabled by the OS.
+ */
+
+#define CPUIDPP_SNAPSHOT_USABLE(name, state)    \
+    bool name##_usable() const noexcept         \
+    {                                           \
+        return name() && state();               \
+    }
+
+    CPUIDPP_SNAPSHOT_USABLE(avx, os_avx)
+    CPUIDPP_SNAPSHOT_USABLE(avx10, os_avx512)
+    CPUIDPP_SNAPSHOT_USABLE(avx2, os_avx)
+    CPUIDPP_SNAPSHOT_USABLE(avx512_4fmaps, os_avx512)
+    CPUIDPP_SNAPSHOT_USABLE(avx512_4vnniw, os_avx512)
+    CPUIDPP_SNAPSHOT_USABLE(avx512bf16, os_avx512)
+    CPUIDPP_SNAPSHOT_USABLE(avx512bitalg, os_avx512)
+    CPUIDPP_SNAPSHOT_USABLE(avx512bw, os_avx512)
+    CPUIDPP_SNAPSHOT_USABLE(avx512cd, os_avx512)
+    CPUIDPP_SNAPSHOT_USABLE(avx512dq, os_avx512)
+    CPUIDPP_SNAPSHOT_USABLE(avx512er, os_avx512)
+    CPUIDPP_SNAPSHOT_USABLE(avx512f, os_avx512)
+    CPUIDPP_SNAPSHOT_USABLE(avx512fp16, os_avx512)
+    CPUIDPP_SNAPSHOT_USABLE(avx512ifma, os_avx512)
+    CPUIDPP_SNAPSHOT_USABLE(avx512pf, os_avx512)
+    CPUIDPP_SNAPSHOT_USABLE(avx512vbmi, os_avx512)
+    CPUIDPP_SNAPSHOT_USABLE(avx512vbmi2, os_avx512)
+    CPUIDPP_SNAPSHOT_USABLE(avx512vl, os_avx512)
+    CPUIDPP_SNAPSHOT_USABLE(avx512vnni, os_avx512)
+    CPUIDPP_SNAPSHOT_USABLE(avx512vpopcntdq, os_avx512)
+    CPUIDPP_SNAPSHOT_USABLE(avx_ifma, os_avx)
+    CPUIDPP_SNAPSHOT_USABLE(avx_ne_convert, os_avx)
+    CPUIDPP_SNAPSHOT_USABLE(avx_vnni, os_avx)
+    CPUIDPP_SNAPSHOT_USABLE(f16c, os_avx)
+    CPUIDPP_SNAPSHOT_USABLE(fma, os_avx)
+    CPUIDPP_SNAPSHOT_USABLE(vaes, os_avx)
+    CPUIDPP_SNAPSHOT_USABLE(vpclmulqdq, os_avx)
+
+#undef CPUIDPP_SNAPSHOT_USABLE
+
+//! @}
+};
+
+/**
+ * @brief Fills @p s by executing the @c CPUID instruction on the calling
+ *        thread.
+ *
+ * The function always executes the instruction and ignores the dumps named by
+ * the @c CPUIDPP_DUMP and @c CPUIDPP_REPLAY environment variables which only
+ * @ref features() honors. It does not allocate, does not depend on the locale
+ * and does not use static initialization guards. It is therefore
+ * async-signal-safe and can be called before the C++ runtime is initialized,
+ * e.g., from a GNU @c ifunc resolver. A hook installed by @c
+ * cpuidpp::set_cpuid_hook runs after each execution and must give the same
+ * guarantees for them to hold:
+ *
+ * @code
+ * extern "C" void* resolve_sum()
+ * {
+ *     cpuidpp::snapshot s;
+ *     cpuidpp::detect(s);
+ *
+ *     return s.avx2() ? reinterpret_cast<void*>(sum_avx2)
+ *                     : reinterpret_cast<void*>(sum_generic);
+ * }
+ *
+ * float sum(const float*, std::size_t) __attribute__((ifunc("resolve_sum")));
+ * @endcode
+ */
+CPUIDPP_EXPORT void detect(snapshot& s) noexcept;
+
+namespace detail {
+
+//! Storage behind @ref cpuidpp::features().
+CPUIDPP_EXPORT extern snapshot detected;
+
+/**
+ * @brief Fills @ref detected before its first use.
+ *
+ * Every translation unit including this header owns an instance of this
+ * class. The first constructor to run captures the CPUID words, which makes
+ * @ref detected available during dynamic initialization of other translation
+ * units as well.
+ */
+class CPUIDPP_EXPORT snapshot_init
+{
+public:
+    snapshot_init();
+};
+
+static const snapshot_init snapshot_init_instance;
+
+} // namespace detail
+
+/**
+ * @brief Returns the feature snapshot of the current processor.
+ *
+ * The snapshot is filled during static initialization. Querying a feature,
+ * e.g. @c cpuidpp::features().avx2(), does not involve a function call or a
+ * thread-safe static initialization guard.
+ */
+inline const snapshot& features() noexcept
+{
+    return detail::detected;
+}
+
+/**
+ * @brief Returns the vendor ID as a null-terminated string.
+ *
+ * Unlike @ref vendor(), the function neither copies nor allocates and can be
+ * called concurrently from any thread.
+ */
+inline const char* vendor_name() noexcept
+{
+    return features().vendor_id;
+}
+
+/**
+ * @brief Returns the model of the CPU as a null-terminated string.
+ *
+ * Unlike @ref model(), the function neither copies nor allocates and can be
+ * called concurrently from any thread.
+ */
+inline const char* model_name() noexcept
+{
+    return features().brand;
+}
+
 } // namespace cpuidpp
 
 #endif // !defined(CPUIDPP_CPUIDPP_HPP)
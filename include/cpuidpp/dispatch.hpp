@@ -0,0 +1,160 @@
+/**
+ * @brief %cpuidpp runtime dispatch.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef CPUIDPP_DISPATCH_HPP
+#define CPUIDPP_DISPATCH_HPP
+
+#include <initializer_list>
+#include <utility>
+
+#include <cpuidpp/cpuidpp.hpp>
+
+namespace cpuidpp {
+
+//! Pointer to a feature accessor of @ref snapshot, e.g. @c &snapshot::avx2.
+using requirement = bool (snapshot::*)() const;
+
+/**
+ * @brief Implementation variant tagged with the features it requires.
+ *
+ * @tparam T Type of the implementation, e.g. a function pointer or a pointer
+ *         to a table of function pointers.
+ */
+template<class T>
+struct candidate
+{
+    //! The implementation.
+    T value;
+    //! Features that must all be present for @ref value to be usable.
+    std::initializer_list<requirement> required;
+};
+
+//! Indicates whether all @p required features are present in @p s.
+inline bool satisfies(const snapshot& s,
+                      std::initializer_list<requirement> required) noexcept
+{
+    for (requirement r : required) {
+        if (!(s.*r)()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Selects the best usable implementation.
+ *
+ * The @p candidates are ranked from the most to the least preferred. The first
+ * candidate whose requirements are satisfied by @p s is returned. The last
+ * candidate is the baseline and is returned if none of the candidates is
+ * usable. @p candidates must not be empty.
+ */
+template<class T>
+T select(std::initializer_list<candidate<T>> candidates,
+         const snapshot& s = features())
+{
+    for (const candidate<T>& c : candidates) {
+        if (satisfies(s, c.required)) {
+            return c.value;
+        }
+    }
+
+    return (candidates.end() - 1)->value;
+}
+
+template<class Signature>
+class dispatcher;
+
+/**
+ * @brief Function that forwards to the best implementation for the current
+ *        processor.
+ *
+ * The implementation is selected once on construction. Calls are forwarded
+ * through the cached function pointer without testing any features. A
+ * dispatcher is meant to be defined at namespace scope:
+ *
+ * @code
+ * const cpuidpp::dispatcher<float(const float*, std::size_t)> sum{
+ *     {sum_avx512, {&cpuidpp::snapshot::avx512f_usable}},
+ *     {sum_avx2, {&cpuidpp::snapshot::avx2_usable,
+ *                 &cpuidpp::snapshot::fma_usable}},
+ *     {sum_generic, {}}
+ * };
+ * @endcode
+ */
+template<class R, class ...Args>
+class dispatcher<R(Args...)>
+{
+public:
+    //! Type of the function pointer the calls are forwarded to.
+    using function_type = R (*)(Args...);
+
+    //! Selects the best of the ranked @p candidates.
+    dispatcher(std::initializer_list<candidate<function_type>> candidates,
+               const snapshot& s = features())
+        : function_{select(candidates, s)}
+    {
+    }
+
+    //! Invokes the selected implementation.
+    R operator()(Args... args) const
+    {
+        return function_(std::forward<Args>(args)...);
+    }
+
+    //! Returns the selected implementation.
+    function_type target() const noexcept
+    {
+        return function_;
+    }
+
+private:
+    function_type function_;
+};
+
+/**
+ * @brief Consistent set of related implementations selected at once.
+ *
+ * @tparam Table Structure whose members are the function pointers of a single
+ *         implementation variant.
+ *
+ * All members of the selected table are used together which avoids mixing
+ * implementations that, e.g., expect different data layouts.
+ */
+template<class Table>
+class dispatch_table
+{
+public:
+    //! Selects the best of the ranked @p candidates.
+    dispatch_table(std::initializer_list<candidate<const Table*>> candidates,
+                   const snapshot& s = features())
+        : table_{select(candidates, s)}
+    {
+    }
+
+    //! Returns the selected table.
+    const Table& operator*() const noexcept
+    {
+        return *table_;
+    }
+
+    //! Accesses the members of the selected table.
+    const Table* operator->() const noexcept
+    {
+        return table_;
+    }
+
+private:
+    const Table* table_;
+};
+
+} // namespace cpuidpp
+
+#endif // !defined(CPUIDPP_DISPATCH_HPP)
@@ -0,0 +1,194 @@
+/**
+ * @brief %cpuidpp serialized CPUID dumps.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef CPUIDPP_DUMP_HPP
+#define CPUIDPP_DUMP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <cpuidpp/cpuidpp.hpp>
+#include <cpuidpp/export.hpp>
+#include <cpuidpp/source.hpp>
+
+namespace cpuidpp {
+
+/**
+ * @brief Identifies the processor a dump was captured on.
+ *
+ * The fingerprint consists of the vendor ID, the processor signature and the
+ * feature flags of leaf 1 which requires executing @c CPUID twice. Leaf 1
+ * @c EBX is omitted since it holds the APIC ID of the executing processor.
+ */
+struct cpuid_fingerprint
+{
+    //! @c EAX=0: @c EAX, @c EBX, @c ECX and @c EDX.
+    std::uint32_t leaf0[4];
+    //! @c EAX=1: @c EAX (family, model and stepping).
+    std::uint32_t signature;
+    //! @c EAX=1: @c ECX.
+    std::uint32_t leaf1_ecx;
+    //! @c EAX=1: @c EDX.
+    std::uint32_t leaf1_edx;
+
+    //! Computes the fingerprint of the processor executing the function.
+    CPUIDPP_EXPORT static cpuid_fingerprint current() noexcept;
+
+    //! Indicates whether both fingerprints are the same.
+    friend bool operator==(const cpuid_fingerprint& lhs,
+                           const cpuid_fingerprint& rhs) noexcept
+    {
+        return lhs.leaf0[0] == rhs.leaf0[0] && lhs.leaf0[1] == rhs.leaf0[1] &&
+            lhs.leaf0[2] == rhs.leaf0[2] && lhs.leaf0[3] == rhs.leaf0[3] &&
+            lhs.signature == rhs.signature &&
+            lhs.leaf1_ecx == rhs.leaf1_ecx && lhs.leaf1_edx == rhs.leaf1_edx;
+    }
+
+    //! Indicates whether the fingerprints differ.
+    friend bool operator!=(const cpuid_fingerprint& lhs,
+                           const cpuid_fingerprint& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+};
+
+/**
+ * @brief Raw values of all @c CPUID leaves and subleaves of a processor.
+ *
+ * Under virtualization, every @c CPUID instruction is trapped by the
+ * hypervisor and may take thousands of cycles. A dump captured once can be
+ * saved to a compact, versioned binary file which later processes map
+ * read-only instead of executing @c CPUID.
+ *
+ * If the environment variable @c CPUIDPP_DUMP names a file, the library loads
+ * the dump during static initialization and answers its @c CPUID queries from
+ * it. A missing dump or one whose fingerprint or @c XCR0 differs from the
+ * current processor is captured anew and written to the file. Topology
+ * enumeration always executes @c CPUID on each logical processor since the
+ * topology leaves report the APIC ID of the executing processor.
+ *
+ * The environment variable @c CPUIDPP_REPLAY instead names a dump that is
+ * replayed without comparing it against the current processor. The library
+ * then reports the features, caches and topology of the captured machine
+ * which allows to test dispatch decisions for other processors. The Time
+ * Stamp Counter frequency is still obtained from the current processor.
+ * Executing the instructions of replayed features the current processor lacks
+ * raises an illegal instruction exception.
+ */
+class CPUIDPP_EXPORT cpuid_dump : public cpuid_source
+{
+public:
+    //! Version of the binary format written by @ref save().
+    static constexpr std::uint32_t format_version = 1;
+
+    //! Creates an empty dump.
+    cpuid_dump() noexcept;
+
+    /**
+     * @brief Creates a dump from @p records.
+     *
+     * The fingerprint is derived from the records of leaves 0 and 1.
+     */
+    cpuid_dump(std::vector<cpuid_record> records, std::uint64_t xcr0);
+    cpuid_dump(cpuid_dump&& other) noexcept;
+    cpuid_dump& operator=(cpuid_dump&& other) noexcept;
+    ~cpuid_dump() override;
+
+    cpuid_dump(const cpuid_dump&) = delete;
+    cpuid_dump& operator=(const cpuid_dump&) = delete;
+
+    /**
+     * @brief Executes all basic, hypervisor and extended leaves along with
+     *        their subleaves on the calling thread.
+     */
+    static cpuid_dump capture();
+
+    /**
+     * @brief Executes all leaves like @ref capture() and additionally the
+     *        topology leaves on each logical processor the process may run
+     *        on.
+     *
+     * The topology of the machine can then be reproduced from the dump.
+     */
+    static cpuid_dump capture_all_cpus();
+
+    /**
+     * @brief Maps the dump stored in the file @p path.
+     *
+     * @return @c false if the file cannot be read or is not a valid dump of
+     *         the supported format version. The dump is empty in this case.
+     */
+    bool load(const char* path);
+
+    /**
+     * @brief Writes the dump to the file @p path.
+     *
+     * The file is replaced atomically on POSIX systems.
+     */
+    bool save(const char* path) const;
+
+    //! Indicates whether the dump contains no records.
+    bool empty() const noexcept;
+
+    //! Returns the number of records.
+    std::size_t size() const noexcept;
+
+    //! Returns the records sorted by leaf, subleaf and processor.
+    const cpuid_record* begin() const noexcept;
+
+    //! Returns the end of the records.
+    const cpuid_record* end() const noexcept;
+
+    //! Returns the fingerprint of the processor the dump was captured on.
+    const cpuid_fingerprint& fingerprint() const noexcept;
+
+    std::uint64_t xcr0() const noexcept override;
+
+    //! Answers the query from the records. Missing records read as zero.
+    void query(std::uint32_t cpu, std::uint32_t leaf, std::uint32_t subleaf,
+               std::uint32_t (&regs)[4]) const noexcept override;
+
+    //! Returns the processors having topology records of their own.
+    std::vector<std::uint32_t> cpus() const override;
+
+    /**
+     * @brief Indicates whether the dump was captured on a processor identical
+     *        to the current one.
+     *
+     * Compares the fingerprint and the @c XCR0 register of the calling
+     * processor against the dump.
+     */
+    bool matches_host() const noexcept;
+
+    /**
+     * @brief Returns the record of @p leaf and @p subleaf or @c nullptr if the
+     *        dump does not contain it.
+     *
+     * A record specific to the processor @p cpu takes precedence over one
+     * valid for any processor.
+     */
+    const cpuid_record* find(std::uint32_t leaf, std::uint32_t subleaf,
+                             std::uint32_t cpu = any_cpu) const noexcept;
+
+private:
+    void reset() noexcept;
+
+    std::vector<cpuid_record> storage_;
+    const cpuid_record* records_;
+    std::size_t size_;
+    cpuid_fingerprint fingerprint_;
+    std::uint64_t xcr0_;
+    void* mapping_;
+    std::size_t mapping_size_;
+};
+
+} // namespace cpuidpp
+
+#endif // !defined(CPUIDPP_DUMP_HPP)
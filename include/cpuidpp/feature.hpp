@@ -0,0 +1,908 @@
+/**
+ * @brief %cpuidpp feature enumeration and compile-time feature baseline.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef CPUIDPP_FEATURE_HPP
+#define CPUIDPP_FEATURE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <cpuidpp/cpuidpp.hpp>
+
+namespace cpuidpp {
+
+/**
+ * @brief Feature flags of @ref snapshot.
+ *
+ * The value of an enumerator encodes the position of the flag as
+ * <tt>word * 32 + bit</tt> where @c word is a @ref snapshot::word.
+ */
+enum class feature : unsigned
+{
+#define CPUIDPP_FEATURE(name, index, bit) \
+    name = snapshot::index * 32 + bit,
+
+    CPUIDPP_FEATURE(fpu,              leaf1_edx,        0)
+    CPUIDPP_FEATURE(vme,              leaf1_edx,        1)
+    CPUIDPP_FEATURE(de,               leaf1_edx,        2)
+    CPUIDPP_FEATURE(pse,              leaf1_edx,        3)
+    CPUIDPP_FEATURE(tsc,              leaf1_edx,        4)
+    CPUIDPP_FEATURE(msr,              leaf1_edx,        5)
+    CPUIDPP_FEATURE(pae,              leaf1_edx,        6)
+    CPUIDPP_FEATURE(mce,              leaf1_edx,        7)
+    CPUIDPP_FEATURE(cx8,              leaf1_edx,        8)
+    CPUIDPP_FEATURE(apic,             leaf1_edx,        9)
+    CPUIDPP_FEATURE(sep,              leaf1_edx,        11)
+    CPUIDPP_FEATURE(mtrr,             leaf1_edx,        12)
+    CPUIDPP_FEATURE(pge,              leaf1_edx,        13)
+    CPUIDPP_FEATURE(mca,              leaf1_edx,        14)
+    CPUIDPP_FEATURE(cmov,             leaf1_edx,        15)
+    CPUIDPP_FEATURE(pat,              leaf1_edx,        16)
+    CPUIDPP_FEATURE(pse36,            leaf1_edx,        17)
+    CPUIDPP_FEATURE(psn,              leaf1_edx,        18)
+    CPUIDPP_FEATURE(clfsh,            leaf1_edx,        19)
+    CPUIDPP_FEATURE(ds,               leaf1_edx,        21)
+    CPUIDPP_FEATURE(acpi,             leaf1_edx,        22)
+    CPUIDPP_FEATURE(mmx,              leaf1_edx,        23)
+    CPUIDPP_FEATURE(fxsr,             leaf1_edx,        24)
+    CPUIDPP_FEATURE(sse,              leaf1_edx,        25)
+    CPUIDPP_FEATURE(sse2,             leaf1_edx,        26)
+    CPUIDPP_FEATURE(ss,               leaf1_edx,        27)
+    CPUIDPP_FEATURE(htt,              leaf1_edx,        28)
+    CPUIDPP_FEATURE(tm,               leaf1_edx,        29)
+    CPUIDPP_FEATURE(ia64,             leaf1_edx,        30)
+    CPUIDPP_FEATURE(pbe,              leaf1_edx,        31)
+
+    CPUIDPP_FEATURE(sse3,             leaf1_ecx,        0)
+    CPUIDPP_FEATURE(pclmulqdq,        leaf1_ecx,        1)
+    CPUIDPP_FEATURE(dtes64,           leaf1_ecx,        2)
+    CPUIDPP_FEATURE(monitor,          leaf1_ecx,        3)
+    CPUIDPP_FEATURE(ds_cpl,           leaf1_ecx,        4)
+    CPUIDPP_FEATURE(vmx,              leaf1_ecx,        5)
+    CPUIDPP_FEATURE(smx,              leaf1_ecx,        6)
+    CPUIDPP_FEATURE(eist,             leaf1_ecx,        7)
+    CPUIDPP_FEATURE(tm2,              leaf1_ecx,        8)
+    CPUIDPP_FEATURE(ssse3,            leaf1_ecx,        9)
+    CPUIDPP_FEATURE(cnxt_id,          leaf1_ecx,        10)
+    CPUIDPP_FEATURE(sdbg,             leaf1_ecx,        11)
+    CPUIDPP_FEATURE(fma,              leaf1_ecx,        12)
+    CPUIDPP_FEATURE(cx16,             leaf1_ecx,        13)
+    CPUIDPP_FEATURE(xtpr,             leaf1_ecx,        14)
+    CPUIDPP_FEATURE(pdcm,             leaf1_ecx,        15)
+
+    CPUIDPP_FEATURE(pcid,             leaf1_ecx,        17)
+    CPUIDPP_FEATURE(dca,              leaf1_ecx,        18)
+    CPUIDPP_FEATURE(sse4_1,           leaf1_ecx,        19)
+    CPUIDPP_FEATURE(sse4_2,           leaf1_ecx,        20)
+    CPUIDPP_FEATURE(x2apic,           leaf1_ecx,        21)
+    CPUIDPP_FEATURE(movbe,            leaf1_ecx,        22)
+    CPUIDPP_FEATURE(popcnt,           leaf1_ecx,        23)
+    CPUIDPP_FEATURE(tsc_deadline,     leaf1_ecx,        24)
+    CPUIDPP_FEATURE(aes,              leaf1_ecx,        25)
+    CPUIDPP_FEATURE(xsave,            leaf1_ecx,        26)
+    CPUIDPP_FEATURE(oxsave,           leaf1_ecx,        27)
+    CPUIDPP_FEATURE(avx,              leaf1_ecx,        28)
+    CPUIDPP_FEATURE(f16c,             leaf1_ecx,        29)
+    CPUIDPP_FEATURE(rdrnd,            leaf1_ecx,        30)
+    CPUIDPP_FEATURE(hypervisor,       leaf1_ecx,        31)
+
+    CPUIDPP_FEATURE(fsgsbase,         leaf7_ebx,        0)
+
+    CPUIDPP_FEATURE(sgx,              leaf7_ebx,        2)
+    CPUIDPP_FEATURE(bmi1,             leaf7_ebx,        3)
+    CPUIDPP_FEATURE(hle,              leaf7_ebx,        4)
+    CPUIDPP_FEATURE(avx2,             leaf7_ebx,        5)
+
+    CPUIDPP_FEATURE(smep,             leaf7_ebx,        7)
+    CPUIDPP_FEATURE(bmi2,             leaf7_ebx,        8)
+    CPUIDPP_FEATURE(erms,             leaf7_ebx,        9)
+    CPUIDPP_FEATURE(invpcid,          leaf7_ebx,        10)
+    CPUIDPP_FEATURE(rtm,              leaf7_ebx,        11)
+    CPUIDPP_FEATURE(pqm,              leaf7_ebx,        12)
+
+    CPUIDPP_FEATURE(mpx,              leaf7_ebx,        14)
+    CPUIDPP_FEATURE(pqe,              leaf7_ebx,        15)
+    CPUIDPP_FEATURE(avx512f,          leaf7_ebx,        16)
+    CPUIDPP_FEATURE(avx512dq,         leaf7_ebx,        17)
+    CPUIDPP_FEATURE(rdseed,           leaf7_ebx,        18)
+    CPUIDPP_FEATURE(adx,              leaf7_ebx,        19)
+    CPUIDPP_FEATURE(smap,             leaf7_ebx,        20)
+    CPUIDPP_FEATURE(avx512ifma,       leaf7_ebx,        21)
+    CPUIDPP_FEATURE(pcommit,          leaf7_ebx,        22)
+    CPUIDPP_FEATURE(clflushopt,       leaf7_ebx,        23)
+    CPUIDPP_FEATURE(clwb,             leaf7_ebx,        24)
+    CPUIDPP_FEATURE(intel_pt,         leaf7_ebx,        25)
+    CPUIDPP_FEATURE(avx512pf,         leaf7_ebx,        26)
+    CPUIDPP_FEATURE(avx512er,         leaf7_ebx,        27)
+    CPUIDPP_FEATURE(avx512cd,         leaf7_ebx,        28)
+    CPUIDPP_FEATURE(sha,              leaf7_ebx,        29)
+    CPUIDPP_FEATURE(avx512bw,         leaf7_ebx,        30)
+    CPUIDPP_FEATURE(avx512vl,         leaf7_ebx,        31)
+
+    CPUIDPP_FEATURE(prefetchwt1,      leaf7_ecx,        0)
+    CPUIDPP_FEATURE(avx512vbmi,       leaf7_ecx,        1)
+    CPUIDPP_FEATURE(umip,             leaf7_ecx,        2)
+    CPUIDPP_FEATURE(pku,              leaf7_ecx,        3)
+    CPUIDPP_FEATURE(ospke,            leaf7_ecx,        4)
+
+    CPUIDPP_FEATURE(avx512vbmi2,      leaf7_ecx,        6)
+
+    CPUIDPP_FEATURE(gfni,             leaf7_ecx,        8)
+    CPUIDPP_FEATURE(vaes,             leaf7_ecx,        9)
+    CPUIDPP_FEATURE(vpclmulqdq,       leaf7_ecx,        10)
+    CPUIDPP_FEATURE(avx512vnni,       leaf7_ecx,        11)
+    CPUIDPP_FEATURE(avx512bitalg,     leaf7_ecx,        12)
+
+    CPUIDPP_FEATURE(avx512vpopcntdq,  leaf7_ecx,        14)
+
+    CPUIDPP_FEATURE(rdpid,            leaf7_ecx,        22)
+
+    CPUIDPP_FEATURE(sgx_lc,           leaf7_ecx,        30)
+
+    CPUIDPP_FEATURE(avx512_4vnniw,    leaf7_edx,        2)
+    CPUIDPP_FEATURE(avx512_4fmaps,    leaf7_edx,        3)
+    CPUIDPP_FEATURE(fsrm,             leaf7_edx,        4)
+
+    CPUIDPP_FEATURE(hybrid,           leaf7_edx,        15)
+
+    CPUIDPP_FEATURE(amx_bf16,         leaf7_edx,        22)
+    CPUIDPP_FEATURE(avx512fp16,       leaf7_edx,        23)
+    CPUIDPP_FEATURE(amx_tile,         leaf7_edx,        24)
+    CPUIDPP_FEATURE(amx_int8,         leaf7_edx,        25)
+
+    CPUIDPP_FEATURE(avx_vnni,         leaf7_1_eax,      4)
+    CPUIDPP_FEATURE(avx512bf16,       leaf7_1_eax,      5)
+
+    CPUIDPP_FEATURE(fzrm,             leaf7_1_eax,      10)
+    CPUIDPP_FEATURE(fsrs,             leaf7_1_eax,      11)
+    CPUIDPP_FEATURE(fsrc,             leaf7_1_eax,      12)
+
+    CPUIDPP_FEATURE(amx_fp16,         leaf7_1_eax,      21)
+
+    CPUIDPP_FEATURE(avx_ifma,         leaf7_1_eax,      23)
+
+    CPUIDPP_FEATURE(avx_ne_convert,   leaf7_1_edx,      5)
+
+    CPUIDPP_FEATURE(avx10,            leaf7_1_edx,      19)
+
+    CPUIDPP_FEATURE(avx10_128,        leaf24_ebx,       16)
+    CPUIDPP_FEATURE(avx10_256,        leaf24_ebx,       17)
+    CPUIDPP_FEATURE(avx10_512,        leaf24_ebx,       18)
+
+    // AMD specific
+
+    CPUIDPP_FEATURE(syscall,          leaf80000001_edx, 11)
+
+    CPUIDPP_FEATURE(mp,               leaf80000001_edx, 19)
+    CPUIDPP_FEATURE(nx,               leaf80000001_edx, 20)
+
+    CPUIDPP_FEATURE(mmxext,           leaf80000001_edx, 22)
+
+    CPUIDPP_FEATURE(fxsr_opt,         leaf80000001_edx, 25)
+    CPUIDPP_FEATURE(pdpe1gb,          leaf80000001_edx, 26)
+    CPUIDPP_FEATURE(rdtscp,           leaf80000001_edx, 27)
+
+    CPUIDPP_FEATURE(lm,               leaf80000001_edx, 29)
+    CPUIDPP_FEATURE(amd_3dnowext,     leaf80000001_edx, 30)
+    CPUIDPP_FEATURE(amd_3dnow,        leaf80000001_edx, 31)
+
+    CPUIDPP_FEATURE(lahf_lm,          leaf80000001_ecx, 0)
+    CPUIDPP_FEATURE(cmp_legacy,       leaf80000001_ecx, 1)
+    CPUIDPP_FEATURE(svm,              leaf80000001_ecx, 2)
+    CPUIDPP_FEATURE(extapic,          leaf80000001_ecx, 3)
+    CPUIDPP_FEATURE(cr8_legacy,       leaf80000001_ecx, 4)
+    CPUIDPP_FEATURE(abm,              leaf80000001_ecx, 5)
+    CPUIDPP_FEATURE(sse4a,            leaf80000001_ecx, 6)
+    CPUIDPP_FEATURE(misalignsse,      leaf80000001_ecx, 7)
+    CPUIDPP_FEATURE(amd_3dnowprefetch,leaf80000001_ecx, 8)
+    CPUIDPP_FEATURE(osvw,             leaf80000001_ecx, 9)
+    CPUIDPP_FEATURE(ibs,              leaf80000001_ecx, 10)
+    CPUIDPP_FEATURE(xop,              leaf80000001_ecx, 11)
+    CPUIDPP_FEATURE(skinit,           leaf80000001_ecx, 12)
+    CPUIDPP_FEATURE(wdt,              leaf80000001_ecx, 13)
+
+    CPUIDPP_FEATURE(lwp,              leaf80000001_ecx, 15)
+    CPUIDPP_FEATURE(fma4,             leaf80000001_ecx, 16)
+    CPUIDPP_FEATURE(tce,              leaf80000001_ecx, 17)
+
+    CPUIDPP_FEATURE(nodeid_msr,       leaf80000001_ecx, 19)
+
+    CPUIDPP_FEATURE(tbm,              leaf80000001_ecx, 21)
+    CPUIDPP_FEATURE(topoext,          leaf80000001_ecx, 22)
+    CPUIDPP_FEATURE(perfctr_core,     leaf80000001_ecx, 23)
+    CPUIDPP_FEATURE(perfctr_nb,       leaf80000001_ecx, 24)
+
+    CPUIDPP_FEATURE(dbx,              leaf80000001_ecx, 26)
+    CPUIDPP_FEATURE(perftsc,          leaf80000001_ecx, 27)
+    CPUIDPP_FEATURE(pcx_l2i,          leaf80000001_ecx, 28)
+
+    // Advanced power management
+
+    CPUIDPP_FEATURE(invariant_tsc,    leaf80000007_edx, 8)
+
+#undef CPUIDPP_FEATURE
+};
+
+//! Returns the register word of @ref snapshot that holds the flag @p f.
+constexpr snapshot::word word_of(feature f) noexcept
+{
+    return static_cast<snapshot::word>(static_cast<unsigned>(f) / 32U);
+}
+
+//! Returns the bit position of the flag @p f within its register word.
+constexpr unsigned bit_of(feature f) noexcept
+{
+    return static_cast<unsigned>(f) % 32U;
+}
+
+//! Indicates whether the feature @p f is present in @p s.
+inline bool test(const snapshot& s, feature f) noexcept
+{
+    return s.test(word_of(f), bit_of(f));
+}
+
+/**
+ * @brief Indicates whether the compiler may already emit instructions of the
+ *        feature @p F.
+ *
+ * The trait derives from @c std::true_type if the predefined macros of the
+ * target architecture, e.g., @c __AVX2__ enabled by @c -mavx2 or @c
+ * -march=x86-64-v3, guarantee the feature. A binary compiled this way does
+ * not run on processors lacking the feature anyway.
+ */
+template<feature F>
+struct is_baseline : std::false_type
+{
+};
+
+/**
+ * @brief Returns the flags of the register word @p w operating on the @c YMM
+ *        register state.
+ */
+constexpr std::uint32_t ymm_flags(snapshot::word w) noexcept
+{
+    return w == snapshot::leaf1_ecx ? (1U << 12U) | (1U << 28U) | (1U << 29U)
+         : w == snapshot::leaf7_ebx ? (1U << 5U)
+         : w == snapshot::leaf7_ecx ? (1U << 9U) | (1U << 10U)
+         : w == snapshot::leaf7_1_eax ? (1U << 4U) | (1U << 23U)
+         : w == snapshot::leaf7_1_edx ? (1U << 5U)
+         : 0;
+}
+
+/**
+ * @brief Returns the flags of the register word @p w operating on the @c ZMM
+ *        and opmask register state.
+ */
+constexpr std::uint32_t zmm_flags(snapshot::word w) noexcept
+{
+    return w == snapshot::leaf7_ebx ? (1U << 16U) | (1U << 17U) | (1U << 21U) |
+                                      (1U << 26U) | (1U << 27U) | (1U << 28U) |
+                                      (1U << 30U) | (1U << 31U)
+         : w == snapshot::leaf7_ecx ? (1U << 1U) | (1U << 6U) | (1U << 11U) |
+                                      (1U << 12U) | (1U << 14U)
+         : w == snapshot::leaf7_edx ? (1U << 2U) | (1U << 3U) | (1U << 23U)
+         : w == snapshot::leaf7_1_eax ? (1U << 5U)
+         : w == snapshot::leaf7_1_edx ? (1U << 19U)
+         : w == snapshot::leaf24_ebx ? (1U << 16U) | (1U << 17U) | (1U << 18U)
+         : 0;
+}
+
+/**
+ * @brief Returns the flags of the register word @p w operating on the AMX tile
+ *        configuration and tile data state.
+ */
+constexpr std::uint32_t tmm_flags(snapshot::word w) noexcept
+{
+    return w == snapshot::leaf7_edx ? (1U << 22U) | (1U << 24U) | (1U << 25U)
+         : w == snapshot::leaf7_1_eax ? (1U << 21U)
+         : 0;
+}
+
+/**
+ * @brief Returns the mask of the @c XCR0 state components the OS must enable
+ *        for the feature @p f to be usable.
+ */
+constexpr std::uint32_t required_state_of(feature f) noexcept
+{
+    return ((tmm_flags(word_of(f)) >> bit_of(f)) & 1U) != 0 ? 0x60000U
+         : ((zmm_flags(word_of(f)) >> bit_of(f)) & 1U) != 0 ? 0xe6U
+         : ((ymm_flags(word_of(f)) >> bit_of(f)) & 1U) != 0 ? 0x6U
+         : 0;
+}
+
+//! @ref required_state_of() as a trait.
+template<feature F>
+struct required_state
+    : std::integral_constant<std::uint32_t, required_state_of(F)>
+{
+};
+
+#define CPUIDPP_BASELINE(name)                              \
+    template<>                                              \
+    struct is_baseline<feature::name> : std::true_type      \
+    {                                                       \
+    };
+
+#if defined(__x86_64__) || defined(_M_X64)
+CPUIDPP_BASELINE(fpu)
+CPUIDPP_BASELINE(cx8)
+CPUIDPP_BASELINE(cmov)
+CPUIDPP_BASELINE(mmx)
+CPUIDPP_BASELINE(fxsr)
+CPUIDPP_BASELINE(sse)
+CPUIDPP_BASELINE(sse2)
+CPUIDPP_BASELINE(lm)
+#elif defined(_M_IX86_FP) && _M_IX86_FP >= 1
+CPUIDPP_BASELINE(sse)
+#if _M_IX86_FP >= 2
+CPUIDPP_BASELINE(sse2)
+#endif // _M_IX86_FP >= 2
+#elif defined(__SSE__) || defined(__SSE2__)
+CPUIDPP_BASELINE(sse)
+#if defined(__SSE2__)
+CPUIDPP_BASELINE(sse2)
+#endif // defined(__SSE2__)
+#endif // defined(__x86_64__) || defined(_M_X64)
+
+#if defined(__SSE3__)
+CPUIDPP_BASELINE(sse3)
+#endif // defined(__SSE3__)
+
+#if defined(__SSSE3__)
+CPUIDPP_BASELINE(ssse3)
+#endif // defined(__SSSE3__)
+
+#if defined(__SSE4_1__)
+CPUIDPP_BASELINE(sse4_1)
+#endif // defined(__SSE4_1__)
+
+#if defined(__SSE4_2__)
+CPUIDPP_BASELINE(sse4_2)
+#endif // defined(__SSE4_2__)
+
+#if defined(__SSE4A__)
+CPUIDPP_BASELINE(sse4a)
+#endif // defined(__SSE4A__)
+
+#if defined(__POPCNT__)
+CPUIDPP_BASELINE(popcnt)
+#endif // defined(__POPCNT__)
+
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+CPUIDPP_BASELINE(cx16)
+#endif // defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+
+#if defined(__LAHF_SAHF__)
+CPUIDPP_BASELINE(lahf_lm)
+#endif // defined(__LAHF_SAHF__)
+
+#if defined(__PCLMUL__)
+CPUIDPP_BASELINE(pclmulqdq)
+#endif // defined(__PCLMUL__)
+
+#if defined(__AES__)
+CPUIDPP_BASELINE(aes)
+#endif // defined(__AES__)
+
+#if defined(__SHA__)
+CPUIDPP_BASELINE(sha)
+#endif // defined(__SHA__)
+
+#if defined(__XSAVE__)
+CPUIDPP_BASELINE(xsave)
+#endif // defined(__XSAVE__)
+
+#if defined(__AVX__)
+CPUIDPP_BASELINE(avx)
+#endif // defined(__AVX__)
+
+#if defined(__AVX2__)
+CPUIDPP_BASELINE(avx2)
+#endif // defined(__AVX2__)
+
+#if defined(__FMA__)
+CPUIDPP_BASELINE(fma)
+#endif // defined(__FMA__)
+
+#if defined(__FMA4__)
+CPUIDPP_BASELINE(fma4)
+#endif // defined(__FMA4__)
+
+#if defined(__XOP__)
+CPUIDPP_BASELINE(xop)
+#endif // defined(__XOP__)
+
+#if defined(__F16C__)
+CPUIDPP_BASELINE(f16c)
+#endif // defined(__F16C__)
+
+#if defined(__BMI__)
+CPUIDPP_BASELINE(bmi1)
+#endif // defined(__BMI__)
+
+#if defined(__BMI2__)
+CPUIDPP_BASELINE(bmi2)
+#endif // defined(__BMI2__)
+
+#if defined(__LZCNT__)
+CPUIDPP_BASELINE(abm)
+#endif // defined(__LZCNT__)
+
+#if defined(__TBM__)
+CPUIDPP_BASELINE(tbm)
+#endif // defined(__TBM__)
+
+#if defined(__MOVBE__)
+CPUIDPP_BASELINE(movbe)
+#endif // defined(__MOVBE__)
+
+#if defined(__RDRND__)
+CPUIDPP_BASELINE(rdrnd)
+#endif // defined(__RDRND__)
+
+#if defined(__RDSEED__)
+CPUIDPP_BASELINE(rdseed)
+#endif // defined(__RDSEED__)
+
+#if defined(__ADX__)
+CPUIDPP_BASELINE(adx)
+#endif // defined(__ADX__)
+
+#if defined(__FSGSBASE__)
+CPUIDPP_BASELINE(fsgsbase)
+#endif // defined(__FSGSBASE__)
+
+#if defined(__RTM__)
+CPUIDPP_BASELINE(rtm)
+#endif // defined(__RTM__)
+
+#if defined(__HLE__)
+CPUIDPP_BASELINE(hle)
+#endif // defined(__HLE__)
+
+#if defined(__CLFLUSHOPT__)
+CPUIDPP_BASELINE(clflushopt)
+#endif // defined(__CLFLUSHOPT__)
+
+#if defined(__CLWB__)
+CPUIDPP_BASELINE(clwb)
+#endif // defined(__CLWB__)
+
+#if defined(__RDPID__)
+CPUIDPP_BASELINE(rdpid)
+#endif // defined(__RDPID__)
+
+#if defined(__PKU__)
+CPUIDPP_BASELINE(pku)
+#endif // defined(__PKU__)
+
+#if defined(__PREFETCHWT1__)
+CPUIDPP_BASELINE(prefetchwt1)
+#endif // defined(__PREFETCHWT1__)
+
+#if defined(__PRFCHW__)
+CPUIDPP_BASELINE(amd_3dnowprefetch)
+#endif // defined(__PRFCHW__)
+
+#if defined(__3dNOW__)
+CPUIDPP_BASELINE(amd_3dnow)
+#endif // defined(__3dNOW__)
+
+#if defined(__3dNOW_A__)
+CPUIDPP_BASELINE(amd_3dnowext)
+#endif // defined(__3dNOW_A__)
+
+#if defined(__AVX512F__)
+CPUIDPP_BASELINE(avx512f)
+#endif // defined(__AVX512F__)
+
+#if defined(__AVX512CD__)
+CPUIDPP_BASELINE(avx512cd)
+#endif // defined(__AVX512CD__)
+
+#if defined(__AVX512DQ__)
+CPUIDPP_BASELINE(avx512dq)
+#endif // defined(__AVX512DQ__)
+
+#if defined(__AVX512BW__)
+CPUIDPP_BASELINE(avx512bw)
+#endif // defined(__AVX512BW__)
+
+#if defined(__AVX512VL__)
+CPUIDPP_BASELINE(avx512vl)
+#endif // defined(__AVX512VL__)
+
+#if defined(__AVX512IFMA__)
+CPUIDPP_BASELINE(avx512ifma)
+#endif // defined(__AVX512IFMA__)
+
+#if defined(__AVX512VBMI__)
+CPUIDPP_BASELINE(avx512vbmi)
+#endif // defined(__AVX512VBMI__)
+
+#if defined(__AVX512VPOPCNTDQ__)
+CPUIDPP_BASELINE(avx512vpopcntdq)
+#endif // defined(__AVX512VPOPCNTDQ__)
+
+#if defined(__AVX512ER__)
+CPUIDPP_BASELINE(avx512er)
+#endif // defined(__AVX512ER__)
+
+#if defined(__AVX512PF__)
+CPUIDPP_BASELINE(avx512pf)
+#endif // defined(__AVX512PF__)
+
+#if defined(__AVX5124FMAPS__)
+CPUIDPP_BASELINE(avx512_4fmaps)
+#endif // defined(__AVX5124FMAPS__)
+
+#if defined(__AVX5124VNNIW__)
+CPUIDPP_BASELINE(avx512_4vnniw)
+#endif // defined(__AVX5124VNNIW__)
+
+#if defined(__AVX512VBMI2__)
+CPUIDPP_BASELINE(avx512vbmi2)
+#endif // defined(__AVX512VBMI2__)
+
+#if defined(__AVX512VNNI__)
+CPUIDPP_BASELINE(avx512vnni)
+#endif // defined(__AVX512VNNI__)
+
+#if defined(__AVX512BITALG__)
+CPUIDPP_BASELINE(avx512bitalg)
+#endif // defined(__AVX512BITALG__)
+
+#if defined(__AVX512BF16__)
+CPUIDPP_BASELINE(avx512bf16)
+#endif // defined(__AVX512BF16__)
+
+#if defined(__AVX512FP16__)
+CPUIDPP_BASELINE(avx512fp16)
+#endif // defined(__AVX512FP16__)
+
+#if defined(__AVXVNNI__)
+CPUIDPP_BASELINE(avx_vnni)
+#endif // defined(__AVXVNNI__)
+
+#if defined(__AVXIFMA__)
+CPUIDPP_BASELINE(avx_ifma)
+#endif // defined(__AVXIFMA__)
+
+#if defined(__AVXNECONVERT__)
+CPUIDPP_BASELINE(avx_ne_convert)
+#endif // defined(__AVXNECONVERT__)
+
+#if defined(__AVX10_1__)
+CPUIDPP_BASELINE(avx10)
+#endif // defined(__AVX10_1__)
+
+#if defined(__GFNI__)
+CPUIDPP_BASELINE(gfni)
+#endif // defined(__GFNI__)
+
+#if defined(__VAES__)
+CPUIDPP_BASELINE(vaes)
+#endif // defined(__VAES__)
+
+#if defined(__VPCLMULQDQ__)
+CPUIDPP_BASELINE(vpclmulqdq)
+#endif // defined(__VPCLMULQDQ__)
+
+#undef CPUIDPP_BASELINE
+
+/**
+ * @brief Indicates whether the feature @p F can be used.
+ *
+ * If the feature belongs to the compile-time baseline (see @ref is_baseline),
+ * the function is a @c constexpr returning @c true. Branches depending on it
+ * are therefore folded and the fallback code is eliminated:
+ *
+ * @code
+ * if (cpuidpp::has<cpuidpp::feature::avx2>()) {
+ *     sum_avx2(data, size);  // the only branch left with -march=x86-64-v3
+ * }
+ * else {
+ *     sum_generic(data, size);
+ * }
+ * @endcode
+ *
+ * Otherwise, the flag is tested in @p s. Features operating on the extended
+ * register state additionally require the OS to enable that state, just like
+ * the @c *_usable() accessors of @ref snapshot.
+ */
+template<feature F>
+constexpr typename std::enable_if<is_baseline<F>::value, bool>::type
+has() noexcept
+{
+    return true;
+}
+
+//! @copydoc has()
+template<feature F>
+constexpr typename std::enable_if<is_baseline<F>::value, bool>::type
+has(const snapshot&) noexcept
+{
+    return true;
+}
+
+//! @copydoc has()
+template<feature F>
+inline typename std::enable_if<!is_baseline<F>::value, bool>::type
+has(const snapshot& s) noexcept
+{
+    return test(s, F) &&
+        (s.words[snapshot::xcr0] & required_state<F>::value) ==
+            required_state<F>::value;
+}
+
+//! @copydoc has()
+template<feature F>
+inline typename std::enable_if<!is_baseline<F>::value, bool>::type
+has() noexcept
+{
+    return has<F>(features());
+}
+
+namespace detail {
+
+template<std::size_t ...Indices>
+struct index_sequence
+{
+};
+
+template<std::size_t N, std::size_t ...Indices>
+struct make_index_sequence
+    : make_index_sequence<N - 1, N - 1, Indices...>
+{
+};
+
+template<std::size_t ...Indices>
+struct make_index_sequence<0, Indices...>
+{
+    using type = index_sequence<Indices...>;
+};
+
+//! Returns the bits the features @p fs occupy in the register word @p w.
+constexpr std::uint32_t word_mask(std::size_t) noexcept
+{
+    return 0;
+}
+
+template<class ...Features>
+constexpr std::uint32_t word_mask(std::size_t w, feature f,
+                                  Features... fs) noexcept
+{
+    return (word_of(f) == w ? std::uint32_t{1} << bit_of(f) : 0U) |
+        word_mask(w, fs...);
+}
+
+//! Returns the @c XCR0 state components the features @p fs require.
+constexpr std::uint32_t state_mask() noexcept
+{
+    return 0;
+}
+
+template<class ...Features>
+constexpr std::uint32_t state_mask(feature f, Features... fs) noexcept
+{
+    return required_state_of(f) | state_mask(fs...);
+}
+
+} // namespace detail
+
+/**
+ * @brief Fixed-size set of features laid out like the register words of
+ *        @ref snapshot.
+ *
+ * Besides the feature flags, the set holds the @c XCR0 state components the
+ * features operate on.
+ *
+ * The set can be constructed at compile time:
+ *
+ * @code
+ * constexpr cpuidpp::feature_set v3_kernel{
+ *     cpuidpp::feature::avx2, cpuidpp::feature::bmi2, cpuidpp::feature::fma,
+ *     cpuidpp::feature::f16c, cpuidpp::feature::movbe
+ * };
+ *
+ * if (cpuidpp::supports_all(v3_kernel)) {
+ *     // ...
+ * }
+ * @endcode
+ */
+class feature_set
+{
+    using indices = detail::make_index_sequence<snapshot::word_count>::type;
+
+public:
+    //! Creates an empty set.
+    constexpr feature_set() noexcept
+        : words_{}
+    {
+    }
+
+    //! Creates a set containing the features @p f and @p fs.
+    template<class ...Features>
+    constexpr feature_set(feature f, Features... fs) noexcept
+        : feature_set{indices{}, f, fs...}
+    {
+    }
+
+    //! Indicates whether the set contains the feature @p f.
+    constexpr bool contains(feature f) const noexcept
+    {
+        return ((words_[word_of(f)] >> bit_of(f)) & 1U) != 0;
+    }
+
+    //! Returns the bits of the set in the register word @p w.
+    constexpr std::uint32_t word(snapshot::word w) const noexcept
+    {
+        return words_[w];
+    }
+
+    //! Returns the union of both sets.
+    friend constexpr feature_set operator|(const feature_set& lhs,
+                                           const feature_set& rhs) noexcept
+    {
+        return feature_set{indices{}, lhs, rhs};
+    }
+
+private:
+    template<std::size_t ...Indices, class ...Features>
+    constexpr feature_set(detail::index_sequence<Indices...>,
+                          Features... fs) noexcept
+        : words_{(detail::word_mask(Indices, fs...) |
+                  (Indices == snapshot::xcr0 ? detail::state_mask(fs...) : 0U))...}
+    {
+    }
+
+    template<std::size_t ...Indices>
+    constexpr feature_set(detail::index_sequence<Indices...>,
+                          const feature_set& lhs,
+                          const feature_set& rhs) noexcept
+        : words_{(lhs.words_[Indices] | rhs.words_[Indices])...}
+    {
+    }
+
+    std::uint32_t words_[snapshot::word_count];
+};
+
+/**
+ * @brief Indicates whether all features of @p set can be used.
+ *
+ * The set already contains the @c XCR0 state components its features require
+ * (see @ref required_state_of()). The check therefore amounts to a masked
+ * comparison per register word.
+ */
+inline bool supports_all(const feature_set& set,
+                         const snapshot& s = features()) noexcept
+{
+    std::uint32_t missing = 0;
+
+    for (unsigned w = 0; w != snapshot::word_count; ++w) {
+        const auto index = static_cast<snapshot::word>(w);
+        missing |= set.word(index) & ~s.words[index];
+    }
+
+    return missing == 0;
+}
+
+/**
+ * @brief Indicates whether at least one feature of @p set can be used.
+ *
+ * Features operating on the extended register state are ignored unless the OS
+ * enables that state.
+ */
+inline bool supports_any(const feature_set& set,
+                         const snapshot& s = features()) noexcept
+{
+    const std::uint32_t no_ymm = s.os_avx() ? 0U : ~0U;
+    const std::uint32_t no_zmm = s.os_avx512() ? 0U : ~0U;
+    const std::uint32_t no_tmm = s.os_amx() ? 0U : ~0U;
+
+    std::uint32_t present = 0;
+
+    for (unsigned w = 0; w != snapshot::word_count; ++w) {
+        const auto index = static_cast<snapshot::word>(w);
+
+        if (index != snapshot::xcr0) {
+            present |= set.word(index) & s.words[index] &
+                ~(ymm_flags(index) & no_ymm) & ~(zmm_flags(index) & no_zmm) &
+                ~(tmm_flags(index) & no_tmm);
+        }
+    }
+
+    return present != 0;
+}
+
+/**
+ * @{
+ * @name x86-64 microarchitecture levels
+ * @brief Feature sets of the levels defined by the x86-64 psABI.
+ *
+ * Each level includes the features of the previous one. The OS support for
+ * @c FXSAVE (@c OSFXSR) required by x86-64-v1 is not visible through @c CPUID
+ * and is implied by any OS running in 64-bit mode.
+ */
+
+//! x86-64 baseline.
+constexpr feature_set x86_64_v1{
+    feature::cmov, feature::cx8, feature::fpu, feature::fxsr, feature::mmx,
+    feature::syscall, feature::sse, feature::sse2, feature::lm
+};
+
+//! x86-64-v2.
+constexpr feature_set x86_64_v2 = x86_64_v1 | feature_set{
+    feature::cx16, feature::lahf_lm, feature::popcnt, feature::sse3,
+    feature::sse4_1, feature::sse4_2, feature::ssse3
+};
+
+/**
+ * @brief x86-64-v3.
+ *
+ * The set includes the @c XMM and @c YMM state components which the OS must
+ * enable in addition to @c OSXSAVE.
+ */
+constexpr feature_set x86_64_v3 = x86_64_v2 | feature_set{
+    feature::avx, feature::avx2, feature::bmi1, feature::bmi2, feature::f16c,
+    feature::fma, feature::abm, feature::movbe, feature::oxsave
+};
+
+/**
+ * @brief x86-64-v4.
+ *
+ * The set includes the opmask and @c ZMM state components.
+ */
+constexpr feature_set x86_64_v4 = x86_64_v3 | feature_set{
+    feature::avx512f, feature::avx512bw, feature::avx512cd, feature::avx512dq,
+    feature::avx512vl
+};
+
+//! @}
+
+/**
+ * @brief Indicates whether @p s satisfies the x86-64 microarchitecture @p
+ *        level.
+ *
+ * Level 0 is always satisfied. Levels above 4 are never satisfied.
+ */
+inline bool meets_level(unsigned level,
+                        const snapshot& s = features()) noexcept
+{
+    return level == 0 ? true
+         : level == 1 ? supports_all(x86_64_v1, s)
+         : level == 2 ? supports_all(x86_64_v2, s)
+         : level == 3 ? supports_all(x86_64_v3, s)
+         : level == 4 ? supports_all(x86_64_v4, s)
+         : false;
+}
+
+/**
+ * @brief Returns the highest x86-64 microarchitecture level (1 to 4) @p s
+ *        satisfies.
+ *
+ * The result is 0 if even the x86-64 baseline is not satisfied, e.g., on a
+ * 32-bit only processor. The level allows to choose among artifacts built
+ * with @c -march=x86-64-v2, @c -march=x86-64-v3 and @c -march=x86-64-v4.
+ */
+inline unsigned x86_64_level(const snapshot& s = features()) noexcept
+{
+    unsigned level = 0;
+
+    while (level != 4 && meets_level(level + 1, s)) {
+        ++level;
+    }
+
+    return level;
+}
+
+} // namespace cpuidpp
+
+#endif // !defined(CPUIDPP_FEATURE_HPP)
@@ -0,0 +1,132 @@
+/**
+ * @brief %cpuidpp hypervisor detection.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef CPUIDPP_HYPERVISOR_HPP
+#define CPUIDPP_HYPERVISOR_HPP
+
+#include <cstdint>
+
+#include <cpuidpp/export.hpp>
+
+namespace cpuidpp {
+
+class cpuid_source;
+
+//! Hypervisor identified by the signature of its @c CPUID leaves.
+enum class hypervisor_vendor
+{
+    none,           //!< Not running on a hypervisor.
+    unknown,        //!< Hypervisor with an unrecognized signature.
+    kvm,            //!< Linux KVM (@c "KVMKVMKVM").
+    hyperv,         //!< Microsoft Hyper-V (@c "Microsoft Hv").
+    xen,            //!< Xen (@c "XenVMMXenVMM").
+    vmware,         //!< VMware (@c "VMwareVMware").
+    virtualbox,     //!< Oracle VirtualBox (@c "VBoxVBoxVBox").
+    qemu,           //!< QEMU without KVM acceleration (@c "TCGTCGTCGTCG").
+    parallels,      //!< Parallels (@c " prl hyperv ").
+    bhyve,          //!< FreeBSD bhyve (@c "bhyve bhyve ").
+    acrn,           //!< Project ACRN (@c "ACRNACRNACRN").
+    apple           //!< Apple Virtualization framework (@c "VirtualApple").
+};
+
+//! Paravirtual features reported by KVM in leaf 0x40000001 @c EAX.
+enum class kvm_feature : unsigned
+{
+    clocksource = 0,            //!< kvmclock at the legacy MSRs.
+    nop_io_delay = 1,           //!< Port 0x80 delays are unnecessary.
+    mmu_op = 2,                 //!< Deprecated MMU hypercalls.
+    clocksource2 = 3,           //!< kvmclock at the new MSRs.
+    async_pf = 4,               //!< Asynchronous page faults.
+    steal_time = 5,             //!< Steal time accounting.
+    pv_eoi = 6,                 //!< Paravirtual end of interrupt.
+    pv_unhalt = 7,              //!< Paravirtual spinlock kick.
+    pv_tlb_flush = 9,           //!< Paravirtual remote TLB flush.
+    async_pf_vmexit = 10,       //!< Asynchronous page faults in nested guests.
+    pv_send_ipi = 11,           //!< Paravirtual inter-processor interrupts.
+    poll_control = 12,          //!< Host-side halt polling can be disabled.
+    pv_sched_yield = 13,        //!< Directed yield to preempted vCPUs.
+    async_pf_int = 14,          //!< Asynchronous page faults via interrupt.
+    msi_ext_dest_id = 15,       //!< Extended destination IDs in MSIs.
+    hc_map_gpa_range = 16,      //!< Memory encryption status hypercall.
+    migration_control = 17,     //!< Migration control MSR.
+    clocksource_stable = 24     //!< kvmclock is stable across vCPUs.
+};
+
+/**
+ * @brief Hypervisor the process runs on, decoded from the leaf range starting
+ *        at 0x40000000.
+ *
+ * Some hypervisors expose the Hyper-V interface in the first range for the
+ * sake of Windows guests and their own interface in the range starting at
+ * 0x40000100. The native interface takes precedence in this case.
+ */
+struct hypervisor_info
+{
+    //! Identified hypervisor.
+    hypervisor_vendor vendor;
+    //! Vendor signature (empty unless virtualized).
+    char signature[13];
+    //! First leaf of the range of the vendor, e.g., 0x40000000.
+    std::uint32_t base_leaf;
+    //! Highest leaf of the range of the vendor.
+    std::uint32_t max_leaf;
+    //! Indicates whether the Hyper-V interface is exposed at 0x40000000.
+    bool hyperv_compatible;
+    //! KVM feature bits in leaf @c base_leaf + 1 @c EAX.
+    std::uint32_t kvm_features;
+    //! KVM hints in leaf @c base_leaf + 1 @c EDX.
+    std::uint32_t kvm_hints;
+    //! TSC frequency in Hz reported by the timing leaf or zero.
+    std::uint64_t tsc_frequency;
+    //! Local APIC timer frequency in Hz reported by the timing leaf or zero.
+    std::uint64_t apic_frequency;
+
+    //! Indicates whether a hypervisor was detected.
+    bool virtualized() const noexcept
+    {
+        return vendor != hypervisor_vendor::none;
+    }
+
+    //! Indicates whether KVM reports the paravirtual feature @p f.
+    bool has(kvm_feature f) const noexcept
+    {
+        return vendor == hypervisor_vendor::kvm &&
+            ((kvm_features >> static_cast<unsigned>(f)) & 1U) != 0;
+    }
+
+    /**
+     * @brief Indicates whether KVM guarantees that vCPUs are never preempted.
+     *
+     * Spinning on a lock held by another vCPU is then as cheap as on bare
+     * metal.
+     */
+    bool dedicated_cpus() const noexcept
+    {
+        return vendor == hypervisor_vendor::kvm && (kvm_hints & 1U) != 0;
+    }
+};
+
+/**
+ * @brief Returns the hypervisor the process runs on.
+ *
+ * The leaves are queried once on first use. Only the ranges at 0x40000000 and
+ * 0x40000100 are examined to keep the number of trapped @c CPUID instructions
+ * low. The timing leaf (@c base_leaf + 0x10) is decoded for VMware and KVM.
+ */
+CPUIDPP_EXPORT const hypervisor_info& current_hypervisor();
+
+//! Decodes the hypervisor from the @c CPUID values provided by @p source.
+CPUIDPP_EXPORT hypervisor_info current_hypervisor(const cpuid_source& source);
+
+//! Returns the name of @p vendor, e.g., @c "KVM".
+CPUIDPP_EXPORT const char* to_string(hypervisor_vendor vendor) noexcept;
+
+} // namespace cpuidpp
+
+#endif // !defined(CPUIDPP_HYPERVISOR_HPP)
@@ -0,0 +1,109 @@
+/**
+ * @brief %cpuidpp memory operations tuned to the processor.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef CPUIDPP_MEMOPS_HPP
+#define CPUIDPP_MEMOPS_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include <cpuidpp/cpuidpp.hpp>
+#include <cpuidpp/export.hpp>
+
+namespace cpuidpp {
+
+/**
+ * @brief Strategy of @ref copy() and @ref fill() derived from the string
+ *        instruction features and the last level cache.
+ *
+ * Buffers are processed by the first applicable method:
+ *
+ * 1. Buffers of at least @ref non_temporal_threshold bytes are written using
+ *    non-temporal stores of @ref vector_bytes bytes. Such buffers would evict
+ *    most of the share of the last level cache available to the thread.
+ * 2. Buffers of at least @ref rep_movsb_threshold (@ref rep_stosb_threshold)
+ *    bytes are copied (filled) using @c REP @c MOVSB (@c REP @c STOSB) if
+ *    Enhanced REP MOVSB/STOSB is supported.
+ * 3. All other buffers are processed by @c std::memcpy (@c std::memset).
+ */
+struct memory_strategy
+{
+    //! Indicates whether Enhanced REP MOVSB/STOSB (@c ERMS) is supported.
+    bool erms;
+    //! Indicates whether Fast Short REP MOVSB (@c FSRM) is supported.
+    bool fsrm;
+    //! Indicates whether Fast Zero-Length REP MOVSB (@c FZRM) is supported.
+    bool fzrm;
+    //! Indicates whether Fast Short REP STOSB (@c FSRS) is supported.
+    bool fsrs;
+    //! Indicates whether Fast Short REP CMPSB and REP SCASB (@c FSRC) are supported.
+    bool fsrc;
+    /**
+     * @brief Width of the non-temporal stores in bytes (16, 32 or 64), or zero
+     *        if SSE2 is not supported.
+     */
+    std::size_t vector_bytes;
+    //! Minimum size copied using @c REP @c MOVSB, or zero if @c ERMS is not supported.
+    std::size_t rep_movsb_threshold;
+    //! Minimum size filled using @c REP @c STOSB, or zero if @c ERMS is not supported.
+    std::size_t rep_stosb_threshold;
+    /**
+     * @brief Minimum size written using non-temporal stores.
+     *
+     * The threshold amounts to three quarters of the share of the last level
+     * cache per logical processor sharing it. Non-temporal stores are not used
+     * if @ref vector_bytes is zero in which case the threshold is
+     * @c SIZE_MAX.
+     */
+    std::size_t non_temporal_threshold;
+};
+
+/**
+ * @brief Derives the strategy from the features @p s and the @p caches of a
+ *        processor.
+ *
+ * The @c REP @c MOVSB threshold follows glibc: 2048 bytes for each 16 bytes
+ * of vector width unless @c FSRM makes short copies cheap. Without any cache
+ * information, the last level cache is assumed to hold 1 MiB per logical
+ * processor.
+ */
+CPUIDPP_EXPORT memory_strategy plan_memory_operations(
+    const snapshot& s, const std::vector<cache>& caches) noexcept;
+
+/**
+ * @brief Returns the strategy of the current processor.
+ *
+ * The strategy and the vector kernels of @ref copy() and @ref fill() are
+ * selected once on the first call of any of these functions. The selection
+ * enumerates the caches. Call this function ahead of time to keep it out of
+ * the first copy.
+ */
+CPUIDPP_EXPORT const memory_strategy& memory_operations() noexcept;
+
+/**
+ * @brief Copies @p n bytes from @p src to @p dst according to
+ *        @ref memory_operations().
+ *
+ * As with @c std::memcpy, the buffers must not overlap.
+ *
+ * @return @p dst.
+ */
+CPUIDPP_EXPORT void* copy(void* dst, const void* src, std::size_t n) noexcept;
+
+/**
+ * @brief Sets @p n bytes of @p dst to @p value according to
+ *        @ref memory_operations().
+ *
+ * @return @p dst.
+ */
+CPUIDPP_EXPORT void* fill(void* dst, int value, std::size_t n) noexcept;
+
+} // namespace cpuidpp
+
+#endif // !defined(CPUIDPP_MEMOPS_HPP)
@@ -0,0 +1,215 @@
+/**
+ * @brief %cpuidpp performance monitoring enumeration and region profiler.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef CPUIDPP_PMU_HPP
+#define CPUIDPP_PMU_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cpuidpp/export.hpp>
+
+namespace cpuidpp {
+
+class cpuid_source;
+
+//! Architectural performance monitoring event enumerated by leaf 0xA.
+enum class pmu_event : unsigned
+{
+    core_cycles = 0,                    //!< Unhalted core cycles.
+    instructions_retired = 1,           //!< Instructions retired.
+    reference_cycles = 2,               //!< Unhalted reference cycles.
+    llc_references = 3,                 //!< Last level cache references.
+    llc_misses = 4,                     //!< Last level cache misses.
+    branch_instructions_retired = 5,    //!< Branch instructions retired.
+    branch_misses_retired = 6,          //!< Mispredicted branches retired.
+    topdown_slots = 7                   //!< Top-down microarchitecture analysis slots.
+};
+
+/**
+ * @brief Performance monitoring counters of the processor.
+ *
+ * Intel processors describe the counters in leaf 0xA. AMD processors provide
+ * four legacy counters, six with the core performance counter extensions
+ * (@c PerfCtrExtCore) and report their number in leaf 0x80000022 with
+ * version 2 of the performance monitoring.
+ */
+struct pmu_info
+{
+    //! Version of the architectural performance monitoring, or zero if not supported.
+    unsigned version;
+    //! Number of general-purpose counters per logical processor.
+    unsigned general_counters;
+    //! Width of the general-purpose counters in bits.
+    unsigned general_width;
+    //! Number of fixed-function counters.
+    unsigned fixed_counters;
+    //! Width of the fixed-function counters in bits.
+    unsigned fixed_width;
+    //! Bit @c i is set if the @ref pmu_event with the value @c i is available.
+    std::uint32_t events;
+    //! Indicates whether the AMD core performance counter extensions are supported.
+    bool perfctr_core;
+    //! Indicates whether the AMD northbridge performance counter extensions are supported.
+    bool perfctr_nb;
+
+    //! Indicates whether the architectural @p event is available.
+    bool supports(pmu_event event) const noexcept
+    {
+        return ((events >> static_cast<unsigned>(event)) & 1U) != 0;
+    }
+};
+
+/**
+ * @brief Returns the performance monitoring counters of the processor.
+ *
+ * The leaves are queried once on first use. Hypervisors frequently hide the
+ * counters in which case @ref pmu_info::general_counters is zero.
+ */
+CPUIDPP_EXPORT const pmu_info& pmu_capabilities();
+
+//! Decodes the performance monitoring counters from the @c CPUID values provided by @p source.
+CPUIDPP_EXPORT pmu_info pmu_capabilities(const cpuid_source& source);
+
+//! Generic hardware event counted by a @ref profiler.
+enum class perf_counter
+{
+    cycles,                 //!< Core cycles.
+    instructions,           //!< Instructions retired.
+    cache_references,       //!< Last level cache references.
+    cache_misses,           //!< Last level cache misses.
+    branch_instructions,    //!< Branch instructions retired.
+    branch_misses           //!< Mispredicted branches retired.
+};
+
+//! Accumulated measurements of a code region.
+struct region_statistics
+{
+    //! Name the region was registered with.
+    std::string name;
+    //! Number of completed scopes.
+    std::uint64_t calls;
+    //! Time Stamp Counter ticks spent in the region.
+    std::uint64_t ticks;
+    /**
+     * @brief Events counted in the region in the order of
+     *        @ref profiler::counters().
+     *
+     * The counts are zero if the counters are unavailable.
+     */
+    std::vector<std::uint64_t> counts;
+};
+
+/**
+ * @brief Measures code regions using hardware performance counters read from
+ *        user space.
+ *
+ * Each thread entering a @ref scope for the first time opens its counters
+ * once using @c perf_event_open and maps their control pages. The counters
+ * are then read by @c RDPMC without entering the kernel. If a counter is not
+ * currently scheduled on the processor, its value is obtained using @c read
+ * instead.
+ *
+ * The measurements are accumulated in per-thread buffers which only their
+ * thread writes to. @ref statistics() sums the buffers of all threads without
+ * locking them. Once a thread exits, its counters are closed and its
+ * measurements are merged into those of the other exited threads.
+ *
+ * On platforms other than Linux and if the kernel refuses to open the
+ * counters, e.g., because the hypervisor does not expose them, only the calls
+ * and the Time Stamp Counter ticks are recorded.
+ *
+ * @code
+ * static cpuidpp::profiler p;
+ * static const std::size_t parse = p.region("parse");
+ *
+ * {
+ *     cpuidpp::profiler::scope s{p, parse};
+ *     // ...
+ * }
+ * @endcode
+ */
+class CPUIDPP_EXPORT profiler
+{
+public:
+    //! Maximum number of registered regions.
+    static constexpr std::size_t max_regions = 256;
+    //! Maximum number of counters.
+    static constexpr std::size_t max_counters = 4;
+
+    /**
+     * @brief Measures the given @p counters of which at most
+     *        @ref max_counters are used.
+     */
+    explicit profiler(std::vector<perf_counter> counters =
+        {perf_counter::cycles, perf_counter::instructions,
+         perf_counter::cache_misses});
+
+    ~profiler();
+
+    profiler(const profiler&) = delete;
+    profiler& operator=(const profiler&) = delete;
+
+    //! Returns the measured counters.
+    const std::vector<perf_counter>& counters() const noexcept;
+
+    /**
+     * @brief Registers a region named @p name and returns its identifier.
+     *
+     * @throw std::length_error if @ref max_regions regions are registered.
+     */
+    std::size_t region(const std::string& name);
+
+    /**
+     * @brief Indicates whether the counters of the calling thread are read
+     *        from the hardware.
+     *
+     * Opens the counters of the thread unless it has already done so.
+     */
+    bool available();
+
+    //! Returns the measurements of all regions summed over all threads.
+    std::vector<region_statistics> statistics() const;
+
+    /**
+     * @brief Measures the region from its construction until its
+     *        destruction on the calling thread.
+     *
+     * Scopes may be nested. The profiler must outlive its scopes.
+     *
+     * @throw std::out_of_range if @p region has not been registered.
+     */
+    class CPUIDPP_EXPORT scope
+    {
+    public:
+        scope(profiler& p, std::size_t region);
+        ~scope();
+
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+
+    private:
+        void* state_;
+        std::size_t region_;
+        std::uint64_t ticks_;
+        std::uint64_t counts_[max_counters];
+    };
+
+private:
+    struct impl;
+
+    std::unique_ptr<impl> impl_;
+};
+
+} // namespace cpuidpp
+
+#endif // !defined(CPUIDPP_PMU_HPP)
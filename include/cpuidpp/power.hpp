@@ -0,0 +1,108 @@
+/**
+ * @brief %cpuidpp thermal and power management enumeration.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef CPUIDPP_POWER_HPP
+#define CPUIDPP_POWER_HPP
+
+#include <cpuidpp/export.hpp>
+
+namespace cpuidpp {
+
+class cpuid_source;
+
+/**
+ * @brief Thermal and power management capabilities enumerated by leaf 6 and
+ *        the advanced power management leaf 0x80000007.
+ */
+struct power_info
+{
+    //! Indicates whether a digital temperature sensor is available.
+    bool digital_thermal_sensor;
+    //! Number of interrupt thresholds of the digital temperature sensor.
+    unsigned thermal_thresholds;
+    //! Indicates whether Intel Turbo Boost Technology is available.
+    bool turbo;
+    //! Indicates whether Intel Turbo Boost Max Technology 3.0 favors the fastest cores.
+    bool turbo_max;
+    /**
+     * @brief Indicates whether the APIC timer keeps running in deep C-states
+     *        (@c ARAT).
+     *
+     * Without it, the OS has to fall back to a broadcast timer when a core
+     * enters a deep C-state which adds wake-up latency.
+     */
+    bool arat;
+    //! Indicates whether power limit notifications are supported.
+    bool power_limit_notification;
+    //! Indicates whether package thermal management is supported.
+    bool package_thermal;
+    //! Indicates whether hardware-controlled performance states (@c HWP) are supported.
+    bool hwp;
+    //! Indicates whether @c HWP raises notifications on performance changes.
+    bool hwp_notification;
+    //! Indicates whether the @c HWP activity window can be set.
+    bool hwp_activity_window;
+    /**
+     * @brief Indicates whether the @c HWP energy performance preference
+     *        (@c EPP) can be set.
+     *
+     * The preference trades latency for energy efficiency and is exposed by
+     * Linux as @c energy_performance_preference.
+     */
+    bool hwp_epp;
+    //! Indicates whether @c HWP requests can be issued for the whole package.
+    bool hwp_package_request;
+    //! Indicates whether hardware duty cycling (@c HDC) is supported.
+    bool hdc;
+    //! Indicates whether the hardware feedback interface (@c HFI) is supported.
+    bool hardware_feedback;
+    //! Indicates whether Intel Thread Director is supported.
+    bool thread_director;
+    //! Number of Intel Thread Director classes.
+    unsigned thread_director_classes;
+    /**
+     * @brief Indicates whether the @c APERF and @c MPERF registers allow to
+     *        sample the effective frequency.
+     */
+    bool aperf_mperf;
+    //! Indicates whether the energy performance bias (@c EPB) can be set.
+    bool energy_perf_bias;
+    //! Indicates whether AMD Core Performance Boost is available.
+    bool core_performance_boost;
+    //! Indicates whether the performance states are controlled by the hardware (AMD @c HwPstate).
+    bool hw_pstate;
+    //! Indicates whether the AMD effective frequency registers are read-only.
+    bool eff_freq_read_only;
+    //! Indicates whether AMD processor power reporting is supported.
+    bool power_reporting;
+    //! Indicates whether the Time Stamp Counter runs at a constant rate in all states.
+    bool invariant_tsc;
+
+    //! Indicates whether cores may run above their base frequency.
+    bool boost() const noexcept
+    {
+        return turbo || core_performance_boost;
+    }
+};
+
+/**
+ * @brief Returns the thermal and power management capabilities of the
+ *        processor.
+ *
+ * The leaves are queried once on first use. Hypervisors usually hide most of
+ * the capabilities from their guests.
+ */
+CPUIDPP_EXPORT const power_info& power_capabilities();
+
+//! Decodes the thermal and power management capabilities from the @c CPUID values provided by @p source.
+CPUIDPP_EXPORT power_info power_capabilities(const cpuid_source& source);
+
+} // namespace cpuidpp
+
+#endif // !defined(CPUIDPP_POWER_HPP)
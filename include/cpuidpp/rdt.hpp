@@ -0,0 +1,145 @@
+/**
+ * @brief %cpuidpp Resource Director Technology enumeration.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef CPUIDPP_RDT_HPP
+#define CPUIDPP_RDT_HPP
+
+#include <cstdint>
+
+#include <cpuidpp/export.hpp>
+
+namespace cpuidpp {
+
+class cpuid_source;
+
+/**
+ * @brief Cache monitoring capabilities enumerated by leaf 0xF.
+ *
+ * Monitoring associates the logical processors with resource monitoring IDs
+ * (RMIDs) whose cache occupancy and memory bandwidth are counted.
+ */
+struct rdt_monitoring
+{
+    //! Highest RMID of any resource type.
+    std::uint32_t max_rmid;
+    //! Indicates whether the L3 cache is monitored.
+    bool l3;
+    //! Highest RMID of the L3 cache.
+    std::uint32_t l3_max_rmid;
+    //! Indicates whether the L3 cache occupancy is reported.
+    bool l3_occupancy;
+    //! Indicates whether the total memory bandwidth is reported.
+    bool total_bandwidth;
+    //! Indicates whether the local memory bandwidth is reported.
+    bool local_bandwidth;
+    //! Factor converting the counter values to bytes.
+    std::uint32_t upscaling_factor;
+    //! Width of the counters in bits.
+    unsigned counter_width;
+    //! Indicates whether @c IA32_QM_CTR reports counter overflows.
+    bool overflow_bit;
+};
+
+/**
+ * @brief Cache allocation capabilities of a single cache level enumerated by
+ *        leaf 0x10 subleaf 1 (L3) or 2 (L2).
+ *
+ * Each class of service (COS) limits the ways it may allocate into to a
+ * capacity bitmask (CBM) of @ref ways bits.
+ */
+struct rdt_cache_allocation
+{
+    //! Indicates whether the allocation into the cache can be restricted.
+    bool supported;
+    //! Length of the capacity bitmasks, i.e., the number of allocatable ways.
+    unsigned ways;
+    //! Ways shared with other agents, e.g., I/O devices or the graphics unit.
+    std::uint32_t shared_ways;
+    //! Number of classes of service.
+    unsigned classes;
+    /**
+     * @brief Indicates whether code and data prioritization (CDP) assigns
+     *        separate bitmasks to code and data.
+     *
+     * Enabling CDP halves the number of classes of service.
+     */
+    bool cdp;
+    //! Indicates whether the bitmasks may contain gaps.
+    bool noncontiguous;
+
+    /**
+     * @brief Returns the capacity bitmask of @p count contiguous ways starting
+     *        at the way @p first, or zero if the ways are out of range.
+     */
+    std::uint32_t mask(unsigned first, unsigned count) const noexcept
+    {
+        return count == 0 || first >= ways || count > ways - first
+            ? 0
+            : (count == 32 ? ~std::uint32_t{0}
+                           : (std::uint32_t{1} << count) - 1) << first;
+    }
+};
+
+/**
+ * @brief Memory bandwidth allocation capabilities enumerated by leaf 0x10
+ *        subleaf 3.
+ *
+ * Each class of service delays the requests to memory by a throttling value
+ * in percent.
+ */
+struct rdt_bandwidth_allocation
+{
+    //! Indicates whether the memory bandwidth can be throttled.
+    bool supported;
+    //! Maximum throttling value.
+    unsigned max_throttle;
+    //! Indicates whether the delay is linear in the throttling value.
+    bool linear;
+    /**
+     * @brief Step of the bandwidth percentages accepted by resctrl, or zero
+     *        if the delay is not linear.
+     */
+    unsigned granularity;
+    //! Number of classes of service.
+    unsigned classes;
+};
+
+/**
+ * @brief Resource Director Technology capabilities of the processor.
+ *
+ * The Linux resctrl file system exposes the same capabilities below
+ * @c /sys/fs/resctrl/info. The leaves are decoded only if the processor
+ * reports @ref pqm() or @ref pqe(), respectively.
+ */
+struct rdt_info
+{
+    //! Cache monitoring technology (CMT) and memory bandwidth monitoring (MBM).
+    rdt_monitoring monitoring;
+    //! L3 cache allocation technology (CAT).
+    rdt_cache_allocation l3;
+    //! L2 cache allocation technology (CAT).
+    rdt_cache_allocation l2;
+    //! Memory bandwidth allocation (MBA).
+    rdt_bandwidth_allocation bandwidth;
+};
+
+/**
+ * @brief Returns the Resource Director Technology capabilities of the
+ *        processor.
+ *
+ * The leaves are queried once on first use.
+ */
+CPUIDPP_EXPORT const rdt_info& rdt_capabilities();
+
+//! Decodes the Resource Director Technology capabilities from the @c CPUID values provided by @p source.
+CPUIDPP_EXPORT rdt_info rdt_capabilities(const cpuid_source& source);
+
+} // namespace cpuidpp
+
+#endif // !defined(CPUIDPP_RDT_HPP)
@@ -0,0 +1,137 @@
+/**
+ * @brief %cpuidpp pluggable CPUID sources.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef CPUIDPP_SOURCE_HPP
+#define CPUIDPP_SOURCE_HPP
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <cpuidpp/cpuidpp.hpp>
+#include <cpuidpp/export.hpp>
+
+namespace cpuidpp {
+
+class cpuid_dump;
+
+//! Registers returned by @c CPUID for a single leaf and subleaf.
+struct cpuid_record
+{
+    //! OS index of the logical processor or @ref cpuid_source::any_cpu.
+    std::uint32_t cpu;
+    //! Leaf (@c EAX on input).
+    std::uint32_t leaf;
+    //! Subleaf (@c ECX on input).
+    std::uint32_t subleaf;
+    //! @c EAX, @c EBX, @c ECX and @c EDX on output.
+    std::uint32_t regs[4];
+};
+
+/**
+ * @brief Provides the register values of @c CPUID queries.
+ *
+ * Besides the processor executing the instruction (@ref hardware_cpuid()),
+ * the values can be replayed from a @ref cpuid_dump captured on another
+ * machine. The functions taking a source reproduce the feature flags, caches
+ * and topology of that machine exactly.
+ */
+class CPUIDPP_EXPORT cpuid_source
+{
+public:
+    //! Processor index of queries and records valid for any logical processor.
+    static constexpr std::uint32_t any_cpu = ~std::uint32_t{0};
+
+    virtual ~cpuid_source();
+
+    /**
+     * @brief Returns the registers of @p leaf and @p subleaf in @p regs.
+     *
+     * @param cpu OS index of the logical processor whose values are requested
+     *        or @ref any_cpu. Sources executing the instruction ignore the
+     *        index and expect the calling thread to be pinned accordingly.
+     * @param leaf Leaf (@c EAX on input).
+     * @param subleaf Subleaf (@c ECX on input).
+     * @param regs @c EAX, @c EBX, @c ECX and @c EDX on output. Leaves unknown
+     *        to the source read as zero.
+     */
+    virtual void query(std::uint32_t cpu, std::uint32_t leaf,
+                       std::uint32_t subleaf,
+                       std::uint32_t (&regs)[4]) const = 0;
+
+    //! Returns the @c XCR0 register (zero unless @c OSXSAVE is set).
+    virtual std::uint64_t xcr0() const = 0;
+
+    /**
+     * @brief Returns the OS indices of the logical processors whose topology
+     *        leaves the source provides.
+     *
+     * An empty list denotes the current machine. Its topology is enumerated by
+     * pinning a thread to each logical processor which queries the source
+     * with the index of that processor.
+     */
+    virtual std::vector<std::uint32_t> cpus() const = 0;
+};
+
+//! Returns the source executing the @c CPUID instruction on the calling thread.
+CPUIDPP_EXPORT const cpuid_source& hardware_cpuid() noexcept;
+
+/**
+ * @brief Source forwarding to another source while recording every query.
+ *
+ * Wrapping @ref hardware_cpuid() captures exactly the leaves the library uses:
+ *
+ * @code
+ * cpuidpp::cpuid_recorder recorder{cpuidpp::hardware_cpuid()};
+ * cpuidpp::snapshot s;
+ * cpuidpp::detect(s, recorder);
+ * cpuidpp::cache_info(recorder);
+ * cpuidpp::cpu_topology(recorder);
+ * recorder.dump().save("host.cpuid");
+ * @endcode
+ */
+class CPUIDPP_EXPORT cpuid_recorder : public cpuid_source
+{
+public:
+    //! Records the queries forwarded to @p source.
+    explicit cpuid_recorder(const cpuid_source& source);
+
+    void query(std::uint32_t cpu, std::uint32_t leaf, std::uint32_t subleaf,
+               std::uint32_t (&regs)[4]) const override;
+    std::uint64_t xcr0() const override;
+    std::vector<std::uint32_t> cpus() const override;
+
+    /**
+     * @brief Returns the distinct queries recorded so far.
+     *
+     * Requires @c <cpuidpp/dump.hpp>.
+     */
+    cpuid_dump dump() const;
+
+private:
+    const cpuid_source& source_;
+    mutable std::mutex mutex_;
+    mutable std::vector<cpuid_record> records_;
+};
+
+/**
+ * @brief Fills @p s from the @c CPUID values provided by @p source.
+ *
+ * Unlike @ref detect(snapshot&), the function forwards to @p source and
+ * therefore gives the guarantees of its @ref cpuid_source::query() only,
+ * e.g., a @ref cpuid_recorder allocates and may throw.
+ */
+CPUIDPP_EXPORT void detect(snapshot& s, const cpuid_source& source);
+
+//! Decodes the caches from the @c CPUID values provided by @p source.
+CPUIDPP_EXPORT std::vector<cache> cache_info(const cpuid_source& source);
+
+} // namespace cpuidpp
+
+#endif // !defined(CPUIDPP_SOURCE_HPP)
@@ -0,0 +1,87 @@
+/**
+ * @brief %cpuidpp instrumentation of CPUID executions.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef CPUIDPP_STATISTICS_HPP
+#define CPUIDPP_STATISTICS_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <cpuidpp/export.hpp>
+
+namespace cpuidpp {
+
+//! Executions of a single @c CPUID leaf by the library.
+struct leaf_statistics
+{
+    /**
+     * @brief Leaf (@c EAX on input).
+     *
+     * Leaves outside the basic (0 to 0xFF), hypervisor (0x40000000 to
+     * 0x400001FF) and extended (0x80000000 to 0x800000FF) ranges are
+     * accumulated under @c 0xFFFFFFFF.
+     */
+    std::uint32_t leaf;
+    //! Number of executions over all subleaves.
+    std::uint64_t executions;
+    //! Time Stamp Counter ticks spent in all executions.
+    std::uint64_t total_cycles;
+    //! Time Stamp Counter ticks of the slowest execution.
+    std::uint64_t max_cycles;
+};
+
+/**
+ * @brief Function invoked after each @c CPUID execution with the leaf,
+ *        subleaf and the Time Stamp Counter ticks the execution took.
+ *
+ * The function may be invoked concurrently from several threads.
+ */
+using cpuid_hook = void (*)(std::uint32_t leaf, std::uint32_t subleaf,
+                            std::uint64_t cycles);
+
+/**
+ * @brief Enables or disables counting the @c CPUID instructions the library
+ *        executes.
+ *
+ * Counting is disabled by default. Setting the environment variable
+ * @c CPUIDPP_STATISTICS to a non-empty value enables it before the library
+ * detects the processor features during static initialization. Queries
+ * answered from a dump are not counted since they do not execute @c CPUID.
+ *
+ * The counters are updated using relaxed atomic operations and enclose each
+ * instruction in two @c RDTSC reads. Under virtualization, both are
+ * negligible compared to the trapped instruction.
+ */
+CPUIDPP_EXPORT void enable_cpuid_statistics(bool enable) noexcept;
+
+//! Indicates whether the @c CPUID executions are counted.
+CPUIDPP_EXPORT bool cpuid_statistics_enabled() noexcept;
+
+//! Returns the statistics of the leaves executed at least once by leaf.
+CPUIDPP_EXPORT std::vector<leaf_statistics> cpuid_statistics();
+
+//! Resets all counters to zero.
+CPUIDPP_EXPORT void reset_cpuid_statistics() noexcept;
+
+/**
+ * @brief Installs @p hook to be invoked after each @c CPUID execution, or
+ *        removes it if @p hook is @c nullptr.
+ *
+ * The hook is invoked regardless of whether the statistics are enabled and
+ * allows to, e.g., log a stack trace of unexpected executions on a hot path.
+ *
+ * The hook runs on the thread executing @c CPUID, including from @c
+ * cpuidpp::detect. That function remains async-signal-safe and usable from
+ * an @c ifunc resolver only if the hook is as well.
+ */
+CPUIDPP_EXPORT void set_cpuid_hook(cpuid_hook hook) noexcept;
+
+} // namespace cpuidpp
+
+#endif // !defined(CPUIDPP_STATISTICS_HPP)
@@ -0,0 +1,332 @@
+/**
+ * @brief %cpuidpp processor topology.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef CPUIDPP_TOPOLOGY_HPP
+#define CPUIDPP_TOPOLOGY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <cpuidpp/export.hpp>
+
+namespace cpuidpp {
+
+class cpuid_source;
+
+/**
+ * @brief Set of logical processors identified by their OS indices.
+ *
+ * Bit @c i of @ref words()[w] corresponds to the logical processor with the OS
+ * index <tt>w * 64 + i</tt> which allows to build affinity masks of the
+ * operating system directly.
+ */
+class cpu_set
+{
+public:
+    //! Adds the logical processor @p cpu.
+    void insert(unsigned cpu)
+    {
+        const std::size_t word = cpu / 64U;
+
+        if (word >= words_.size()) {
+            words_.resize(word + 1);
+        }
+
+        words_[word] |= std::uint64_t{1} << (cpu % 64U);
+    }
+
+    //! Removes the logical processor @p cpu.
+    void erase(unsigned cpu)
+    {
+        const std::size_t word = cpu / 64U;
+
+        if (word < words_.size()) {
+            words_[word] &= ~(std::uint64_t{1} << (cpu % 64U));
+            trim();
+        }
+    }
+
+    //! Indicates whether the set contains the logical processor @p cpu.
+    bool contains(unsigned cpu) const noexcept
+    {
+        const std::size_t word = cpu / 64U;
+
+        return word < words_.size() &&
+            ((words_[word] >> (cpu % 64U)) & 1U) != 0;
+    }
+
+    //! Returns the number of logical processors in the set.
+    std::size_t size() const noexcept
+    {
+        std::size_t count = 0;
+
+        for (std::uint64_t word : words_) {
+            for (; word != 0; word &= word - 1) {
+                ++count;
+            }
+        }
+
+        return count;
+    }
+
+    //! Indicates whether the set is empty.
+    bool empty() const noexcept
+    {
+        return words_.empty();
+    }
+
+    //! Returns the OS indices of the logical processors in ascending order.
+    std::vector<unsigned> to_vector() const
+    {
+        std::vector<unsigned> result;
+        result.reserve(size());
+
+        for (std::size_t w = 0; w != words_.size(); ++w) {
+            for (unsigned i = 0; i != 64; ++i) {
+                if (((words_[w] >> i) & 1U) != 0) {
+                    result.push_back(static_cast<unsigned>(w * 64U + i));
+                }
+            }
+        }
+
+        return result;
+    }
+
+    //! Returns the underlying 64-bit mask words.
+    const std::vector<std::uint64_t>& words() const noexcept
+    {
+        return words_;
+    }
+
+    //! Adds the logical processors of @p other.
+    cpu_set& operator|=(const cpu_set& other)
+    {
+        if (other.words_.size() > words_.size()) {
+            words_.resize(other.words_.size());
+        }
+
+        for (std::size_t w = 0; w != other.words_.size(); ++w) {
+            words_[w] |= other.words_[w];
+        }
+
+        return *this;
+    }
+
+    //! Keeps only the logical processors also contained in @p other.
+    cpu_set& operator&=(const cpu_set& other)
+    {
+        if (words_.size() > other.words_.size()) {
+            words_.resize(other.words_.size());
+        }
+
+        for (std::size_t w = 0; w != words_.size(); ++w) {
+            words_[w] &= other.words_[w];
+        }
+
+        trim();
+
+        return *this;
+    }
+
+    //! Indicates whether both sets contain the same logical processors.
+    friend bool operator==(const cpu_set& lhs, const cpu_set& rhs) noexcept
+    {
+        return lhs.words_ == rhs.words_;
+    }
+
+    //! Indicates whether the sets differ.
+    friend bool operator!=(const cpu_set& lhs, const cpu_set& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+private:
+    //! Removes trailing empty words to keep the representation canonical.
+    void trim()
+    {
+        while (!words_.empty() && words_.back() == 0) {
+            words_.pop_back();
+        }
+    }
+
+    std::vector<std::uint64_t> words_;
+};
+
+//! Type of a core in a hybrid processor.
+enum class core_type : std::uint8_t
+{
+    unknown = 0,            //!< Not a hybrid processor or not reported.
+    efficiency = 0x20,      //!< Efficiency core (Intel Atom).
+    performance = 0x40      //!< Performance core (Intel Core).
+};
+
+/**
+ * @brief Topology of a single logical processor.
+ *
+ * The identifiers are derived from the x2APIC ID and are unique across the
+ * system, e.g., two logical processors are SMT siblings if they share the same
+ * @ref core. Topology levels the processor does not report collapse onto the
+ * next enclosing level.
+ */
+struct logical_cpu
+{
+    //! OS index of the logical processor.
+    std::uint32_t index;
+    //! x2APIC ID (or the initial APIC ID on processors without x2APIC).
+    std::uint32_t apic_id;
+    //! Index of the hardware thread within its core.
+    std::uint32_t smt;
+    //! Identifier of the physical core.
+    std::uint32_t core;
+    //! Identifier of the module (core cluster).
+    std::uint32_t module;
+    /**
+     * @brief Identifier of the last level cache domain, e.g., the core
+     *        complex (CCX) of an AMD processor.
+     *
+     * Derived from the number of logical processors sharing the last level
+     * cache in leaf 4 or 0x8000001D. Equals @ref package if the processor
+     * does not enumerate its caches.
+     */
+    std::uint32_t llc;
+    //! Identifier of the die (the node on AMD processors).
+    std::uint32_t die;
+    //! Identifier of the package (socket).
+    std::uint32_t package;
+    //! Native model ID of the core (zero unless the processor is hybrid).
+    std::uint32_t native_model;
+    //! Type of the core the logical processor belongs to.
+    core_type type;
+};
+
+//! Order in which @ref topology::place() assigns logical processors.
+enum class placement
+{
+    /**
+     * @brief Keeps the workers within as few last level cache domains as
+     *        possible, preferably a single one, to share data cheaply.
+     */
+    compact,
+    /**
+     * @brief Distributes the workers across the packages first and across the
+     *        last level cache domains of each package next to maximize the
+     *        available cache and memory bandwidth.
+     */
+    spread
+};
+
+/**
+ * @brief Immutable topology of the logical processors the process may run on.
+ */
+class CPUIDPP_EXPORT topology
+{
+public:
+    //! Creates the topology from the logical processors sorted by OS index.
+    explicit topology(std::vector<logical_cpu> cpus);
+
+    //! Returns the logical processors sorted by OS index.
+    const std::vector<logical_cpu>& cpus() const noexcept;
+
+    /**
+     * @brief Returns the logical processor with the OS index @p index or
+     *        @c nullptr if it is not part of the topology.
+     */
+    const logical_cpu* find(unsigned index) const noexcept;
+
+    //! Returns the number of physical cores.
+    std::size_t cores() const noexcept;
+
+    //! Returns the number of packages.
+    std::size_t packages() const noexcept;
+
+    //! Returns all logical processors.
+    cpu_set all() const;
+
+    /**
+     * @brief Returns one logical processor per physical core, namely the one
+     *        with the lowest SMT index.
+     */
+    cpu_set one_per_core() const;
+
+    //! Returns the logical processors sharing the core of @p index.
+    cpu_set siblings(unsigned index) const;
+
+    //! Returns the logical processors of the package @p package.
+    cpu_set package(std::uint32_t package) const;
+
+    /**
+     * @brief Returns the logical processors sharing each last level cache
+     *        ordered by package.
+     */
+    std::vector<cpu_set> cache_domains() const;
+
+    /**
+     * @brief Assigns a logical processor to each of the @p workers.
+     *
+     * Within a last level cache domain, each physical core receives a worker
+     * before its SMT siblings do. Compact placement starts with the first
+     * domain large enough to hold all workers. If there are more workers than
+     * logical processors, the assignment wraps around.
+     *
+     * @param one_per_core Assign only the first logical processor of each
+     *        physical core.
+     *
+     * @return For each worker the affinity mask containing its logical
+     *         processor, or no masks at all if the topology is empty.
+     */
+    std::vector<cpu_set> place(std::size_t workers, placement policy,
+                               bool one_per_core = false) const;
+
+    //! Indicates whether the logical processors have different core types.
+    bool hybrid() const noexcept;
+
+    //! Returns the logical processors whose core is of the given @p type.
+    cpu_set cpus_of_type(core_type type) const;
+
+    /**
+     * @brief Returns the logical processors suitable for latency-critical
+     *        threads.
+     *
+     * These are the performance cores of a hybrid processor and all logical
+     * processors otherwise.
+     */
+    cpu_set performance_cpus() const;
+
+private:
+    std::vector<logical_cpu> cpus_;
+    std::size_t cores_;
+    std::size_t packages_;
+    bool hybrid_;
+};
+
+/**
+ * @brief Returns the topology of the logical processors.
+ *
+ * On first use, a short-lived thread is pinned to each logical processor the
+ * process may run on and executes the topology leaves (0x1F, 0xB, on AMD
+ * 0x8000001E and on hybrid processors 0x1A) in parallel. On platforms that do
+ * not support pinning threads the topology contains the calling logical
+ * processor only. The topology of a dump named by the @c CPUIDPP_REPLAY
+ * environment variable is replayed instead.
+ */
+CPUIDPP_EXPORT const topology& cpu_topology();
+
+/**
+ * @brief Returns the topology described by the @c CPUID values of @p source.
+ *
+ * The topology leaves are queried for each logical processor listed by the
+ * source. A dump captured by @ref cpuid_dump::capture_all_cpus() reproduces
+ * the topology of the captured machine.
+ */
+CPUIDPP_EXPORT topology cpu_topology(const cpuid_source& source);
+
+} // namespace cpuidpp
+
+#endif // !defined(CPUIDPP_TOPOLOGY_HPP)
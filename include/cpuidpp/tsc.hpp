@@ -0,0 +1,201 @@
+/**
+ * @brief %cpuidpp Time Stamp Counter clock.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef CPUIDPP_TSC_HPP
+#define CPUIDPP_TSC_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif // defined(_MSC_VER)
+
+#include <cpuidpp/cpuidpp.hpp>
+#include <cpuidpp/export.hpp>
+
+namespace cpuidpp {
+
+//! Origin of the Time Stamp Counter frequency.
+enum class frequency_source
+{
+    cpuid,          //!< Leaf 0x15 or 0x16.
+    hypervisor,     //!< Timing leaf of VMware or KVM.
+    calibration     //!< Measured against @c std::chrono::steady_clock.
+};
+
+/**
+ * @brief Returns the Time Stamp Counter frequency in Hz.
+ *
+ * The frequency is obtained from the crystal clock ratio in leaf 0x15, the
+ * processor base frequency in leaf 0x16 or the timing leaf of the hypervisor.
+ * If none of them is available, the frequency is calibrated once over a few
+ * milliseconds.
+ *
+ * The Time Stamp Counter is a reliable time source only if @ref
+ * invariant_tsc() holds.
+ */
+CPUIDPP_EXPORT std::uint64_t tsc_frequency();
+
+//! Returns where @ref tsc_frequency() was obtained from.
+CPUIDPP_EXPORT frequency_source tsc_frequency_source();
+
+namespace detail {
+
+/**
+ * @brief Fixed-point factor converting Time Stamp Counter ticks to
+ *        nanoseconds, or zero until it has been computed.
+ *
+ * The conversion computes <tt>(ticks * multiplier) >> shift</tt> with @c
+ * multiplier fitting into 32 bits which allows to evaluate the product
+ * without overflow using 64-bit arithmetic only. Bits 63-32 store the @c
+ * multiplier, bits 6-1 the @c shift and bit 0 is set once the factor is
+ * computed. Packing both into a single word allows to read them using a
+ * plain load without a static initialization guard.
+ */
+CPUIDPP_EXPORT extern std::atomic<std::uint64_t> tsc_to_nanoseconds;
+
+//! Computes @ref tsc_to_nanoseconds unless already done and returns it.
+CPUIDPP_EXPORT std::uint64_t init_tsc_to_nanoseconds() noexcept;
+
+} // namespace detail
+
+/**
+ * @brief Clock reading the Time Stamp Counter.
+ *
+ * The clock satisfies the @c Clock requirements of @c <chrono>. Reading it
+ * amounts to a @c RDTSC instruction and a fixed-point multiplication by a
+ * precomputed factor.
+ *
+ * The factor is computed by @ref init() or otherwise by the first conversion.
+ * Since this can take a few milliseconds if the frequency has to be
+ * calibrated, call @ref init() before timing anything.
+ */
+class CPUIDPP_EXPORT tsc_clock
+{
+public:
+    using rep = std::int64_t;
+    using period = std::nano;
+    using duration = std::chrono::nanoseconds;
+    using time_point = std::chrono::time_point<tsc_clock>;
+
+    /**
+     * @brief The Time Stamp Counter ticks at a constant rate if it is
+     *        invariant.
+     *
+     * The @c Clock requirements demand a constant expression which cannot
+     * depend on the processor. The value therefore describes the processors
+     * the clock is meant for, i.e., those with an invariant Time Stamp Counter
+     * which includes all x86-64 processors of the last decade. Use @ref
+     * steady() to check the current one.
+     */
+    static constexpr bool is_steady = true;
+
+    //! Indicates whether the clock is steady on the current processor.
+    static bool steady() noexcept
+    {
+        return features().invariant_tsc();
+    }
+
+    /**
+     * @brief Computes the conversion factor unless already done.
+     *
+     * Calling the function ahead of the first measurement keeps a possible
+     * frequency calibration out of it.
+     */
+    static void init() noexcept
+    {
+        detail::init_tsc_to_nanoseconds();
+    }
+
+    //! Returns the current time.
+    static time_point now() noexcept
+    {
+        return time_point{to_duration(ticks())};
+    }
+
+    /**
+     * @brief Returns the current time without allowing the surrounding
+     *        instructions to be reordered across the read.
+     */
+    static time_point serialized_now() noexcept
+    {
+        return time_point{to_duration(serialized_ticks())};
+    }
+
+    //! Reads the Time Stamp Counter.
+    static std::uint64_t ticks() noexcept
+    {
+        return __rdtsc();
+    }
+
+    /**
+     * @brief Reads the Time Stamp Counter once all previous instructions have
+     *        completed and before any subsequent instruction begins.
+     *
+     * Uses @c RDTSCP followed by @c LFENCE if available and @c RDTSC enclosed
+     * in @c LFENCE otherwise.
+     */
+    static std::uint64_t serialized_ticks() noexcept
+    {
+        std::uint64_t value;
+
+        if (features().rdtscp()) {
+            unsigned aux;
+            value = __rdtscp(&aux);
+            fence();
+        }
+        else {
+            fence();
+            value = __rdtsc();
+            fence();
+        }
+
+        return value;
+    }
+
+    //! Converts Time Stamp Counter @p ticks to nanoseconds.
+    static duration to_duration(std::uint64_t ticks) noexcept
+    {
+        std::uint64_t scale =
+            detail::tsc_to_nanoseconds.load(std::memory_order_relaxed);
+
+        if (scale == 0) {
+            scale = detail::init_tsc_to_nanoseconds();
+        }
+
+        const std::uint64_t multiplier = scale >> 32U;
+        const unsigned shift = static_cast<unsigned>(scale >> 1U) & 0x3fU;
+
+        // Split the product to avoid a 128-bit multiplication. The shift does
+        // not exceed 32 bits.
+        const std::uint64_t high = (ticks >> 32U) * multiplier;
+        const std::uint64_t low = (ticks & 0xffffffffU) * multiplier;
+
+        return duration{static_cast<rep>(
+            (high << (32U - shift)) + (low >> shift))};
+    }
+
+private:
+    static void fence() noexcept
+    {
+#if defined(_MSC_VER)
+        _mm_lfence();
+#else
+        __asm__ __volatile__ ("lfence" ::: "memory");
+#endif // defined(_MSC_VER)
+    }
+};
+
+} // namespace cpuidpp
+
+#endif // !defined(CPUIDPP_TSC_HPP)
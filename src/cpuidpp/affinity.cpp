@@ -0,0 +1,181 @@
+/**
+ * @brief Execution of code on specific logical processors.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "affinity.hpp"
+
+#include <cerrno>
+#include <exception>
+#include <thread>
+
+#if defined(HAVE_SCHED_GETAFFINITY) && defined(HAVE_PTHREAD_SETAFFINITY_NP)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(HAVE_SETTHREADGROUPAFFINITY)
+#include <windows.h>
+#endif
+
+namespace cpuidpp {
+namespace detail {
+
+#if defined(HAVE_SCHED_GETAFFINITY) && defined(HAVE_PTHREAD_SETAFFINITY_NP)
+
+std::vector<unsigned> available_cpus()
+{
+    std::vector<unsigned> cpus;
+
+    // The kernel rejects masks smaller than the number of configured
+    // processors. Grow the mask until it fits.
+    for (int count = CPU_SETSIZE; count <= (1 << 20); count *= 2) {
+        cpu_set_t* const set = CPU_ALLOC(count);
+
+        if (set == nullptr) {
+            break;
+        }
+
+        const std::size_t size = CPU_ALLOC_SIZE(count);
+        CPU_ZERO_S(size, set);
+
+        if (sched_getaffinity(0, size, set) == 0) {
+            for (int i = 0; i < count; ++i) {
+                if (CPU_ISSET_S(i, size, set)) {
+                    cpus.push_back(static_cast<unsigned>(i));
+                }
+            }
+
+            CPU_FREE(set);
+            break;
+        }
+
+        const int error = errno;
+        CPU_FREE(set);
+
+        if (error != EINVAL) {
+            break;
+        }
+    }
+
+    return cpus;
+}
+
+bool pin_current_thread(unsigned cpu)
+{
+    const int count = static_cast<int>(cpu) + 1;
+    cpu_set_t* const set = CPU_ALLOC(count);
+
+    if (set == nullptr) {
+        return false;
+    }
+
+    const std::size_t size = CPU_ALLOC_SIZE(count);
+    CPU_ZERO_S(size, set);
+    CPU_SET_S(cpu, size, set);
+
+    const bool pinned = pthread_setaffinity_np(pthread_self(), size, set) == 0;
+
+    CPU_FREE(set);
+
+    return pinned;
+}
+
+#elif defined(HAVE_SETTHREADGROUPAFFINITY)
+
+std::vector<unsigned> available_cpus()
+{
+    std::vector<unsigned> cpus;
+    const WORD groups = GetActiveProcessorGroupCount();
+
+    for (WORD group = 0; group < groups; ++group) {
+        const DWORD count = GetActiveProcessorCount(group);
+
+        for (DWORD i = 0; i < count; ++i) {
+            cpus.push_back(group * 64U + i);
+        }
+    }
+
+    return cpus;
+}
+
+bool pin_current_thread(unsigned cpu)
+{
+    GROUP_AFFINITY affinity{};
+    affinity.Group = static_cast<WORD>(cpu / 64U);
+    affinity.Mask = static_cast<KAFFINITY>(1) << (cpu % 64U);
+
+    return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0;
+}
+
+#else
+
+std::vector<unsigned> available_cpus()
+{
+    return std::vector<unsigned>{};
+}
+
+bool pin_current_thread(unsigned)
+{
+    return false;
+}
+
+#endif
+
+std::vector<bool> run_on_each(const std::vector<unsigned>& cpus,
+                              const std::function<void(std::size_t)>& fn)
+{
+    // std::vector<bool> cannot be written concurrently
+    std::vector<char> invoked(cpus.size());
+    std::vector<std::exception_ptr> errors(cpus.size());
+    std::vector<std::thread> threads;
+    threads.reserve(cpus.size());
+
+    const auto join = [&threads]
+    {
+        for (std::thread& t : threads) {
+            t.join();
+        }
+    };
+
+    try {
+        for (std::size_t i = 0; i != cpus.size(); ++i) {
+            threads.emplace_back([&cpus, &fn, &invoked, &errors, i]
+            {
+                if (!pin_current_thread(cpus[i])) {
+                    return;
+                }
+
+                // An exception escaping the thread would terminate the
+                // process
+                try {
+                    fn(i);
+                    invoked[i] = 1;
+                }
+                catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            });
+        }
+    }
+    catch (...) {
+        // Destroying a joinable thread terminates the process
+        join();
+        throw;
+    }
+
+    join();
+
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    return std::vector<bool>(invoked.begin(), invoked.end());
+}
+
+} // namespace detail
+} // namespace cpuidpp
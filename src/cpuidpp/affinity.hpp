@@ -0,0 +1,52 @@
+/**
+ * @brief Execution of code on specific logical processors.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef CPUIDPP_SRC_AFFINITY_HPP
+#define CPUIDPP_SRC_AFFINITY_HPP
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace cpuidpp {
+namespace detail {
+
+/**
+ * @brief Returns the OS indices of the logical processors the process is
+ *        allowed to run on in ascending order.
+ *
+ * An empty list is returned if threads cannot be pinned on this platform.
+ */
+std::vector<unsigned> available_cpus();
+
+//! Restricts the calling thread to the logical processor @p cpu.
+bool pin_current_thread(unsigned cpu);
+
+/**
+ * @brief Invokes @p fn for every logical processor in @p cpus.
+ *
+ * Each invocation runs concurrently on a short-lived thread pinned to the
+ * logical processor @c cpus[i] and receives @c i as its argument.
+ *
+ * @return For each logical processor whether @p fn was invoked, i.e., whether
+ *         the thread could be pinned.
+ *
+ * @throw std::system_error if a thread cannot be started. The threads started
+ *        so far are joined first.
+ *
+ * If @p fn throws, the exception of the first such logical processor is
+ * rethrown once all threads have been joined.
+ */
+std::vector<bool> run_on_each(const std::vector<unsigned>& cpus,
+                              const std::function<void(std::size_t)>& fn);
+
+} // namespace detail
+} // namespace cpuidpp
+
+#endif // !defined(CPUIDPP_SRC_AFFINITY_HPP)
@@ -0,0 +1,138 @@
+/**
+ * @brief %cpuidpp Advanced Matrix Extensions enumeration implementation.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <cpuidpp/amx.hpp>
+#include <cpuidpp/cpuidpp.hpp>
+#include <cpuidpp/source.hpp>
+
+#include "cpuid.hpp"
+
+#include <algorithm>
+
+#if defined(HAVE_SYS_ARCH_PRCTL)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif // defined(HAVE_SYS_ARCH_PRCTL)
+
+namespace cpuidpp {
+
+namespace {
+
+//! @c XCR0 state component of the tile registers.
+constexpr unsigned XTileData = 18;
+
+//! Highest palette enumerated regardless of the one leaf 0x1D reports.
+constexpr unsigned MaxPalette = 63;
+
+#if defined(HAVE_SYS_ARCH_PRCTL)
+// Not all C libraries define the arch_prctl codes
+constexpr int ArchGetXcompPerm = 0x1022;
+constexpr int ArchReqXcompPerm = 0x1023;
+#endif // defined(HAVE_SYS_ARCH_PRCTL)
+
+amx_info query_amx(const snapshot& s, const cpuid_source* source)
+{
+    amx_info result{};
+
+    result.tile = s.amx_tile();
+    result.int8 = s.amx_int8();
+    result.bf16 = s.amx_bf16();
+    result.fp16 = s.amx_fp16();
+    result.os_support = s.os_amx();
+
+    if (!result.tile || s.max_leaf < 0x1D) {
+        return result;
+    }
+
+    unsigned info[4] = {};
+
+    // EAX=0xD ECX=18
+    detail::cpuidex(source, info, 0xD, XTileData);
+
+    result.xfd = ((info[2] >> 2U) & 1U) != 0;
+
+    // EAX=0x1D ECX=0
+    detail::cpuidex(source, info, 0x1D, 0);
+
+    // Bound the enumeration in case a hypervisor or a dump reports garbage
+    const unsigned max_palette = std::min(info[0], MaxPalette);
+
+    for (unsigned palette = 1; palette <= max_palette; ++palette) {
+        // EAX=0x1D ECX=palette
+        detail::cpuidex(source, info, 0x1D, palette);
+
+        tile_palette p;
+
+        p.total_tile_bytes = info[0] & 0xffffU;
+        p.bytes_per_tile = info[0] >> 16U;
+        p.bytes_per_row = info[1] & 0xffffU;
+        p.max_names = info[1] >> 16U;
+        p.max_rows = info[2] & 0xffffU;
+
+        result.palettes.push_back(p);
+    }
+
+    if (s.max_leaf >= 0x1E) {
+        // EAX=0x1E ECX=0
+        detail::cpuidex(source, info, 0x1E, 0);
+
+        result.tmul_max_k = info[1] & 0xffU;
+        result.tmul_max_n = (info[1] >> 8U) & 0xffffU;
+    }
+
+    return result;
+}
+
+} // namespace
+
+const amx_info& amx_capabilities()
+{
+    static const amx_info instance =
+        query_amx(features(), detail::active_source());
+    return instance;
+}
+
+amx_info amx_capabilities(const cpuid_source& source)
+{
+    snapshot s;
+    detect(s, source);
+
+    return query_amx(s, &source);
+}
+
+bool request_amx_permission() noexcept
+{
+    const snapshot& s = features();
+
+    if (!s.amx_tile() || !s.os_amx()) {
+        return false;
+    }
+
+#if defined(HAVE_SYS_ARCH_PRCTL)
+    if (::syscall(SYS_arch_prctl, ArchReqXcompPerm, XTileData) != 0) {
+        return false;
+    }
+
+    unsigned long permitted = 0;
+
+    return ::syscall(SYS_arch_prctl, ArchGetXcompPerm, &permitted) == 0 &&
+        ((permitted >> XTileData) & 1U) != 0;
+#else // !defined(HAVE_SYS_ARCH_PRCTL)
+    return true;
+#endif // defined(HAVE_SYS_ARCH_PRCTL)
+}
+
+bool amx_usable()
+{
+    static const bool usable =
+        amx_capabilities().supported() && request_amx_permission();
+    return usable;
+}
+
+} // namespace cpuidpp
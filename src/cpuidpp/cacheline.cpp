@@ -0,0 +1,189 @@
+/**
+ * @brief %cpuidpp cache line sizes implementation.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <cpuidpp/cacheline.hpp>
+#include <cpuidpp/cpuidpp.hpp>
+#include <cpuidpp/source.hpp>
+
+#include "cpuid.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#if defined(HAVE__ALIGNED_MALLOC)
+#include <malloc.h>
+#endif // defined(HAVE__ALIGNED_MALLOC)
+
+namespace cpuidpp {
+
+namespace {
+
+//! Line size assumed if the processor reports none.
+constexpr unsigned DefaultLineSize = 64;
+
+/**
+ * @brief Returns the prefetch granularity encoded by the leaf 2 descriptors.
+ *
+ * Each register whose bit 31 is clear holds four one-byte descriptors. The
+ * lowest byte of @c EAX is the number of times the leaf must be executed
+ * instead.
+ */
+unsigned query_prefetch_size(const snapshot& s, const cpuid_source* source)
+{
+    if (s.max_leaf < 2) {
+        return 0;
+    }
+
+    unsigned result = 0;
+    unsigned info[4] = {};
+
+    // EAX=2
+    detail::cpuid(source, info, 2);
+
+    const unsigned iterations = info[0] & 0xffU;
+
+    for (unsigned i = 0; i != iterations; ++i) {
+        if (i != 0) {
+            detail::cpuid(source, info, 2);
+        }
+
+        for (unsigned r = 0; r != 4; ++r) {
+            if (((info[r] >> 31U) & 1U) != 0) {
+                continue;
+            }
+
+            for (unsigned b = r == 0 ? 1 : 0; b != 4; ++b) {
+                const unsigned descriptor = (info[r] >> (b * 8U)) & 0xffU;
+
+                if (descriptor == 0xF0) {
+                    result = std::max(result, 64U);
+                }
+                else if (descriptor == 0xF1) {
+                    result = std::max(result, 128U);
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+cache_line_info query_cache_lines(const snapshot& s,
+                                  const std::vector<cache>& caches,
+                                  const cpuid_source* source)
+{
+    cache_line_info result{};
+
+    if (s.clfsh()) {
+        unsigned info[4] = {};
+        // EAX=1
+        detail::cpuid(source, info, 1);
+
+        result.clflush_size = ((info[1] >> 8U) & 0xffU) * 8;
+    }
+
+    for (const cache& c : caches) {
+        if (c.level == 1 && c.type != cache_type::instruction) {
+            result.l1d_line_size = c.line_size;
+            break;
+        }
+    }
+
+    result.prefetch_size = query_prefetch_size(s, source);
+
+    result.constructive_interference_size = result.l1d_line_size != 0
+        ? result.l1d_line_size
+        : result.clflush_size != 0 ? result.clflush_size : DefaultLineSize;
+    result.destructive_interference_size =
+        std::max(result.constructive_interference_size, result.prefetch_size);
+
+    return result;
+}
+
+} // namespace
+
+const cache_line_info& cache_lines()
+{
+    static const cache_line_info instance =
+        query_cache_lines(features(), cache_info(), detail::active_source());
+    return instance;
+}
+
+cache_line_info cache_lines(const cpuid_source& source)
+{
+    snapshot s;
+    detect(s, source);
+
+    return query_cache_lines(s, cache_info(source), &source);
+}
+
+void* aligned_allocate(std::size_t size, std::size_t alignment)
+{
+    alignment = std::max(alignment, sizeof(void*));
+
+    if (size == 0) {
+        size = alignment;
+    }
+
+#if defined(HAVE_POSIX_MEMALIGN)
+    void* p = nullptr;
+
+    if (::posix_memalign(&p, alignment, size) != 0) {
+        throw std::bad_alloc{};
+    }
+
+    return p;
+#elif defined(HAVE__ALIGNED_MALLOC)
+    void* const p = ::_aligned_malloc(size, alignment);
+
+    if (p == nullptr) {
+        throw std::bad_alloc{};
+    }
+
+    return p;
+#else // !defined(HAVE_POSIX_MEMALIGN) && !defined(HAVE__ALIGNED_MALLOC)
+    // Over-allocate and store the original pointer right before the aligned
+    // block.
+    if (size > static_cast<std::size_t>(-1) - alignment - sizeof(void*)) {
+        throw std::bad_alloc{};
+    }
+
+    void* const raw = std::malloc(size + alignment + sizeof(void*));
+
+    if (raw == nullptr) {
+        throw std::bad_alloc{};
+    }
+
+    const std::uintptr_t address =
+        (reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*) + alignment -
+         1) & ~static_cast<std::uintptr_t>(alignment - 1);
+    void* const p = reinterpret_cast<void*>(address);
+
+    static_cast<void**>(p)[-1] = raw;
+
+    return p;
+#endif // defined(HAVE_POSIX_MEMALIGN)
+}
+
+void aligned_deallocate(void* p) noexcept
+{
+#if defined(HAVE_POSIX_MEMALIGN)
+    std::free(p);
+#elif defined(HAVE__ALIGNED_MALLOC)
+    ::_aligned_free(p);
+#else // !defined(HAVE_POSIX_MEMALIGN) && !defined(HAVE__ALIGNED_MALLOC)
+    if (p != nullptr) {
+        std::free(static_cast<void**>(p)[-1]);
+    }
+#endif // defined(HAVE_POSIX_MEMALIGN)
+}
+
+} // namespace cpuidpp
@@ -0,0 +1,274 @@
+/**
+ * @brief Raw @c CPUID and @c XGETBV helpers.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef CPUIDPP_SRC_CPUID_HPP
+#define CPUIDPP_SRC_CPUID_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#include <cpuidpp/source.hpp>
+#include <cpuidpp/statistics.hpp>
+
+#if defined(HAVE___GET_CPUID)
+#include <cpuid.h>
+#elif defined(HAVE___CPUID)
+#include <intrin.h>
+#endif
+
+#if defined(HAVE__XGETBV)
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif // defined(_MSC_VER)
+
+namespace cpuidpp {
+namespace detail {
+
+// NOTE The callers check the highest supported leaf themselves. The
+// __get_cpuid family of functions cannot be used for this purpose since it
+// rejects leaves outside the basic and extended ranges, e.g., the hypervisor
+// leaves starting at 0x40000000.
+
+#if defined(HAVE___GET_CPUID)
+inline void invoke_cpuid(unsigned* info, unsigned leaf)
+{
+    __cpuid(leaf, info[0], info[1], info[2], info[3]);
+}
+#elif defined(HAVE___CPUID)
+inline void invoke_cpuid(unsigned* info, unsigned leaf)
+{
+    __cpuid(reinterpret_cast<int*>(info), static_cast<int>(leaf));
+}
+#else
+/**
+ * @brief Implements the CPUID instruction on platforms and compilers that don't
+ *        provide it.
+ *
+ * @param info 4-byte array that will contain the content of the registers @c
+ *        eax, @c ebx, @c ecx and @c edx.
+ * @param leaf Information leaf: @c eax register.
+ */
+inline void invoke_cpuid(unsigned* info, unsigned leaf)
+{
+#if defined(__i386__) && defined(__PIC__)
+    __asm__ (
+        "xchgl %%ebx, %1\n\t"
+        "cpuid\n\t"
+        "xchgl %%ebx, %1\n\t"
+        :
+        "=a" (info[0]),
+        "=r" (info[1]),
+        "=c" (info[2]),
+        "=d" (info[3])
+        :
+        "0" (leaf)
+    );
+#else
+    __asm__ (
+        "cpuid"
+        :
+        "=a" (info[0]),
+        "=b" (info[1]),
+        "=c" (info[2]),
+        "=d" (info[3])
+        :
+        "a" (leaf)
+    );
+#endif // defined(__i386__) && defined(__PIC__)
+}
+#endif
+
+#if defined(HAVE___GET_CPUID_COUNT)
+inline void invoke_cpuidex(unsigned* info, unsigned leaf, unsigned subleaf)
+{
+    __cpuid_count(leaf, subleaf, info[0], info[1], info[2], info[3]);
+}
+#elif defined(HAVE___CPUIDEX)
+inline void invoke_cpuidex(unsigned* info, unsigned leaf, unsigned subleaf)
+{
+    __cpuidex(reinterpret_cast<int*>(info), static_cast<int>(leaf),
+              static_cast<int>(subleaf));
+}
+#else
+inline void invoke_cpuidex(unsigned* info, unsigned leaf, unsigned subleaf)
+{
+    __asm__ (
+        "cpuid"
+        :
+        "=a" (info[0]),
+        "=b" (info[1]),
+        "=c" (info[2]),
+        "=d" (info[3])
+        :
+        "0" (leaf),
+        "2" (subleaf)
+    );
+}
+#endif
+
+//! Indicates whether the executions are counted.
+extern std::atomic<bool> statistics_enabled;
+
+//! Hook invoked after each execution, or @c nullptr.
+extern std::atomic<cpuid_hook> installed_hook;
+
+/**
+ * @brief Indicates whether the executions are measured, i.e., whether the
+ *        statistics are enabled or a hook is installed.
+ *
+ * Both are tested directly rather than through a combined flag which would
+ * need to be updated consistently by concurrent callers.
+ */
+inline bool instrumented() noexcept
+{
+    return statistics_enabled.load(std::memory_order_relaxed) ||
+        installed_hook.load(std::memory_order_relaxed) != nullptr;
+}
+
+//! Accounts an execution of @p leaf which took @p cycles.
+void record_cpuid(unsigned leaf, unsigned subleaf,
+                  std::uint64_t cycles) noexcept;
+
+//! Enables the statistics if the @c CPUIDPP_STATISTICS variable is set.
+void load_environment_statistics() noexcept;
+
+/**
+ * @brief Executes @c CPUID and accounts it if @ref instrumented().
+ *
+ * Executing the instruction is async-signal-safe only as long as the
+ * installed hook, if any, is.
+ */
+inline void execute_cpuidex(unsigned* info, unsigned leaf, unsigned subleaf)
+{
+    if (!instrumented()) {
+        invoke_cpuidex(info, leaf, subleaf);
+        return;
+    }
+
+    const std::uint64_t start = __rdtsc();
+    invoke_cpuidex(info, leaf, subleaf);
+    const std::uint64_t stop = __rdtsc();
+
+    record_cpuid(leaf, subleaf, stop - start);
+}
+
+//! @copydoc execute_cpuidex()
+inline void execute_cpuid(unsigned* info, unsigned leaf)
+{
+    if (!instrumented()) {
+        invoke_cpuid(info, leaf);
+        return;
+    }
+
+    const std::uint64_t start = __rdtsc();
+    invoke_cpuid(info, leaf);
+    const std::uint64_t stop = __rdtsc();
+
+    record_cpuid(leaf, 0, stop - start);
+}
+
+/**
+ * @brief Dump replayed instead of the current processor, or @c nullptr.
+ *
+ * Set once during static initialization if the @c CPUIDPP_REPLAY environment
+ * variable is defined.
+ */
+extern const cpuid_source* replay_source;
+
+/**
+ * @brief Dump of the current processor the @c CPUID queries are answered from
+ *        instead of executing the instruction, or @c nullptr.
+ *
+ * Set once during static initialization if the @c CPUIDPP_DUMP environment
+ * variable is defined.
+ */
+extern const cpuid_source* host_source;
+
+//! Loads the dumps named by the @c CPUIDPP_REPLAY and @c CPUIDPP_DUMP
+//! environment variables.
+void load_environment_dumps();
+
+//! Returns the source feature detection and cache enumeration use.
+inline const cpuid_source* active_source() noexcept
+{
+    return replay_source != nullptr ? replay_source : host_source;
+}
+
+/**
+ * @brief Answers a @c CPUID query from @p source or executes the instruction
+ *        if @p source is @c nullptr.
+ */
+inline void cpuidex(const cpuid_source* source, unsigned* info, unsigned leaf,
+                    unsigned subleaf,
+                    std::uint32_t cpu = cpuid_source::any_cpu)
+{
+    if (source == nullptr) {
+        execute_cpuidex(info, leaf, subleaf);
+    }
+    else {
+        std::uint32_t regs[4];
+        source->query(cpu, leaf, subleaf, regs);
+        std::memcpy(info, regs, sizeof regs);
+    }
+}
+
+inline void cpuid(const cpuid_source* source, unsigned* info, unsigned leaf,
+                  std::uint32_t cpu = cpuid_source::any_cpu)
+{
+    if (source == nullptr) {
+        execute_cpuid(info, leaf);
+    }
+    else {
+        cpuidex(source, info, leaf, 0, cpu);
+    }
+}
+
+#if defined(HAVE__XGETBV)
+inline std::uint64_t xgetbv(unsigned index)
+{
+    return _xgetbv(index);
+}
+#else
+/**
+ * @brief Reads an extended control register.
+ *
+ * The instruction is emitted as raw bytes since the assembler may not know the
+ * @c XGETBV mnemonic and the intrinsic requires the @c XSAVE instruction set
+ * to be enabled at compile time.
+ *
+ * @param index Extended control register: @c ecx register.
+ */
+inline std::uint64_t xgetbv(unsigned index)
+{
+    unsigned eax;
+    unsigned edx;
+
+    __asm__ (
+        ".byte 0x0f, 0x01, 0xd0"
+        :
+        "=a" (eax),
+        "=d" (edx)
+        :
+        "c" (index)
+    );
+
+    return (static_cast<std::uint64_t>(edx) << 32U) | eax;
+}
+#endif
+
+} // namespace detail
+} // namespace cpuidpp
+
+#endif // !defined(CPUIDPP_SRC_CPUID_HPP)
@@ -8,505 +8,419 @@
  */
 
 #include <cpuidpp/cpuidpp.hpp>
+#include <cpuidpp/source.hpp>
 
-#include <algorithm>
-#include <array>
-#include <bitset>
-#include <functional>
-#include <locale>
+#include "cpuid.hpp"
 
-#if defined(HAVE___GET_CPUID)
-#include <cpuid.h>
-#elif defined(HAVE___CPUID)
-#include <intrin.h>
-#endif
+#include <array>
+#include <cstring>
+#include <string>
+#include <vector>
 
 namespace cpuidpp {
 
 namespace {
 
-#if defined(HAVE___GET_CPUID)
-inline void cpuid(unsigned* info, unsigned leaf)
-{
-    __get_cpuid(leaf, info, info + 1, info + 2, info + 3);
-}
-#elif defined(HAVE___CPUID)
-inline void cpuid(unsigned* info, unsigned leaf)
+using detail::cpuid;
+using detail::cpuidex;
+using detail::xgetbv;
+
+//! Indicates whether @p ch is a whitespace character in the "C" locale.
+bool is_space(char ch) noexcept
 {
-    __cpuid(reinterpret_cast<int*>(info), static_cast<int>(leaf));
+    return ch == ' ' || (ch >= '\t' && ch <= '\r');
 }
-#else
+
 /**
- * @brief Implements the CPUID instruction on platforms and compilers that don't
- *        provide it.
- *
- * @param info 4-byte array that will contain the content of the registers @c
- *        eax, @c ebx, @c ecx and @c edx.
- * @param leaf Information leaf: @c eax register.
+ * @brief Reads the processor brand string into @p brand and removes the
+ *        surrounding whitespace in place.
  */
-inline void cpuid(unsigned* info, unsigned leaf)
+void query_brand(const cpuid_source* source, char (&brand)[49]) noexcept
 {
-#if defined(__i386__) && defined(__PIC__)
-    __asm__ (
-        "xchgl %%ebx, %1\n\t"
-        "cpuid\n\t"
-        "xchgl %%ebx, %1\n\t"
-        :
-        "=a" (info[0]),
-        "=r" (info[1]),
-        "=c" (info[2]),
-        "=d" (info[3])
-        :
-        "0" (leaf)
-    );
-#else
-    __asm__ (
-        "cpuid"
-        :
-        "=a" (info[0]),
-        "=b" (info[1]),
-        "=c" (info[2]),
-        "=d" (info[3])
-        :
-        "a" (leaf)
-    );
-#endif // defined(__i386__) && defined(__PIC__)
-}
-#endif
+    unsigned info[4] = {};
 
-#if defined(HAVE___GET_CPUID_COUNT)
-inline void cpuidex(unsigned* info, unsigned leaf, unsigned subleaf)
-{
-    __get_cpuid_count(leaf, subleaf, info, info + 1, info + 2, info + 3);
-}
-#elif defined(HAVE___CPUIDEX)
-inline void cpuidex(unsigned* info, unsigned leaf, unsigned subleaf)
-{
-    __cpuidex(reinterpret_cast<int*>(info), static_cast<int>(leaf),
-            static_cast<int>(subleaf));
-}
-#else
-inline void cpuidex(unsigned* info, unsigned leaf, unsigned subleaf)
-{
-    __asm__ (
-        "cpuid"
-        :
-        "=a" (info[0]),
-        "=b" (info[1]),
-        "=c" (info[2]),
-        "=d" (info[3])
-        :
-        "0" (leaf),
-        "2" (subleaf)
-    );
-}
-#endif
-
-template
-<
-      class T
-    , std::size_t N = sizeof(T)
-    , std::size_t Size = N
->
-struct ExtractChar
-{
-    static void fill(T value, std::string& out)
-    {
-        constexpr std::size_t Index = N - 1;
+    for (unsigned i = 0; i != 3; ++i) {
+        // EAX=0x80000002+i
+        cpuid(source, info, 0x80000002 + i);
+        std::memcpy(brand + i * sizeof info, info, sizeof info);
+    }
 
-        ExtractChar<T, N - 1, Size>::fill(value, out);
+    brand[48] = '\0';
 
-        const auto ch = static_cast<char>((value >> (Index * 8)) & 0xff);
-        out.append(1, ch);
-    }
-};
+    std::size_t last = std::strlen(brand);
 
-template
-<
-      class T
-    , std::size_t Size
->
-struct ExtractChar<T, 0, Size>
-{
-    static void fill(T, std::string&)
-    {
+    while (last != 0 && is_space(brand[last - 1])) {
+        --last;
     }
-};
 
-namespace detail {
+    std::size_t first = 0;
 
-template
-<
-      std::size_t N
-    , std::size_t Counter
-    , std::size_t ...Indexes
->
-struct ExtractCharsFromArray
-{
-    template<class T, std::size_t M>
-    static void fill(const std::array<T, M>& arr, std::string& out)
-    {
-        detail::ExtractCharsFromArray<N, Counter - 1, Indexes...>::fill(arr, out);
+    while (first != last && is_space(brand[first])) {
+        ++first;
     }
-};
 
-template
-<
-      std::size_t N
-    , std::size_t Index
->
-struct ExtractCharsFromArray<N, 0, Index>
+    std::memmove(brand, brand + first, last - first);
+    brand[last - first] = '\0';
+}
+
+/**
+ * @brief Fills @p s from @p source or by executing @c CPUID if @p source is
+ *        @c nullptr.
+ */
+void detect(snapshot& s, const cpuid_source* source)
 {
-    template<class T, std::size_t M>
-    static void fill(const std::array<T, M>& arr, std::string& out)
-    {
-        ExtractChar<T>::fill(arr[Index], out);
+    unsigned info[4] = {};
+
+    s = snapshot{};
+
+    // EAX=0
+    cpuid(source, info, 0);
+
+    s.max_leaf = info[0];
+    std::memcpy(s.vendor_id + 0, info + 1, 4);
+    std::memcpy(s.vendor_id + 4, info + 3, 4);
+    std::memcpy(s.vendor_id + 8, info + 2, 4);
+
+    if (s.max_leaf >= 1) {
+        // EAX=1
+        cpuid(source, info, 1);
+
+        s.words[snapshot::leaf1_ecx] = info[2];
+        s.words[snapshot::leaf1_edx] = info[3];
+
+        // XGETBV faults unless the OS has enabled XSAVE
+        if (source != nullptr) {
+            s.words[snapshot::xcr0] =
+                static_cast<std::uint32_t>(source->xcr0());
+        }
+        else if (s.oxsave()) {
+            s.words[snapshot::xcr0] = static_cast<std::uint32_t>(xgetbv(0));
+        }
     }
-};
 
-template
-<
-      std::size_t N
-    , std::size_t Counter
-    , std::size_t Index
-    , std::size_t ...Indexes
->
-struct ExtractCharsFromArray<N, Counter, Index, Indexes...>
-{
-    template<class T, std::size_t M>
-    static void fill(const std::array<T, M>& arr, std::string& out)
-    {
-        ExtractChar<T>::fill(arr[Index], out);
-        detail::ExtractCharsFromArray<N, Counter - 1, Indexes...>::fill(arr, out);
+    if (s.max_leaf >= 7) {
+        // EAX=7 ECX=0
+        cpuidex(source, info, 7, 0);
+
+        s.words[snapshot::leaf7_ebx] = info[1];
+        s.words[snapshot::leaf7_ecx] = info[2];
+        s.words[snapshot::leaf7_edx] = info[3];
+
+        if (info[0] >= 1) {
+            // EAX=7 ECX=1
+            cpuidex(source, info, 7, 1);
+
+            s.words[snapshot::leaf7_1_eax] = info[0];
+            s.words[snapshot::leaf7_1_edx] = info[3];
+        }
     }
-};
 
-} // namesace detail
+    // Leaf 0x24 is only defined if AVX10 is supported
+    if (s.avx10() && s.max_leaf >= 0x24) {
+        // EAX=0x24 ECX=0
+        cpuidex(source, info, 0x24, 0);
 
-template
-<
-    std::size_t ...Indexes
->
-struct ExtractCharsFromArray
-{
-    template<class T, std::size_t N>
-    static std::string extract(const std::array<T, N>& arr)
-    {
-        std::string result;
-        result.reserve(N * sizeof(T));
+        s.words[snapshot::leaf24_ebx] = info[1];
+    }
+
+    // EAX=0x80000000
+    cpuid(source, info, 0x80000000);
 
-        constexpr std::size_t M = sizeof...(Indexes);
+    s.max_extended_leaf = info[0];
 
-        detail::ExtractCharsFromArray<M, M - 1, Indexes...>::fill(arr, result);
+    if (s.max_extended_leaf >= 0x80000001) {
+        // EAX=0x80000001
+        cpuid(source, info, 0x80000001);
 
-        return result;
+        s.words[snapshot::leaf80000001_ecx] = info[2];
+        s.words[snapshot::leaf80000001_edx] = info[3];
     }
-};
 
-} // namespace
+    if (s.max_extended_leaf >= 0x80000001 &&
+        std::memcmp(s.vendor_id, "AuthenticAMD", 12) == 0) {
+        // AMD reports some of the leaf 1 EDX features in leaf 0x80000001 EDX
+        // only.
+        constexpr std::uint32_t mask_0_9 = ((1U << 9U) - 1U);
+        constexpr std::uint32_t mask_0_17 = ((1U << 17U) - 1U);
+        constexpr std::uint32_t mask_0_12 = ((1U << 12U) - 1U);
+        constexpr std::uint32_t mask_12_17 = mask_0_17 ^ mask_0_12;
+        constexpr std::uint32_t fxsr = 1U << 24U;
+
+        std::uint32_t& f1_3 = s.words[snapshot::leaf1_edx];
+        const std::uint32_t f80000001_3 = s.words[snapshot::leaf80000001_edx];
+
+        f1_3 &= ~mask_0_9;
+        f1_3 |= f80000001_3 & mask_0_9;
+        f1_3 &= ~mask_12_17;
+        f1_3 |= f80000001_3 & mask_12_17;
+        f1_3 &= ~fxsr;
+        f1_3 |= f80000001_3 & fxsr;
+    }
 
-#define CPUIDPP_IMPL_FLAG(name, bit, member) \
-    bool name() const                        \
-    {                                        \
-        return member.test(bit);             \
+    if (s.max_extended_leaf >= 0x80000004) {
+        query_brand(source, s.brand);
     }
 
-struct CPUIDImpl
-{
-    CPUIDImpl()
-    {
-        std::array<unsigned, 4> info{};
+    if (s.max_extended_leaf >= 0x80000007) {
+        // EAX=0x80000007
+        cpuid(source, info, 0x80000007);
 
-        // EAX=1
-        cpuid(info.data(), 1);
+        s.words[snapshot::leaf80000007_edx] = info[3];
+    }
+}
+
+//! Highest subleaf enumerated in case a source never reports the last cache.
+constexpr unsigned MaxSubleaf = 63;
 
-        f1_2 = info[2];
-        f1_3 = info[3];
+//! Decodes the caches enumerated by the subleaves of @p leaf.
+void query_deterministic_caches(const cpuid_source* source, unsigned leaf,
+                                std::vector<cache>& caches)
+{
+    std::array<unsigned, 4> info{};
 
+    for (unsigned subleaf = 0; subleaf <= MaxSubleaf; ++subleaf) {
         info.fill(0);
-        // EAX=7 ECX=0
-        cpuidex(info.data(), 7, 0);
+        // EAX=leaf ECX=subleaf
+        cpuidex(source, info.data(), leaf, subleaf);
 
-        f7_1 = info[1];
-        f7_2 = info[2];
-        f7_3 = info[3];
+        const unsigned type = info[0] & 0x1fU;
 
-        info.fill(0);
-        // EAX=0x80000000
-        cpuid(info.data(), 0x80000000);
+        // No more caches
+        if (type == 0) {
+            break;
+        }
 
-        max_leaf = static_cast<unsigned>(info[0]);
+        cache c{};
+
+        c.type = static_cast<cache_type>(type);
+        c.level = (info[0] >> 5U) & 0x7U;
+        c.fully_associative = ((info[0] >> 9U) & 1U) != 0;
+        c.shared_by = ((info[0] >> 14U) & 0xfffU) + 1;
+        c.line_size = (info[1] & 0xfffU) + 1;
+        c.partitions = ((info[1] >> 12U) & 0x3ffU) + 1;
+        c.ways = ((info[1] >> 22U) & 0x3ffU) + 1;
+        c.sets = info[2] + 1;
+        c.inclusive = ((info[3] >> 1U) & 1U) != 0;
+        c.size = static_cast<std::size_t>(c.ways) * c.partitions *
+            c.line_size * c.sets;
+
+        caches.push_back(c);
+    }
+}
+
+//! Completes a cache decoded from a legacy descriptor unless it is absent.
+void add_legacy_cache(std::vector<cache>& caches, cache c)
+{
+    if (c.size == 0 || c.ways == 0 || c.line_size == 0) {
+        return;
+    }
 
-        if (max_leaf >= 0x80000001 && query_vendor() == "AuthenticAMD") {
-            info.fill(0);
-            // EAX=0x80000001
-            cpuid(info.data(), 0x80000001);
+    if (c.fully_associative) {
+        c.ways = static_cast<unsigned>(c.size / c.line_size);
+    }
 
-            f80000001_2 = info[2];
-            f80000001_3 = info[3];
+    c.partitions = 1;
+    c.sets = static_cast<unsigned>(
+        c.size / (static_cast<std::size_t>(c.ways) * c.line_size));
 
-            constexpr unsigned mask_0_9 = ((1U << 9U) - 1U);
-            constexpr unsigned mask_0_17 = ((1U << 17U) - 1U);
-            constexpr unsigned mask_0_12 = ((1U << 12U) - 1U);
-            constexpr unsigned mask_12_17 = mask_0_17 ^ mask_0_12;
+    caches.push_back(c);
+}
 
-            f1_3 &= ~mask_0_9;
-            f1_3 |= f80000001_3.to_ulong() & mask_0_9;
-            f1_3 &= ~mask_12_17;
-            f1_3 |= f80000001_3.to_ulong() & mask_12_17;
-            f1_3[24] = f80000001_3[24]; // fxr
-        }
+//! Decodes the legacy AMD cache descriptors.
+void query_legacy_caches(const snapshot& s, const cpuid_source* source,
+                         std::vector<cache>& caches)
+{
+    if (s.max_extended_leaf < 0x80000005) {
+        return;
     }
 
-    CPUIDPP_IMPL_FLAG(fpu,              0, f1_3)
-    CPUIDPP_IMPL_FLAG(vme,              1, f1_3)
-    CPUIDPP_IMPL_FLAG(de,               2, f1_3)
-    CPUIDPP_IMPL_FLAG(pse,              3, f1_3)
-    CPUIDPP_IMPL_FLAG(tsc,              4, f1_3)
-    CPUIDPP_IMPL_FLAG(msr,              5, f1_3)
-    CPUIDPP_IMPL_FLAG(pae,              6, f1_3)
-    CPUIDPP_IMPL_FLAG(mce,              7, f1_3)
-    CPUIDPP_IMPL_FLAG(cx8,              8, f1_3)
-    CPUIDPP_IMPL_FLAG(apic,             9, f1_3)
-    CPUIDPP_IMPL_FLAG(sep,              11, f1_3)
-    CPUIDPP_IMPL_FLAG(mtrr,             12, f1_3)
-    CPUIDPP_IMPL_FLAG(pge,              13, f1_3)
-    CPUIDPP_IMPL_FLAG(mca,              14, f1_3)
-    CPUIDPP_IMPL_FLAG(cmov,             15, f1_3)
-    CPUIDPP_IMPL_FLAG(pat,              16, f1_3)
-    CPUIDPP_IMPL_FLAG(pse36,            17, f1_3)
-    CPUIDPP_IMPL_FLAG(psn,              18, f1_3)
-    CPUIDPP_IMPL_FLAG(clfsh,            19, f1_3)
-    CPUIDPP_IMPL_FLAG(ds,               21, f1_3)
-    CPUIDPP_IMPL_FLAG(acpi,             22, f1_3)
-    CPUIDPP_IMPL_FLAG(mmx,              23, f1_3)
-    CPUIDPP_IMPL_FLAG(fxsr,             24, f1_3)
-    CPUIDPP_IMPL_FLAG(sse,              25, f1_3)
-    CPUIDPP_IMPL_FLAG(sse2,             26, f1_3)
-    CPUIDPP_IMPL_FLAG(ss,               27, f1_3)
-    CPUIDPP_IMPL_FLAG(htt,              28, f1_3)
-    CPUIDPP_IMPL_FLAG(tm,               29, f1_3)
-    CPUIDPP_IMPL_FLAG(ia64,             30, f1_3)
-    CPUIDPP_IMPL_FLAG(pbe,              31, f1_3)
-
-    CPUIDPP_IMPL_FLAG(sse3,             0, f1_2)
-    CPUIDPP_IMPL_FLAG(pclmulqdq,        1, f1_2)
-    CPUIDPP_IMPL_FLAG(dtes64,           2, f1_2)
-    CPUIDPP_IMPL_FLAG(monitor,          3, f1_2)
-    CPUIDPP_IMPL_FLAG(ds_cpl,           4, f1_2)
-    CPUIDPP_IMPL_FLAG(vmx,              5, f1_2)
-    CPUIDPP_IMPL_FLAG(smx,              6, f1_2)
-    CPUIDPP_IMPL_FLAG(eist,             7, f1_2)
-    CPUIDPP_IMPL_FLAG(tm2,              8, f1_2)
-    CPUIDPP_IMPL_FLAG(ssse3,            9, f1_2)
-    CPUIDPP_IMPL_FLAG(cnxt_id,          10, f1_2)
-    CPUIDPP_IMPL_FLAG(sdbg,             11, f1_2)
-    CPUIDPP_IMPL_FLAG(fma,              12, f1_2)
-    CPUIDPP_IMPL_FLAG(cx16,             13, f1_2)
-    CPUIDPP_IMPL_FLAG(xtpr,             14, f1_2)
-    CPUIDPP_IMPL_FLAG(pdcm,             15, f1_2)
-
-    CPUIDPP_IMPL_FLAG(pcid,             17, f1_2)
-    CPUIDPP_IMPL_FLAG(dca,              18, f1_2)
-    CPUIDPP_IMPL_FLAG(sse4_1,           19, f1_2)
-    CPUIDPP_IMPL_FLAG(sse4_2,           20, f1_2)
-    CPUIDPP_IMPL_FLAG(x2apic,           21, f1_2)
-    CPUIDPP_IMPL_FLAG(movbe,            22, f1_2)
-    CPUIDPP_IMPL_FLAG(popcnt,           23, f1_2)
-    CPUIDPP_IMPL_FLAG(tsc_deadline,     24, f1_2)
-    CPUIDPP_IMPL_FLAG(aes,              25, f1_2)
-    CPUIDPP_IMPL_FLAG(xsave,            26, f1_2)
-    CPUIDPP_IMPL_FLAG(oxsave,           27, f1_2)
-    CPUIDPP_IMPL_FLAG(avx,              28, f1_2)
-    CPUIDPP_IMPL_FLAG(f16c,             29, f1_2)
-    CPUIDPP_IMPL_FLAG(rdrnd,            30, f1_2)
-    CPUIDPP_IMPL_FLAG(hypervisor,       31, f1_2)
-
-    CPUIDPP_IMPL_FLAG(fsgsbase,         0, f7_1)
-
-    CPUIDPP_IMPL_FLAG(sgx,              2, f7_1)
-    CPUIDPP_IMPL_FLAG(bmi1,             3, f7_1)
-    CPUIDPP_IMPL_FLAG(hle,              4, f7_1)
-    CPUIDPP_IMPL_FLAG(avx2,             5, f7_1)
-
-    CPUIDPP_IMPL_FLAG(smep,             7, f7_1)
-    CPUIDPP_IMPL_FLAG(bmi2,             8, f7_1)
-    CPUIDPP_IMPL_FLAG(erms,             9, f7_1)
-    CPUIDPP_IMPL_FLAG(invpcid,          10, f7_1)
-    CPUIDPP_IMPL_FLAG(rtm,              11, f7_1)
-    CPUIDPP_IMPL_FLAG(pqm,              12, f7_1)
-
-    CPUIDPP_IMPL_FLAG(mpx,              14, f7_1)
-    CPUIDPP_IMPL_FLAG(pqe,              15, f7_1)
-    CPUIDPP_IMPL_FLAG(avx512f,          16, f7_1)
-    CPUIDPP_IMPL_FLAG(avx512dq,         17, f7_1)
-    CPUIDPP_IMPL_FLAG(rdseed,           18, f7_1)
-    CPUIDPP_IMPL_FLAG(adx,              19, f7_1)
-    CPUIDPP_IMPL_FLAG(smap,             20, f7_1)
-    CPUIDPP_IMPL_FLAG(avx512ifma,       21, f7_1)
-    CPUIDPP_IMPL_FLAG(pcommit,          22, f7_1)
-    CPUIDPP_IMPL_FLAG(clflushopt,       23, f7_1)
-    CPUIDPP_IMPL_FLAG(clwb,             24, f7_1)
-    CPUIDPP_IMPL_FLAG(intel_pt,         25, f7_1)
-    CPUIDPP_IMPL_FLAG(avx512pf,         26, f7_1)
-    CPUIDPP_IMPL_FLAG(avx512er,         27, f7_1)
-    CPUIDPP_IMPL_FLAG(avx512cd,         28, f7_1)
-    CPUIDPP_IMPL_FLAG(sha,              29, f7_1)
-    CPUIDPP_IMPL_FLAG(avx512bw,         30, f7_1)
-    CPUIDPP_IMPL_FLAG(avx512vl,         31, f7_1)
-
-
-    CPUIDPP_IMPL_FLAG(prefetchwt1,      0, f7_2)
-    CPUIDPP_IMPL_FLAG(avx512vbmi,       1, f7_2)
-    CPUIDPP_IMPL_FLAG(umip,             2, f7_2)
-    CPUIDPP_IMPL_FLAG(pku,              3, f7_2)
-    CPUIDPP_IMPL_FLAG(ospke,            4, f7_2)
-
-    CPUIDPP_IMPL_FLAG(avx512vpopcntdq,  14, f7_2)
-
-    CPUIDPP_IMPL_FLAG(rdpid,            22, f7_2)
-
-    CPUIDPP_IMPL_FLAG(sgx_lc,           30, f7_2)
-
-    CPUIDPP_IMPL_FLAG(avx512_4vnniw,    2, f7_3)
-    CPUIDPP_IMPL_FLAG(avx512_4fmaps,    3, f7_3)
-
-    // AMD specific
-
-    CPUIDPP_IMPL_FLAG(syscall,          11, f80000001_3)
-
-    CPUIDPP_IMPL_FLAG(mp,               19, f80000001_3)
-    CPUIDPP_IMPL_FLAG(nx,               20, f80000001_3)
-
-    CPUIDPP_IMPL_FLAG(mmxext,           22, f80000001_3)
-
-    CPUIDPP_IMPL_FLAG(fxsr_opt,         25, f80000001_3)
-    CPUIDPP_IMPL_FLAG(pdpe1gb,          26, f80000001_3)
-    CPUIDPP_IMPL_FLAG(rdtscp,           27, f80000001_3)
-
-    CPUIDPP_IMPL_FLAG(lm,               29, f80000001_3)
-    CPUIDPP_IMPL_FLAG(amd_3dnowext,     30, f80000001_3)
-    CPUIDPP_IMPL_FLAG(amd_3dnow,        31, f80000001_3)
-
-    CPUIDPP_IMPL_FLAG(lahf_lm,          0, f80000001_2)
-    CPUIDPP_IMPL_FLAG(cmp_legacy,       1, f80000001_2)
-    CPUIDPP_IMPL_FLAG(svm,              2, f80000001_2)
-    CPUIDPP_IMPL_FLAG(extapic,          3, f80000001_2)
-    CPUIDPP_IMPL_FLAG(cr8_legacy,       4, f80000001_2)
-    CPUIDPP_IMPL_FLAG(abm,              5, f80000001_2)
-    CPUIDPP_IMPL_FLAG(sse4a,            6, f80000001_2)
-    CPUIDPP_IMPL_FLAG(misalignsse,      7, f80000001_2)
-    CPUIDPP_IMPL_FLAG(amd_3dnowprefetch,8, f80000001_2)
-    CPUIDPP_IMPL_FLAG(osvw,             9, f80000001_2)
-    CPUIDPP_IMPL_FLAG(ibs,              10, f80000001_2)
-    CPUIDPP_IMPL_FLAG(xop,              11, f80000001_2)
-    CPUIDPP_IMPL_FLAG(skinit,           12, f80000001_2)
-    CPUIDPP_IMPL_FLAG(wdt,              13, f80000001_2)
-
-    CPUIDPP_IMPL_FLAG(lwp,              15, f80000001_2)
-    CPUIDPP_IMPL_FLAG(fma4,             16, f80000001_2)
-    CPUIDPP_IMPL_FLAG(tce,              17, f80000001_2)
-
-    CPUIDPP_IMPL_FLAG(nodeid_msr,       19, f80000001_2)
-
-    CPUIDPP_IMPL_FLAG(tbm,              21, f80000001_2)
-    CPUIDPP_IMPL_FLAG(topoext,          22, f80000001_2)
-    CPUIDPP_IMPL_FLAG(perfctr_core,     23, f80000001_2)
-    CPUIDPP_IMPL_FLAG(perfctr_nb,       24, f80000001_2)
-
-    CPUIDPP_IMPL_FLAG(dbx,              26, f80000001_2)
-    CPUIDPP_IMPL_FLAG(perftsc,          27, f80000001_2)
-    CPUIDPP_IMPL_FLAG(pcx_l2i,          28, f80000001_2)
+    std::array<unsigned, 4> info{};
+    // EAX=0x80000005
+    cpuid(source, info.data(), 0x80000005);
 
-    static const CPUIDImpl& get()
+    // L1 descriptors store the associativity verbatim with 0xff denoting a
+    // fully associative cache.
+    const auto l1 = [](unsigned value, cache_type type)
     {
-        static const CPUIDImpl instance;
-        return instance;
+        cache c{};
+
+        c.type = type;
+        c.level = 1;
+        c.size = static_cast<std::size_t>((value >> 24U) & 0xffU) * 1024;
+        c.line_size = value & 0xffU;
+        c.ways = (value >> 16U) & 0xffU;
+        c.fully_associative = c.ways == 0xff;
+        c.shared_by = 1;
+
+        return c;
+    };
+
+    add_legacy_cache(caches, l1(info[2], cache_type::data));
+    add_legacy_cache(caches, l1(info[3], cache_type::instruction));
+
+    if (s.max_extended_leaf < 0x80000006) {
+        return;
     }
 
-    const std::string& query_model() const
-    {
-        if (model.empty() && max_leaf >= 0x80000004) {
-            model.reserve(48);
+    info.fill(0);
+    // EAX=0x80000006
+    cpuid(source, info.data(), 0x80000006);
 
-            std::array<unsigned, 4> info{};
-            // EAX=0x80000002
-            cpuid(info.data(), 0x80000002);
+    const std::array<unsigned, 4> l2_l3 = info;
+    unsigned cores = 1;
 
-            model += ExtractCharsFromArray<0, 1, 2, 3>::extract(info);
+    if (s.max_extended_leaf >= 0x80000008) {
+        info.fill(0);
+        // EAX=0x80000008
+        cpuid(source, info.data(), 0x80000008);
 
-            info.fill(0);
-            // EAX=0x80000003
-            cpuid(info.data(), 0x80000003);
+        cores = (info[2] & 0xffU) + 1;
+    }
 
-            model += ExtractCharsFromArray<0, 1, 2, 3>::extract(info);
+    // L2 and L3 descriptors store an encoded associativity
+    const auto l2_l3_cache = [](unsigned level, std::size_t size,
+                                unsigned value, unsigned shared_by)
+    {
+        constexpr std::array<unsigned, 16> ways{{
+            0, 1, 2, 3, 4, 6, 8, 0, 16, 0, 32, 48, 64, 96, 128, 0xff
+        }};
+
+        cache c{};
+
+        c.type = cache_type::unified;
+        c.level = level;
+        c.size = size;
+        c.line_size = value & 0xffU;
+        c.ways = ways[(value >> 12U) & 0xfU];
+        c.fully_associative = c.ways == 0xff;
+        c.shared_by = shared_by;
+
+        return c;
+    };
+
+    add_legacy_cache(caches, l2_l3_cache(2,
+        static_cast<std::size_t>(l2_l3[2] >> 16U) * 1024, l2_l3[2], 1));
+    add_legacy_cache(caches, l2_l3_cache(3,
+        static_cast<std::size_t>(l2_l3[3] >> 18U) * 512 * 1024, l2_l3[3],
+        cores));
+}
 
-            info.fill(0);
-            // EAX=0x80000004
-            cpuid(info.data(), 0x80000004);
+/**
+ * @brief Decodes the deterministic cache parameters.
+ *
+ * Intel processors report them in leaf 4 and AMD processors with topology
+ * extensions in leaf 0x8000001D. Both leaves share the same layout. Older
+ * AMD processors only provide the legacy descriptors in leaves 0x80000005
+ * and 0x80000006.
+ */
+std::vector<cache> query_caches(const snapshot& s,
+                                const cpuid_source* source)
+{
+    const bool amd = std::memcmp(s.vendor_id, "AuthenticAMD", 12) == 0;
+    std::vector<cache> caches;
 
-            model += ExtractCharsFromArray<0, 1, 2, 3>::extract(info);
+    if (amd && s.topoext() && s.max_extended_leaf >= 0x8000001D) {
+        query_deterministic_caches(source, 0x8000001D, caches);
+    }
+    else if (amd) {
+        query_legacy_caches(s, source, caches);
+    }
+    else if (s.max_leaf >= 4) {
+        query_deterministic_caches(source, 4, caches);
+    }
 
-            using std::placeholders::_1;
+    return caches;
+}
 
-            // Trim null on the right
-            std::string::size_type pos = model.find_last_not_of('\0');
+} // namespace
 
-            if (pos != std::string::npos) {
-                // pos is pointing to a valid character we do not want to
-                // discard. Advance to the next one.
-                model.erase(pos + 1);
-            }
+void detect(snapshot& s) noexcept
+{
+    // Always execute the instruction since dumps are answered through a
+    // virtual call into a container that may not be initialized yet.
+    detect(s, static_cast<const cpuid_source*>(nullptr));
+}
 
-            // Trim whitespace left and right
-            model.erase(model.begin(), std::find_if_not(model.begin(), model.end(),
-                std::bind(std::isspace<char>, _1, std::locale::classic())));
-            model.erase(std::find_if_not(model.rbegin(), model.rend(),
-                std::bind(std::isspace<char>, _1, std::locale::classic())).base(), model.end());
-        }
+void detect(snapshot& s, const cpuid_source& source)
+{
+    detect(s, &source);
+}
 
-        return model;
+std::vector<cache> cache_info(const cpuid_source& source)
+{
+    snapshot s;
+    detect(s, &source);
+
+    return query_caches(s, &source);
+}
+
+struct CPUIDImpl
+{
+    // The instance is created by a thread-safe static initialization which
+    // publishes the strings to all threads. The snapshot has already been
+    // filled by the first snapshot_init constructor.
+    CPUIDImpl()
+        : features{detail::detected}
+        , vendor{features.vendor_id}
+        , model{features.brand}
+        , caches{query_caches(features, detail::active_source())}
+    {
     }
 
-    const std::string& query_vendor() const
+    static const CPUIDImpl& get()
     {
-        if (vendor.empty()) {
-            std::array<unsigned, 4> info{};
-            // EAX=0
-            cpuid(info.data(), 0);
+        static const CPUIDImpl instance;
+        return instance;
+    }
 
-            vendor = ExtractCharsFromArray<1, 3, 2>::extract(info);
-        }
+    const snapshot features;
+    const std::string vendor;
+    const std::string model;
+    const std::vector<cache> caches;
+};
+
+namespace detail {
 
-        return vendor;
+snapshot detected;
+
+snapshot_init::snapshot_init()
+{
+    static unsigned counter;
+
+    if (counter++ == 0) {
+        load_environment_statistics();
+        load_environment_dumps();
+
+        if (const cpuid_source* const source = active_source()) {
+            cpuidpp::detect(detected, *source);
+        }
+        else {
+            cpuidpp::detect(detected);
+        }
     }
+}
 
-    unsigned max_leaf;
-    std::bitset<32> f1_2;
-    std::bitset<32> f1_3;
-    std::bitset<32> f7_1;
-    std::bitset<32> f7_2;
-    std::bitset<32> f7_3;
-    std::bitset<32> f80000001_2;
-    std::bitset<32> f80000001_3;
-    mutable std::string vendor;
-    mutable std::string model;
-};
+} // namespace detail
 
 const std::string& vendor()
 {
-    return CPUIDImpl::get().query_vendor();
+    return CPUIDImpl::get().vendor;
 }
 
 const std::string& model()
 {
-    return CPUIDImpl::get().query_model();
+    return CPUIDImpl::get().model;
+}
+
+const std::vector<cache>& cache_info()
+{
+    return CPUIDImpl::get().caches;
 }
 
-#define CPUIDPP_CPUID_IMPL_FLAG(name)       \
-    bool name()                             \
-    {                                       \
-        return CPUIDImpl::get().name();     \
+#define CPUIDPP_CPUID_IMPL_FLAG(name)               \
+    bool name()                                     \
+    {                                               \
+        return CPUIDImpl::get().features.name();    \
     }
 
 
@@ -614,6 +528,14 @@ CPUIDPP_CPUID_IMPL_FLAG(umip)
 CPUIDPP_CPUID_IMPL_FLAG(pku)
 CPUIDPP_CPUID_IMPL_FLAG(ospke)
 
+CPUIDPP_CPUID_IMPL_FLAG(avx512vbmi2)
+
+CPUIDPP_CPUID_IMPL_FLAG(gfni)
+CPUIDPP_CPUID_IMPL_FLAG(vaes)
+CPUIDPP_CPUID_IMPL_FLAG(vpclmulqdq)
+CPUIDPP_CPUID_IMPL_FLAG(avx512vnni)
+CPUIDPP_CPUID_IMPL_FLAG(avx512bitalg)
+
 CPUIDPP_CPUID_IMPL_FLAG(avx512vpopcntdq)
 
 CPUIDPP_CPUID_IMPL_FLAG(rdpid)
@@ -622,6 +544,39 @@ CPUIDPP_CPUID_IMPL_FLAG(sgx_lc)
 
 CPUIDPP_CPUID_IMPL_FLAG(avx512_4vnniw)
 CPUIDPP_CPUID_IMPL_FLAG(avx512_4fmaps)
+CPUIDPP_CPUID_IMPL_FLAG(fsrm)
+
+CPUIDPP_CPUID_IMPL_FLAG(hybrid)
+
+CPUIDPP_CPUID_IMPL_FLAG(amx_bf16)
+
+CPUIDPP_CPUID_IMPL_FLAG(avx512fp16)
+CPUIDPP_CPUID_IMPL_FLAG(amx_tile)
+CPUIDPP_CPUID_IMPL_FLAG(amx_int8)
+
+CPUIDPP_CPUID_IMPL_FLAG(avx_vnni)
+CPUIDPP_CPUID_IMPL_FLAG(avx512bf16)
+
+CPUIDPP_CPUID_IMPL_FLAG(fzrm)
+CPUIDPP_CPUID_IMPL_FLAG(fsrs)
+CPUIDPP_CPUID_IMPL_FLAG(fsrc)
+
+CPUIDPP_CPUID_IMPL_FLAG(amx_fp16)
+
+CPUIDPP_CPUID_IMPL_FLAG(avx_ifma)
+
+CPUIDPP_CPUID_IMPL_FLAG(avx_ne_convert)
+
+CPUIDPP_CPUID_IMPL_FLAG(avx10)
+
+CPUIDPP_CPUID_IMPL_FLAG(avx10_128)
+CPUIDPP_CPUID_IMPL_FLAG(avx10_256)
+CPUIDPP_CPUID_IMPL_FLAG(avx10_512)
+
+unsigned avx10_version()
+{
+    return CPUIDImpl::get().features.avx10_version();
+}
 
 // AMD specific
 
@@ -670,4 +625,41 @@ CPUIDPP_CPUID_IMPL_FLAG(dbx)
 CPUIDPP_CPUID_IMPL_FLAG(perftsc)
 CPUIDPP_CPUID_IMPL_FLAG(pcx_l2i)
 
+// Advanced power management
+
+CPUIDPP_CPUID_IMPL_FLAG(invariant_tsc)
+
+// Usable vector extensions
+
+CPUIDPP_CPUID_IMPL_FLAG(os_avx)
+CPUIDPP_CPUID_IMPL_FLAG(os_avx512)
+CPUIDPP_CPUID_IMPL_FLAG(os_amx)
+CPUIDPP_CPUID_IMPL_FLAG(avx_usable)
+CPUIDPP_CPUID_IMPL_FLAG(avx10_usable)
+CPUIDPP_CPUID_IMPL_FLAG(avx2_usable)
+CPUIDPP_CPUID_IMPL_FLAG(avx512_4fmaps_usable)
+CPUIDPP_CPUID_IMPL_FLAG(avx512_4vnniw_usable)
+CPUIDPP_CPUID_IMPL_FLAG(avx512bf16_usable)
+CPUIDPP_CPUID_IMPL_FLAG(avx512bitalg_usable)
+CPUIDPP_CPUID_IMPL_FLAG(avx512bw_usable)
+CPUIDPP_CPUID_IMPL_FLAG(avx512cd_usable)
+CPUIDPP_CPUID_IMPL_FLAG(avx512dq_usable)
+CPUIDPP_CPUID_IMPL_FLAG(avx512er_usable)
+CPUIDPP_CPUID_IMPL_FLAG(avx512f_usable)
+CPUIDPP_CPUID_IMPL_FLAG(avx512fp16_usable)
+CPUIDPP_CPUID_IMPL_FLAG(avx512ifma_usable)
+CPUIDPP_CPUID_IMPL_FLAG(avx512pf_usable)
+CPUIDPP_CPUID_IMPL_FLAG(avx512vbmi_usable)
+CPUIDPP_CPUID_IMPL_FLAG(avx512vbmi2_usable)
+CPUIDPP_CPUID_IMPL_FLAG(avx512vl_usable)
+CPUIDPP_CPUID_IMPL_FLAG(avx512vnni_usable)
+CPUIDPP_CPUID_IMPL_FLAG(avx512vpopcntdq_usable)
+CPUIDPP_CPUID_IMPL_FLAG(avx_ifma_usable)
+CPUIDPP_CPUID_IMPL_FLAG(avx_ne_convert_usable)
+CPUIDPP_CPUID_IMPL_FLAG(avx_vnni_usable)
+CPUIDPP_CPUID_IMPL_FLAG(f16c_usable)
+CPUIDPP_CPUID_IMPL_FLAG(fma_usable)
+CPUIDPP_CPUID_IMPL_FLAG(vaes_usable)
+CPUIDPP_CPUID_IMPL_FLAG(vpclmulqdq_usable)
+
 } // namespace cpuidpp
@@ -0,0 +1,673 @@
+/**
+ * @brief %cpuidpp serialized CPUID dump implementation.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <cpuidpp/dump.hpp>
+
+#include "affinity.hpp"
+#include "cpuid.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#if defined(HAVE_MMAP)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // defined(HAVE_MMAP)
+
+namespace cpuidpp {
+
+namespace {
+
+using detail::execute_cpuid;
+using detail::execute_cpuidex;
+
+/**
+ * @brief Layout of the file header.
+ *
+ * The header is followed by @c count records of type @ref cpuid_record sorted
+ * by leaf, subleaf and processor. All values are stored in the native (little)
+ * endianness.
+ */
+struct FileHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t count;
+    cpuid_fingerprint fingerprint;
+    std::uint32_t reserved;
+    std::uint64_t xcr0;
+};
+
+static_assert(sizeof(cpuid_record) == 28, "unexpected record size");
+static_assert(sizeof(FileHeader) == 56, "unexpected header size");
+
+constexpr char Magic[8] = {'C', 'P', 'U', 'I', 'D', 'P', 'P', 'D'};
+
+//! Highest subleaf enumerated for leaves reporting their subleaf count.
+constexpr unsigned MaxSubleaf = 63;
+
+bool record_less(const cpuid_record& lhs, const cpuid_record& rhs) noexcept
+{
+    if (lhs.leaf != rhs.leaf) {
+        return lhs.leaf < rhs.leaf;
+    }
+
+    if (lhs.subleaf != rhs.subleaf) {
+        return lhs.subleaf < rhs.subleaf;
+    }
+
+    return lhs.cpu < rhs.cpu;
+}
+
+class Capture
+{
+public:
+    explicit Capture(std::vector<cpuid_record>& records,
+                     std::uint32_t cpu = cpuid_dump::any_cpu)
+        : records_(records)
+        , cpu_{cpu}
+    {
+    }
+
+    //! Executes @p leaf, @p subleaf and stores the result.
+    const std::uint32_t* add(unsigned leaf, unsigned subleaf)
+    {
+        unsigned info[4] = {};
+        execute_cpuidex(info, leaf, subleaf);
+
+        cpuid_record r{};
+        r.cpu = cpu_;
+        r.leaf = leaf;
+        r.subleaf = subleaf;
+        std::memcpy(r.regs, info, sizeof r.regs);
+
+        records_.push_back(r);
+
+        return records_.back().regs;
+    }
+
+    //! Captures the subleaves @p first to @p last.
+    void add_range(unsigned leaf, unsigned first, unsigned last)
+    {
+        for (unsigned subleaf = first; subleaf <= std::min(last, MaxSubleaf);
+             ++subleaf) {
+            add(leaf, subleaf);
+        }
+    }
+
+    /**
+     * @brief Captures the subleaves until the bits of @c regs[reg] selected by
+     *        @p mask are zero.
+     */
+    void add_until_zero(unsigned leaf, unsigned reg, std::uint32_t mask)
+    {
+        for (unsigned subleaf = 0; subleaf <= MaxSubleaf; ++subleaf) {
+            if ((add(leaf, subleaf)[reg] & mask) == 0) {
+                break;
+            }
+        }
+    }
+
+    //! Captures @p leaf along with the subleaves it defines.
+    void add_leaf(unsigned leaf)
+    {
+        switch (leaf) {
+        // Deterministic cache parameters: until the cache type is null
+        case 0x4:
+        case 0x8000001D:
+            add_until_zero(leaf, 0, 0x1fU);
+            break;
+        // Extended topology: until the level type is invalid
+        case 0xB:
+        case 0x1F:
+        case 0x80000026:
+            add_until_zero(leaf, 2, 0xff00U);
+            break;
+        // Subleaf 0 EAX reports the highest subleaf
+        case 0x7:
+        case 0x14:
+        case 0x17:
+        case 0x18:
+        case 0x1D:
+        case 0x20:
+        case 0x23:
+        case 0x24:
+            add_range(leaf, 1, add(leaf, 0)[0]);
+            break;
+        // Processor extended state enumeration
+        case 0xD:
+            add_range(leaf, 0, MaxSubleaf);
+            break;
+        // Resource director technology monitoring and allocation
+        case 0xF:
+        case 0x10:
+        case 0x80000020:
+            add_range(leaf, 0, 15);
+            break;
+        // SGX capability enumeration
+        case 0x12:
+            add_range(leaf, 0, 31);
+            break;
+        default:
+            add(leaf, 0);
+            break;
+        }
+    }
+
+private:
+    std::vector<cpuid_record>& records_;
+    std::uint32_t cpu_;
+};
+
+//! Indicates whether both records belong to the same query.
+bool same_query(const cpuid_record& lhs, const cpuid_record& rhs) noexcept
+{
+    return lhs.leaf == rhs.leaf && lhs.subleaf == rhs.subleaf &&
+        lhs.cpu == rhs.cpu;
+}
+
+std::string temporary_path(const char* path)
+{
+    return std::string{path} + ".tmp";
+}
+
+} // namespace
+
+constexpr std::uint32_t cpuid_dump::format_version;
+
+cpuid_fingerprint cpuid_fingerprint::current() noexcept
+{
+    cpuid_fingerprint result{};
+    unsigned info[4] = {};
+
+    // EAX=0
+    execute_cpuid(info, 0);
+    std::memcpy(result.leaf0, info, sizeof result.leaf0);
+
+    if (result.leaf0[0] >= 1) {
+        // EAX=1
+        execute_cpuid(info, 1);
+
+        result.signature = info[0];
+        result.leaf1_ecx = info[2];
+        result.leaf1_edx = info[3];
+    }
+
+    return result;
+}
+
+cpuid_dump::cpuid_dump() noexcept
+    : records_{nullptr}
+    , size_{0}
+    , fingerprint_{}
+    , xcr0_{0}
+    , mapping_{nullptr}
+    , mapping_size_{0}
+{
+}
+
+cpuid_dump::cpuid_dump(std::vector<cpuid_record> records, std::uint64_t xcr0)
+    : cpuid_dump{}
+{
+    // Keep the first of duplicate records
+    std::stable_sort(records.begin(), records.end(), record_less);
+    records.erase(std::unique(records.begin(), records.end(), same_query),
+                  records.end());
+
+    storage_ = std::move(records);
+    records_ = storage_.data();
+    size_ = storage_.size();
+    xcr0_ = xcr0;
+
+    if (const cpuid_record* const r = find(0, 0)) {
+        std::memcpy(fingerprint_.leaf0, r->regs, sizeof fingerprint_.leaf0);
+    }
+
+    if (const cpuid_record* const r = find(1, 0)) {
+        fingerprint_.signature = r->regs[0];
+        fingerprint_.leaf1_ecx = r->regs[2];
+        fingerprint_.leaf1_edx = r->regs[3];
+    }
+}
+
+cpuid_dump::cpuid_dump(cpuid_dump&& other) noexcept
+    : cpuid_dump{}
+{
+    *this = std::move(other);
+}
+
+cpuid_dump& cpuid_dump::operator=(cpuid_dump&& other) noexcept
+{
+    if (this != &other) {
+        reset();
+
+        const bool owned = other.records_ == other.storage_.data();
+
+        storage_ = std::move(other.storage_);
+        records_ = owned ? storage_.data() : other.records_;
+        size_ = other.size_;
+        fingerprint_ = other.fingerprint_;
+        xcr0_ = other.xcr0_;
+        mapping_ = other.mapping_;
+        mapping_size_ = other.mapping_size_;
+
+        other.records_ = nullptr;
+        other.size_ = 0;
+        other.mapping_ = nullptr;
+        other.mapping_size_ = 0;
+        other.reset();
+    }
+
+    return *this;
+}
+
+cpuid_dump::~cpuid_dump()
+{
+    reset();
+}
+
+void cpuid_dump::reset() noexcept
+{
+#if defined(HAVE_MMAP)
+    if (mapping_ != nullptr) {
+        munmap(mapping_, mapping_size_);
+    }
+#endif // defined(HAVE_MMAP)
+
+    storage_.clear();
+    records_ = nullptr;
+    size_ = 0;
+    fingerprint_ = cpuid_fingerprint{};
+    xcr0_ = 0;
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+}
+
+cpuid_dump cpuid_dump::capture()
+{
+    std::vector<cpuid_record> records;
+    Capture capture{records};
+
+    // Guard against bogus leaf counts
+    const unsigned max_leaf = std::min(capture.add(0, 0)[0], 0xFFU);
+    std::uint32_t leaf1_ecx = 0;
+
+    for (unsigned leaf = 1; leaf <= max_leaf; ++leaf) {
+        capture.add_leaf(leaf);
+
+        if (leaf == 1) {
+            leaf1_ecx = records.back().regs[2];
+        }
+    }
+
+    // The hypervisor range is only defined under virtualization
+    if (((leaf1_ecx >> 31U) & 1U) != 0) {
+        unsigned max_hypervisor_leaf = capture.add(0x40000000, 0)[0];
+
+        if (max_hypervisor_leaf < 0x40000000 ||
+            max_hypervisor_leaf > 0x400000FF) {
+            max_hypervisor_leaf = 0x40000000;
+        }
+
+        for (unsigned leaf = 0x40000001; leaf <= max_hypervisor_leaf;
+             ++leaf) {
+            capture.add_leaf(leaf);
+        }
+    }
+
+    unsigned max_extended_leaf = capture.add(0x80000000, 0)[0];
+
+    if (max_extended_leaf < 0x80000000 || max_extended_leaf > 0x800000FF) {
+        max_extended_leaf = 0x80000000;
+    }
+
+    for (unsigned leaf = 0x80000001; leaf <= max_extended_leaf; ++leaf) {
+        capture.add_leaf(leaf);
+    }
+
+    // XGETBV faults unless the OS has enabled XSAVE
+    const std::uint64_t xcr0 =
+        ((leaf1_ecx >> 27U) & 1U) != 0 ? detail::xgetbv(0) : 0;
+
+    return cpuid_dump{std::move(records), xcr0};
+}
+
+cpuid_dump cpuid_dump::capture_all_cpus()
+{
+    cpuid_dump common = capture();
+    const std::vector<unsigned> indices = detail::available_cpus();
+
+    if (indices.empty()) {
+        return common;
+    }
+
+    std::uint32_t max_leaf = 0;
+    std::uint32_t max_extended_leaf = 0;
+
+    if (const cpuid_record* const r = common.find(0, 0)) {
+        max_leaf = r->regs[0];
+    }
+
+    if (const cpuid_record* const r = common.find(0x80000000, 0)) {
+        max_extended_leaf = r->regs[0];
+    }
+
+    // Leaves reporting the APIC ID or the core type of the executing
+    // processor
+    const unsigned topology_leaves[] = {0x1, 0xB, 0x1A, 0x1F, 0x8000001E};
+    std::vector<std::vector<cpuid_record> > per_cpu(indices.size());
+
+    detail::run_on_each(indices,
+        [&](std::size_t i)
+        {
+            Capture capture{per_cpu[i], indices[i]};
+
+            for (unsigned leaf : topology_leaves) {
+                if (leaf < 0x80000000 ? leaf <= max_leaf
+                                      : leaf <= max_extended_leaf) {
+                    capture.add_leaf(leaf);
+                }
+            }
+        });
+
+    std::vector<cpuid_record> records{common.begin(), common.end()};
+
+    for (const std::vector<cpuid_record>& cpu : per_cpu) {
+        records.insert(records.end(), cpu.begin(), cpu.end());
+    }
+
+    return cpuid_dump{std::move(records), common.xcr0()};
+}
+
+bool cpuid_dump::load(const char* path)
+{
+    reset();
+
+    FileHeader header{};
+
+#if defined(HAVE_MMAP)
+    const int fd = open(path, O_RDONLY);
+
+    if (fd == -1) {
+        return false;
+    }
+
+    struct stat st{};
+    void* mapping = MAP_FAILED;
+
+    if (fstat(fd, &st) == 0 &&
+        static_cast<std::size_t>(st.st_size) >= sizeof header) {
+        mapping = mmap(nullptr, static_cast<std::size_t>(st.st_size),
+                       PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+
+    close(fd);
+
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    mapping_ = mapping;
+    mapping_size_ = static_cast<std::size_t>(st.st_size);
+
+    std::memcpy(&header, mapping, sizeof header);
+
+    const std::size_t file_size = mapping_size_;
+    records_ = reinterpret_cast<const cpuid_record*>(
+        static_cast<const char*>(mapping) + sizeof header);
+#else
+    std::FILE* const file = std::fopen(path, "rb");
+
+    if (file == nullptr) {
+        return false;
+    }
+
+    bool ok = std::fread(&header, sizeof header, 1, file) == 1 &&
+        std::memcmp(header.magic, Magic, sizeof Magic) == 0 &&
+        header.version == format_version;
+
+    // Validate the record count against the file size before allocating
+    // storage for it
+    if (ok) {
+        long size = -1;
+
+        if (std::fseek(file, 0, SEEK_END) == 0) {
+            size = std::ftell(file);
+        }
+
+        ok = size >= static_cast<long>(sizeof header) &&
+            (static_cast<std::size_t>(size) - sizeof header) %
+                sizeof(cpuid_record) == 0 &&
+            (static_cast<std::size_t>(size) - sizeof header) /
+                sizeof(cpuid_record) == header.count &&
+            std::fseek(file, static_cast<long>(sizeof header), SEEK_SET) == 0;
+    }
+
+    if (ok) {
+        storage_.resize(header.count);
+        ok = std::fread(storage_.data(), sizeof(cpuid_record), storage_.size(),
+                        file) == storage_.size() &&
+            std::fgetc(file) == EOF;
+    }
+
+    std::fclose(file);
+
+    if (!ok) {
+        reset();
+        return false;
+    }
+
+    const std::size_t file_size =
+        sizeof header + storage_.size() * sizeof(cpuid_record);
+    records_ = storage_.data();
+#endif // defined(HAVE_MMAP)
+
+    const bool valid = std::memcmp(header.magic, Magic, sizeof Magic) == 0 &&
+        header.version == format_version &&
+        (file_size - sizeof header) / sizeof(cpuid_record) == header.count &&
+        (file_size - sizeof header) % sizeof(cpuid_record) == 0 &&
+        std::is_sorted(records_, records_ + header.count, record_less);
+
+    if (!valid) {
+        reset();
+        return false;
+    }
+
+    size_ = header.count;
+    fingerprint_ = header.fingerprint;
+    xcr0_ = header.xcr0;
+
+    return true;
+}
+
+bool cpuid_dump::save(const char* path) const
+{
+    const std::string temporary = temporary_path(path);
+    std::FILE* const file = std::fopen(temporary.c_str(), "wb");
+
+    if (file == nullptr) {
+        return false;
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, Magic, sizeof Magic);
+    header.version = format_version;
+    header.count = static_cast<std::uint32_t>(size_);
+    header.fingerprint = fingerprint_;
+    header.xcr0 = xcr0_;
+
+    bool ok = std::fwrite(&header, sizeof header, 1, file) == 1 &&
+        std::fwrite(records_, sizeof(cpuid_record), size_, file) == size_;
+
+    ok = std::fclose(file) == 0 && ok;
+
+#if defined(_WIN32)
+    // rename does not replace existing files on Windows
+    if (ok) {
+        std::remove(path);
+    }
+#endif // defined(_WIN32)
+
+    if (!ok || std::rename(temporary.c_str(), path) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool cpuid_dump::empty() const noexcept
+{
+    return size_ == 0;
+}
+
+std::size_t cpuid_dump::size() const noexcept
+{
+    return size_;
+}
+
+const cpuid_record* cpuid_dump::begin() const noexcept
+{
+    return records_;
+}
+
+const cpuid_record* cpuid_dump::end() const noexcept
+{
+    return records_ + size_;
+}
+
+const cpuid_fingerprint& cpuid_dump::fingerprint() const noexcept
+{
+    return fingerprint_;
+}
+
+std::uint64_t cpuid_dump::xcr0() const noexcept
+{
+    return xcr0_;
+}
+
+bool cpuid_dump::matches_host() const noexcept
+{
+    const cpuid_fingerprint current = cpuid_fingerprint::current();
+
+    if (empty() || current != fingerprint_) {
+        return false;
+    }
+
+    // XGETBV faults unless the OS has enabled XSAVE
+    const bool oxsave = ((current.leaf1_ecx >> 27U) & 1U) != 0;
+
+    return (oxsave ? detail::xgetbv(0) : 0) == xcr0_;
+}
+
+void cpuid_dump::query(std::uint32_t cpu, std::uint32_t leaf,
+                       std::uint32_t subleaf,
+                       std::uint32_t (&regs)[4]) const noexcept
+{
+    if (const cpuid_record* const r = find(leaf, subleaf, cpu)) {
+        std::memcpy(regs, r->regs, sizeof regs);
+    }
+    else {
+        std::memset(regs, 0, sizeof regs);
+    }
+}
+
+std::vector<std::uint32_t> cpuid_dump::cpus() const
+{
+    std::vector<std::uint32_t> result;
+
+    for (const cpuid_record& r : *this) {
+        if (r.cpu != any_cpu) {
+            result.push_back(r.cpu);
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+
+    // A dump captured on a single processor describes a single processor
+    if (result.empty() && !empty()) {
+        result.push_back(0);
+    }
+
+    return result;
+}
+
+const cpuid_record* cpuid_dump::find(std::uint32_t leaf,
+                                     std::uint32_t subleaf,
+                                     std::uint32_t cpu) const noexcept
+{
+    cpuid_record key{};
+    key.leaf = leaf;
+    key.subleaf = subleaf;
+    key.cpu = 0;
+
+    const cpuid_record* const first =
+        std::lower_bound(begin(), end(), key, record_less);
+
+    const cpuid_record* any = nullptr;
+
+    for (const cpuid_record* r = first;
+         r != end() && r->leaf == leaf && r->subleaf == subleaf; ++r) {
+        if (r->cpu == cpu) {
+            return r;
+        }
+
+        if (r->cpu == any_cpu) {
+            any = r;
+        }
+    }
+
+    return any;
+}
+
+namespace detail {
+
+const cpuid_source* replay_source;
+const cpuid_source* host_source;
+
+void load_environment_dumps()
+{
+    const char* const replay = std::getenv("CPUIDPP_REPLAY");
+
+    if (replay != nullptr && *replay != '\0') {
+        static cpuid_dump dump;
+
+        // An unreadable dump leaves the current processor in effect
+        if (dump.load(replay)) {
+            replay_source = &dump;
+        }
+    }
+
+    const char* const path = std::getenv("CPUIDPP_DUMP");
+
+    if (path == nullptr || *path == '\0') {
+        return;
+    }
+
+    static cpuid_dump dump;
+
+    if (!dump.load(path) || !dump.matches_host()) {
+        dump = cpuid_dump::capture();
+        // A read-only location leaves the captured dump in memory only
+        dump.save(path);
+    }
+
+    host_source = &dump;
+}
+
+} // namespace detail
+
+} // namespace cpuidpp
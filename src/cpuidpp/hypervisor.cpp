@@ -0,0 +1,187 @@
+/**
+ * @brief %cpuidpp hypervisor detection implementation.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <cpuidpp/hypervisor.hpp>
+#include <cpuidpp/source.hpp>
+
+#include "cpuid.hpp"
+
+#include <cstring>
+
+namespace cpuidpp {
+
+namespace {
+
+struct Signature
+{
+    char value[13];
+    hypervisor_vendor vendor;
+};
+
+constexpr Signature Signatures[] = {
+    {"KVMKVMKVM\0\0\0", hypervisor_vendor::kvm},
+    {"Microsoft Hv", hypervisor_vendor::hyperv},
+    {"XenVMMXenVMM", hypervisor_vendor::xen},
+    {"VMwareVMware", hypervisor_vendor::vmware},
+    {"VBoxVBoxVBox", hypervisor_vendor::virtualbox},
+    {"TCGTCGTCGTCG", hypervisor_vendor::qemu},
+    {" prl hyperv ", hypervisor_vendor::parallels},
+    {" lrpepyh  vr", hypervisor_vendor::parallels},
+    {"bhyve bhyve ", hypervisor_vendor::bhyve},
+    {"ACRNACRNACRN", hypervisor_vendor::acrn},
+    {"VirtualApple", hypervisor_vendor::apple},
+};
+
+//! Reads the signature of the range starting at @p base.
+hypervisor_vendor query_range(const cpuid_source* source, unsigned base,
+                              char (&signature)[13], std::uint32_t& max_leaf)
+{
+    unsigned info[4] = {};
+    // EAX=base
+    detail::cpuid(source, info, base);
+
+    max_leaf = info[0];
+    std::memcpy(signature + 0, info + 1, 4);
+    std::memcpy(signature + 4, info + 2, 4);
+    std::memcpy(signature + 8, info + 3, 4);
+    signature[12] = '\0';
+
+    for (const Signature& s : Signatures) {
+        if (std::memcmp(signature, s.value, 12) == 0) {
+            return s.vendor;
+        }
+    }
+
+    return hypervisor_vendor::unknown;
+}
+
+hypervisor_info query_hypervisor(const cpuid_source* source)
+{
+    hypervisor_info result{};
+    unsigned info[4] = {};
+
+    // EAX=0
+    detail::cpuid(source, info, 0);
+
+    if (info[0] >= 1) {
+        // EAX=1
+        detail::cpuid(source, info, 1);
+    }
+    else {
+        info[2] = 0;
+    }
+
+    // The hypervisor leaves are only defined if ECX bit 31 of leaf 1 is set
+    if (((info[2] >> 31U) & 1U) == 0) {
+        return result;
+    }
+
+    result.base_leaf = 0x40000000;
+    result.vendor = query_range(source, result.base_leaf, result.signature,
+                                result.max_leaf);
+
+    if (result.vendor == hypervisor_vendor::hyperv) {
+        char signature[13];
+        std::uint32_t max_leaf;
+        const hypervisor_vendor native =
+            query_range(source, 0x40000100, signature, max_leaf);
+
+        result.hyperv_compatible = true;
+
+        if (native != hypervisor_vendor::unknown) {
+            result.vendor = native;
+            result.base_leaf = 0x40000100;
+            result.max_leaf = max_leaf;
+            std::memcpy(result.signature, signature, sizeof signature);
+        }
+    }
+    else if (result.vendor == hypervisor_vendor::unknown &&
+             (result.max_leaf < result.base_leaf ||
+              result.max_leaf > result.base_leaf + 0xff)) {
+        // Undefined leaves read as zero or repeat the highest basic leaf
+        result.max_leaf = 0;
+        result.signature[0] = '\0';
+        return result;
+    }
+
+    if (result.vendor == hypervisor_vendor::kvm) {
+        // Older KVM versions report zero instead of the highest leaf
+        if (result.max_leaf < result.base_leaf + 1) {
+            result.max_leaf = result.base_leaf + 1;
+        }
+
+        // EAX=base+1
+        detail::cpuid(source, info, result.base_leaf + 1);
+
+        result.kvm_features = info[0];
+        result.kvm_hints = info[3];
+    }
+
+    // Only VMware and KVM define the timing leaf
+    if ((result.vendor == hypervisor_vendor::vmware ||
+         result.vendor == hypervisor_vendor::kvm) &&
+        result.max_leaf >= result.base_leaf + 0x10) {
+        // EAX=base+0x10
+        detail::cpuid(source, info, result.base_leaf + 0x10);
+
+        // Frequencies in kHz
+        result.tsc_frequency = std::uint64_t{info[0]} * 1000U;
+        result.apic_frequency = std::uint64_t{info[1]} * 1000U;
+    }
+
+    return result;
+}
+
+} // namespace
+
+const hypervisor_info& current_hypervisor()
+{
+    static const hypervisor_info instance =
+        query_hypervisor(detail::active_source());
+    return instance;
+}
+
+hypervisor_info current_hypervisor(const cpuid_source& source)
+{
+    return query_hypervisor(&source);
+}
+
+const char* to_string(hypervisor_vendor vendor) noexcept
+{
+    switch (vendor) {
+    case hypervisor_vendor::none:
+        return "none";
+    case hypervisor_vendor::kvm:
+        return "KVM";
+    case hypervisor_vendor::hyperv:
+        return "Hyper-V";
+    case hypervisor_vendor::xen:
+        return "Xen";
+    case hypervisor_vendor::vmware:
+        return "VMware";
+    case hypervisor_vendor::virtualbox:
+        return "VirtualBox";
+    case hypervisor_vendor::qemu:
+        return "QEMU";
+    case hypervisor_vendor::parallels:
+        return "Parallels";
+    case hypervisor_vendor::bhyve:
+        return "bhyve";
+    case hypervisor_vendor::acrn:
+        return "ACRN";
+    case hypervisor_vendor::apple:
+        return "Apple";
+    case hypervisor_vendor::unknown:
+        break;
+    }
+
+    return "unknown";
+}
+
+} // namespace cpuidpp
@@ -0,0 +1,378 @@
+/**
+ * @brief %cpuidpp memory operations implementation.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <cpuidpp/dispatch.hpp>
+#include <cpuidpp/memops.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else // !defined(_MSC_VER)
+#include <immintrin.h>
+#endif // defined(_MSC_VER)
+
+// GCC and Clang require the instruction set of intrinsics to be enabled for
+// the function using them.
+#if defined(__GNUC__)
+#define CPUIDPP_TARGET(isa) __attribute__((target(isa)))
+#else // !defined(__GNUC__)
+#define CPUIDPP_TARGET(isa)
+#endif // defined(__GNUC__)
+
+namespace cpuidpp {
+
+namespace {
+
+//! Smallest non-temporal threshold (the default of glibc).
+constexpr std::size_t MinNonTemporalThreshold = 0x4040;
+//! Share of the last level cache assumed without any cache information.
+constexpr std::size_t DefaultCacheShare = 1024 * 1024;
+
+using copy_function = void (*)(unsigned char* dst, const unsigned char* src,
+                               std::size_t n);
+using fill_function = void (*)(unsigned char* dst, int value, std::size_t n);
+
+//! Non-temporal copy and fill of a single vector width.
+struct StreamKernels
+{
+    copy_function copy;
+    fill_function fill;
+};
+
+//! Number of bytes to the next multiple of @p alignment starting at @p p.
+std::size_t misalignment(const unsigned char* p, std::size_t alignment)
+{
+    return (alignment - reinterpret_cast<std::uintptr_t>(p) % alignment) %
+        alignment;
+}
+
+void generic_copy(unsigned char* dst, const unsigned char* src, std::size_t n)
+{
+    std::memcpy(dst, src, n);
+}
+
+void generic_fill(unsigned char* dst, int value, std::size_t n)
+{
+    std::memset(dst, value, n);
+}
+
+CPUIDPP_TARGET("sse2")
+void stream_copy_sse2(unsigned char* dst, const unsigned char* src,
+                      std::size_t n)
+{
+    const std::size_t head = misalignment(dst, 16);
+
+    std::memcpy(dst, src, head);
+    dst += head;
+    src += head;
+    n -= head;
+
+    for (; n >= 64; n -= 64, dst += 64, src += 64) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48));
+
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst), a);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 16), b);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 32), c);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 48), d);
+    }
+
+    // Order the weakly ordered stores before any subsequent store
+    _mm_sfence();
+    std::memcpy(dst, src, n);
+}
+
+CPUIDPP_TARGET("sse2")
+void stream_fill_sse2(unsigned char* dst, int value, std::size_t n)
+{
+    const std::size_t head = misalignment(dst, 16);
+    const __m128i v = _mm_set1_epi8(static_cast<char>(value));
+
+    std::memset(dst, value, head);
+    dst += head;
+    n -= head;
+
+    for (; n >= 64; n -= 64, dst += 64) {
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst), v);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 16), v);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 32), v);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 48), v);
+    }
+
+    _mm_sfence();
+    std::memset(dst, value, n);
+}
+
+CPUIDPP_TARGET("avx")
+void stream_copy_avx(unsigned char* dst, const unsigned char* src,
+                     std::size_t n)
+{
+    const std::size_t head = misalignment(dst, 32);
+
+    std::memcpy(dst, src, head);
+    dst += head;
+    src += head;
+    n -= head;
+
+    for (; n >= 128; n -= 128, dst += 128, src += 128) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32));
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 64));
+        const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 96));
+
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst), a);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 32), b);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 64), c);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 96), d);
+    }
+
+    _mm_sfence();
+    std::memcpy(dst, src, n);
+}
+
+CPUIDPP_TARGET("avx")
+void stream_fill_avx(unsigned char* dst, int value, std::size_t n)
+{
+    const std::size_t head = misalignment(dst, 32);
+    const __m256i v = _mm256_set1_epi8(static_cast<char>(value));
+
+    std::memset(dst, value, head);
+    dst += head;
+    n -= head;
+
+    for (; n >= 128; n -= 128, dst += 128) {
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst), v);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 32), v);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 64), v);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 96), v);
+    }
+
+    _mm_sfence();
+    std::memset(dst, value, n);
+}
+
+CPUIDPP_TARGET("avx512f")
+void stream_copy_avx512(unsigned char* dst, const unsigned char* src,
+                        std::size_t n)
+{
+    const std::size_t head = misalignment(dst, 64);
+
+    std::memcpy(dst, src, head);
+    dst += head;
+    src += head;
+    n -= head;
+
+    for (; n >= 256; n -= 256, dst += 256, src += 256) {
+        const __m512i a = _mm512_loadu_si512(src);
+        const __m512i b = _mm512_loadu_si512(src + 64);
+        const __m512i c = _mm512_loadu_si512(src + 128);
+        const __m512i d = _mm512_loadu_si512(src + 192);
+
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dst), a);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dst + 64), b);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dst + 128), c);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dst + 192), d);
+    }
+
+    _mm_sfence();
+    std::memcpy(dst, src, n);
+}
+
+CPUIDPP_TARGET("avx512f")
+void stream_fill_avx512(unsigned char* dst, int value, std::size_t n)
+{
+    const std::size_t head = misalignment(dst, 64);
+    const __m512i v = _mm512_set1_epi32(static_cast<int>(
+        (static_cast<unsigned>(value) & 0xffU) * 0x01010101U));
+
+    std::memset(dst, value, head);
+    dst += head;
+    n -= head;
+
+    for (; n >= 256; n -= 256, dst += 256) {
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dst), v);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dst + 64), v);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dst + 128), v);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dst + 192), v);
+    }
+
+    _mm_sfence();
+    std::memset(dst, value, n);
+}
+
+void rep_movsb(unsigned char* dst, const unsigned char* src, std::size_t n)
+{
+#if defined(_MSC_VER)
+    __movsb(dst, src, n);
+#else // !defined(_MSC_VER)
+    __asm__ __volatile__("rep movsb"
+                         : "+D"(dst), "+S"(src), "+c"(n)
+                         :
+                         : "memory");
+#endif // defined(_MSC_VER)
+}
+
+void rep_stosb(unsigned char* dst, int value, std::size_t n)
+{
+#if defined(_MSC_VER)
+    __stosb(dst, static_cast<unsigned char>(value), n);
+#else // !defined(_MSC_VER)
+    __asm__ __volatile__("rep stosb"
+                         : "+D"(dst), "+c"(n)
+                         : "a"(value)
+                         : "memory");
+#endif // defined(_MSC_VER)
+}
+
+const StreamKernels generic_kernels{generic_copy, generic_fill};
+const StreamKernels sse2_kernels{stream_copy_sse2, stream_fill_sse2};
+const StreamKernels avx_kernels{stream_copy_avx, stream_fill_avx};
+const StreamKernels avx512_kernels{stream_copy_avx512, stream_fill_avx512};
+
+/**
+ * @brief Plans the strategy of the current processor.
+ *
+ * The cache enumeration allocates. If it fails, the strategy is planned
+ * without any cache information rather than letting the exception escape the
+ * @c noexcept callers.
+ */
+memory_strategy plan_current() noexcept
+{
+    try {
+        return plan_memory_operations(features(), cache_info());
+    }
+    catch (...) {
+        return plan_memory_operations(features(), std::vector<cache>{});
+    }
+}
+
+//! Strategy along with the kernels selected for the current processor.
+struct MemoryOperations
+{
+    MemoryOperations() noexcept
+        : strategy{plan_current()}
+        , kernels{
+            {&avx512_kernels, {&snapshot::avx512f_usable}},
+            {&avx_kernels, {&snapshot::avx_usable}},
+            {&sse2_kernels, {&snapshot::sse2}},
+            {&generic_kernels, {}}
+        }
+    {
+    }
+
+    const memory_strategy strategy;
+    const dispatch_table<StreamKernels> kernels;
+};
+
+const MemoryOperations& current() noexcept
+{
+    static const MemoryOperations instance;
+    return instance;
+}
+
+} // namespace
+
+memory_strategy plan_memory_operations(const snapshot& s,
+                                       const std::vector<cache>& caches) noexcept
+{
+    memory_strategy result{};
+
+    result.erms = s.erms();
+    result.fsrm = s.fsrm();
+    result.fzrm = s.fzrm();
+    result.fsrs = s.fsrs();
+    result.fsrc = s.fsrc();
+
+    // Must match the kernels selected by MemoryOperations
+    result.vector_bytes = s.avx512f_usable() ? 64
+        : s.avx_usable() ? 32
+        : s.sse2() ? 16
+        : 0;
+
+    if (result.erms) {
+        result.rep_movsb_threshold = result.fsrm ? 2112
+            : 2048 * (result.vector_bytes < 16 ? 1 : result.vector_bytes / 16);
+        result.rep_stosb_threshold = 2048;
+    }
+
+    if (result.vector_bytes == 0) {
+        result.non_temporal_threshold = std::numeric_limits<std::size_t>::max();
+        return result;
+    }
+
+    const cache* last = nullptr;
+
+    for (const cache& c : caches) {
+        if (c.type != cache_type::instruction &&
+            (last == nullptr || c.level > last->level)) {
+            last = &c;
+        }
+    }
+
+    const std::size_t share = last != nullptr
+        ? last->size / (last->shared_by != 0 ? last->shared_by : 1)
+        : DefaultCacheShare;
+
+    result.non_temporal_threshold = share / 4 * 3;
+
+    if (result.non_temporal_threshold < MinNonTemporalThreshold) {
+        result.non_temporal_threshold = MinNonTemporalThreshold;
+    }
+
+    return result;
+}
+
+const memory_strategy& memory_operations() noexcept
+{
+    return current().strategy;
+}
+
+void* copy(void* dst, const void* src, std::size_t n) noexcept
+{
+    const MemoryOperations& ops = current();
+    unsigned char* const d = static_cast<unsigned char*>(dst);
+    const unsigned char* const s = static_cast<const unsigned char*>(src);
+
+    if (n >= ops.strategy.non_temporal_threshold) {
+        ops.kernels->copy(d, s, n);
+    }
+    else if (ops.strategy.erms && n >= ops.strategy.rep_movsb_threshold) {
+        rep_movsb(d, s, n);
+    }
+    else {
+        std::memcpy(d, s, n);
+    }
+
+    return dst;
+}
+
+void* fill(void* dst, int value, std::size_t n) noexcept
+{
+    const MemoryOperations& ops = current();
+    unsigned char* const d = static_cast<unsigned char*>(dst);
+
+    if (n >= ops.strategy.non_temporal_threshold) {
+        ops.kernels->fill(d, value, n);
+    }
+    else if (ops.strategy.erms && n >= ops.strategy.rep_stosb_threshold) {
+        rep_stosb(d, value, n);
+    }
+    else {
+        std::memset(d, value, n);
+    }
+
+    return dst;
+}
+
+} // namespace cpuidpp
@@ -0,0 +1,617 @@
+/**
+ * @brief %cpuidpp performance monitoring enumeration and region profiler
+ *        implementation.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <cpuidpp/cpuidpp.hpp>
+#include <cpuidpp/pmu.hpp>
+#include <cpuidpp/source.hpp>
+
+#include "cpuid.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(HAVE_PERF_EVENT_OPEN) && defined(HAVE_MMAP)
+#define CPUIDPP_HAVE_RDPMC
+#include <linux/perf_event.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif // defined(HAVE_PERF_EVENT_OPEN) && defined(HAVE_MMAP)
+
+namespace cpuidpp {
+
+namespace {
+
+pmu_info query_pmu(const snapshot& s, const cpuid_source* source)
+{
+    pmu_info result{};
+
+    result.perfctr_core = s.perfctr_core();
+    result.perfctr_nb = s.perfctr_nb();
+
+    unsigned info[4] = {};
+
+    if (std::memcmp(s.vendor_id, "AuthenticAMD", 12) == 0) {
+        result.general_counters = result.perfctr_core ? 6 : 4;
+        result.general_width = 48;
+
+        if (s.max_extended_leaf >= 0x80000022) {
+            // EAX=0x80000022
+            detail::cpuid(source, info, 0x80000022);
+
+            // PerfMonV2
+            if ((info[0] & 1U) != 0) {
+                result.version = 2;
+                result.general_counters = info[1] & 0xfU;
+            }
+        }
+
+        return result;
+    }
+
+    if (s.max_leaf < 0xA) {
+        return result;
+    }
+
+    // EAX=0xA
+    detail::cpuid(source, info, 0xA);
+
+    result.version = info[0] & 0xffU;
+
+    if (result.version == 0) {
+        return result;
+    }
+
+    result.general_counters = (info[0] >> 8U) & 0xffU;
+    result.general_width = (info[0] >> 16U) & 0xffU;
+
+    // EBX flags the events which are not available among the first
+    // EAX[31:24] ones
+    const unsigned length = std::min(info[0] >> 24U, 32U);
+    const std::uint32_t enumerated = length == 32
+        ? ~std::uint32_t{0} : (std::uint32_t{1} << length) - 1;
+
+    result.events = ~info[1] & enumerated;
+
+    if (result.version > 1) {
+        result.fixed_counters = info[3] & 0x1fU;
+        result.fixed_width = (info[3] >> 5U) & 0xffU;
+    }
+
+    return result;
+}
+
+//! Open counter along with its control page.
+struct Counter
+{
+    int fd;
+    const void* page;
+};
+
+//! Measurements of a region accumulated by a single thread.
+struct RegionSlot
+{
+    std::atomic<std::uint64_t> calls;
+    std::atomic<std::uint64_t> ticks;
+    std::atomic<std::uint64_t> counts[profiler::max_counters];
+};
+
+/**
+ * @brief Counters and measurements of a single thread.
+ *
+ * Only the owning thread writes the slots. Since there is a single writer,
+ * the slots are updated by separate relaxed loads and stores rather than
+ * locked read-modify-write instructions.
+ */
+struct ThreadState
+{
+    Counter counters[profiler::max_counters];
+    std::size_t count;
+    bool available;
+    RegionSlot regions[profiler::max_regions];
+
+    ThreadState()
+        : counters{}
+        , count{0}
+        , available{false}
+        , regions{}
+    {
+    }
+
+    ~ThreadState()
+    {
+        close();
+    }
+
+    ThreadState(const ThreadState&) = delete;
+    ThreadState& operator=(const ThreadState&) = delete;
+
+    void open(const std::vector<perf_counter>& events);
+    void close() noexcept;
+    void read(std::uint64_t* values) const noexcept;
+
+    void add(std::size_t region, std::uint64_t ticks,
+             const std::uint64_t* counts) noexcept
+    {
+        RegionSlot& slot = regions[region];
+
+        const auto accumulate = [](std::atomic<std::uint64_t>& value,
+                                   std::uint64_t delta)
+        {
+            value.store(value.load(std::memory_order_relaxed) + delta,
+                        std::memory_order_relaxed);
+        };
+
+        accumulate(slot.calls, 1);
+        accumulate(slot.ticks, ticks);
+
+        for (std::size_t i = 0; i != count; ++i) {
+            accumulate(slot.counts[i], counts[i]);
+        }
+    }
+};
+
+#if defined(CPUIDPP_HAVE_RDPMC)
+std::uint64_t event_config(perf_counter counter) noexcept
+{
+    switch (counter) {
+        case perf_counter::cycles:
+            return PERF_COUNT_HW_CPU_CYCLES;
+        case perf_counter::instructions:
+            return PERF_COUNT_HW_INSTRUCTIONS;
+        case perf_counter::cache_references:
+            return PERF_COUNT_HW_CACHE_REFERENCES;
+        case perf_counter::cache_misses:
+            return PERF_COUNT_HW_CACHE_MISSES;
+        case perf_counter::branch_instructions:
+            return PERF_COUNT_HW_BRANCH_INSTRUCTIONS;
+        case perf_counter::branch_misses:
+            return PERF_COUNT_HW_BRANCH_MISSES;
+    }
+
+    return PERF_COUNT_HW_CPU_CYCLES;
+}
+
+std::uint64_t rdpmc(std::uint32_t index) noexcept
+{
+    std::uint32_t low;
+    std::uint32_t high;
+
+    __asm__ __volatile__ ("rdpmc" : "=a" (low), "=d" (high) : "c" (index));
+
+    return (std::uint64_t{high} << 32U) | low;
+}
+
+/**
+ * @brief Reads the counter using @c RDPMC.
+ *
+ * The kernel updates the control page whenever the counter is scheduled. The
+ * sequence number detects concurrent updates. A zero index indicates that the
+ * counter is not currently loaded into a hardware register in which case the
+ * kernel provides the value.
+ */
+std::uint64_t read_counter(const Counter& c) noexcept
+{
+    const volatile perf_event_mmap_page* const pc =
+        static_cast<const volatile perf_event_mmap_page*>(c.page);
+
+    std::uint32_t sequence;
+    std::uint64_t value;
+
+    do {
+        sequence = pc->lock;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+
+        const std::uint32_t index = pc->index;
+
+        if (!pc->cap_user_rdpmc || index == 0 || pc->pmc_width == 0) {
+            value = 0;
+
+            if (::read(c.fd, &value, sizeof value) != sizeof value) {
+                value = 0;
+            }
+
+            return value;
+        }
+
+        // Sign-extend the counter to 64 bits
+        const unsigned shift = 64U - pc->pmc_width;
+        const std::int64_t count =
+            static_cast<std::int64_t>(rdpmc(index - 1) << shift) >> shift;
+
+        value = static_cast<std::uint64_t>(pc->offset + count);
+
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    } while (pc->lock != sequence);
+
+    return value;
+}
+#endif // defined(CPUIDPP_HAVE_RDPMC)
+
+void ThreadState::open(const std::vector<perf_counter>& events)
+{
+#if defined(CPUIDPP_HAVE_RDPMC)
+    const long page_size = ::sysconf(_SC_PAGESIZE);
+    const std::size_t n = std::min(events.size(), profiler::max_counters);
+
+    for (count = 0; count != n; ++count) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof attr);
+
+        attr.size = sizeof attr;
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = event_config(events[count]);
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        // Count the calling thread on any processor
+        const int fd = static_cast<int>(::syscall(__NR_perf_event_open, &attr,
+            0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+
+        if (fd < 0) {
+            break;
+        }
+
+        void* const page = ::mmap(nullptr, static_cast<std::size_t>(page_size),
+                                  PROT_READ, MAP_SHARED, fd, 0);
+
+        if (page == MAP_FAILED) {
+            ::close(fd);
+            break;
+        }
+
+        counters[count] = Counter{fd, page};
+    }
+
+    available = count == n && n != 0;
+
+    if (!available) {
+        close();
+    }
+#else // !defined(CPUIDPP_HAVE_RDPMC)
+    static_cast<void>(events);
+#endif // defined(CPUIDPP_HAVE_RDPMC)
+}
+
+void ThreadState::close() noexcept
+{
+#if defined(CPUIDPP_HAVE_RDPMC)
+    const long page_size = ::sysconf(_SC_PAGESIZE);
+
+    for (std::size_t i = 0; i != count; ++i) {
+        ::munmap(const_cast<void*>(counters[i].page),
+                 static_cast<std::size_t>(page_size));
+        ::close(counters[i].fd);
+    }
+#endif // defined(CPUIDPP_HAVE_RDPMC)
+
+    count = 0;
+    available = false;
+}
+
+void ThreadState::read(std::uint64_t* values) const noexcept
+{
+#if defined(CPUIDPP_HAVE_RDPMC)
+    for (std::size_t i = 0; i != count; ++i) {
+        values[i] = read_counter(counters[i]);
+    }
+#else // !defined(CPUIDPP_HAVE_RDPMC)
+    static_cast<void>(values);
+#endif // defined(CPUIDPP_HAVE_RDPMC)
+}
+
+/**
+ * @brief Thread states of a profiler shared with the threads which used it.
+ *
+ * A thread keeps only a weak reference to the registry such that the profiler
+ * can be destroyed before the thread exits.
+ */
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadState>> threads;
+    // Measurements of the threads which have exited
+    ThreadState retired;
+
+    //! Moves the measurements of @p state to @ref retired and releases it.
+    void retire(const ThreadState* state) noexcept
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+
+        const auto pos = std::find_if(threads.begin(), threads.end(),
+            [state](const std::unique_ptr<ThreadState>& thread)
+            {
+                return thread.get() == state;
+            });
+
+        if (pos == threads.end()) {
+            return;
+        }
+
+        const auto merge = [](std::atomic<std::uint64_t>& value,
+                              const std::atomic<std::uint64_t>& delta)
+        {
+            value.store(value.load(std::memory_order_relaxed) +
+                        delta.load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+        };
+
+        for (std::size_t r = 0; r != profiler::max_regions; ++r) {
+            RegionSlot& slot = retired.regions[r];
+            const RegionSlot& other = state->regions[r];
+
+            merge(slot.calls, other.calls);
+            merge(slot.ticks, other.ticks);
+
+            for (std::size_t i = 0; i != state->count; ++i) {
+                merge(slot.counts[i], other.counts[i]);
+            }
+        }
+
+        // Closes the counters
+        threads.erase(pos);
+    }
+};
+
+//! Source of the profiler identifiers which are never reused.
+std::atomic<std::uint64_t> next_profiler_id{1};
+
+/**
+ * @brief Thread states created by the calling thread.
+ *
+ * The states are retired once the thread exits. Thread identifiers cannot be
+ * used to find the states since they are reused after a thread is joined.
+ */
+class ThreadOwner
+{
+public:
+    ThreadOwner() = default;
+
+    ~ThreadOwner()
+    {
+        for (const Entry& entry : entries_) {
+            if (const std::shared_ptr<Registry> registry =
+                    entry.registry.lock()) {
+                registry->retire(entry.state);
+            }
+        }
+    }
+
+    ThreadOwner(const ThreadOwner&) = delete;
+    ThreadOwner& operator=(const ThreadOwner&) = delete;
+
+    //! Returns the state of the profiler @p id or @c nullptr.
+    ThreadState* find(std::uint64_t id) const noexcept
+    {
+        for (const Entry& entry : entries_) {
+            if (entry.id == id) {
+                return entry.state;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void add(std::uint64_t id, const std::shared_ptr<Registry>& registry,
+             ThreadState* state)
+    {
+        // Forget the profilers which have been destroyed
+        entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+            [](const Entry& entry)
+            {
+                return entry.registry.expired();
+            }), entries_.end());
+
+        entries_.push_back(Entry{id, registry, state});
+    }
+
+private:
+    struct Entry
+    {
+        std::uint64_t id;
+        std::weak_ptr<Registry> registry;
+        ThreadState* state;
+    };
+
+    std::vector<Entry> entries_;
+};
+
+thread_local ThreadOwner thread_owner;
+
+//! Thread state of the profiler most recently used by the thread.
+struct CachedState
+{
+    std::uint64_t id;
+    ThreadState* state;
+};
+
+thread_local CachedState cached_state{0, nullptr};
+
+} // namespace
+
+const pmu_info& pmu_capabilities()
+{
+    static const pmu_info instance =
+        query_pmu(features(), detail::active_source());
+    return instance;
+}
+
+pmu_info pmu_capabilities(const cpuid_source& source)
+{
+    snapshot s;
+    detect(s, source);
+
+    return query_pmu(s, &source);
+}
+
+struct profiler::impl
+{
+    std::uint64_t id;
+    std::vector<perf_counter> counters;
+    mutable std::mutex mutex;
+    std::vector<std::string> names;
+    // Number of registered regions readable without locking
+    std::atomic<std::size_t> regions{0};
+    std::shared_ptr<Registry> registry{std::make_shared<Registry>()};
+
+    //! Returns the state of the calling thread, creating it on first use.
+    ThreadState& local()
+    {
+        if (cached_state.id == id) {
+            return *cached_state.state;
+        }
+
+        ThreadState* state = thread_owner.find(id);
+
+        if (state == nullptr) {
+            std::unique_ptr<ThreadState> created{new ThreadState};
+            created->open(counters);
+
+            state = created.get();
+
+            {
+                std::lock_guard<std::mutex> lock{registry->mutex};
+                registry->threads.push_back(std::move(created));
+            }
+
+            try {
+                thread_owner.add(id, registry, state);
+            }
+            catch (...) {
+                registry->retire(state);
+                throw;
+            }
+        }
+
+        cached_state = CachedState{id, state};
+
+        return *state;
+    }
+};
+
+constexpr std::size_t profiler::max_regions;
+constexpr std::size_t profiler::max_counters;
+
+profiler::profiler(std::vector<perf_counter> counters)
+    : impl_{new impl}
+{
+    if (counters.size() > max_counters) {
+        counters.resize(max_counters);
+    }
+
+    impl_->id = next_profiler_id.fetch_add(1, std::memory_order_relaxed);
+    impl_->counters = std::move(counters);
+}
+
+profiler::~profiler() = default;
+
+const std::vector<perf_counter>& profiler::counters() const noexcept
+{
+    return impl_->counters;
+}
+
+std::size_t profiler::region(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock{impl_->mutex};
+
+    if (impl_->names.size() == max_regions) {
+        throw std::length_error{"too many profiler regions"};
+    }
+
+    impl_->names.push_back(name);
+    impl_->regions.store(impl_->names.size(), std::memory_order_release);
+
+    return impl_->names.size() - 1;
+}
+
+bool profiler::available()
+{
+    return impl_->local().available;
+}
+
+std::vector<region_statistics> profiler::statistics() const
+{
+    std::lock_guard<std::mutex> lock{impl_->mutex};
+
+    Registry& registry = *impl_->registry;
+    std::lock_guard<std::mutex> threads_lock{registry.mutex};
+
+    std::vector<region_statistics> result(impl_->names.size());
+
+    for (std::size_t r = 0; r != result.size(); ++r) {
+        region_statistics& stats = result[r];
+
+        stats.name = impl_->names[r];
+        stats.calls = 0;
+        stats.ticks = 0;
+        stats.counts.assign(impl_->counters.size(), 0);
+
+        const RegionSlot& retired = registry.retired.regions[r];
+
+        stats.calls += retired.calls.load(std::memory_order_relaxed);
+        stats.ticks += retired.ticks.load(std::memory_order_relaxed);
+
+        for (std::size_t i = 0; i != stats.counts.size(); ++i) {
+            stats.counts[i] += retired.counts[i].load(std::memory_order_relaxed);
+        }
+
+        for (const std::unique_ptr<ThreadState>& thread : registry.threads) {
+            const RegionSlot& slot = thread->regions[r];
+
+            stats.calls += slot.calls.load(std::memory_order_relaxed);
+            stats.ticks += slot.ticks.load(std::memory_order_relaxed);
+
+            for (std::size_t i = 0; i != thread->count; ++i) {
+                stats.counts[i] +=
+                    slot.counts[i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    return result;
+}
+
+profiler::scope::scope(profiler& p, std::size_t region)
+    : state_{nullptr}
+    , region_{region}
+    , ticks_{0}
+    , counts_{}
+{
+    if (region >= p.impl_->regions.load(std::memory_order_acquire)) {
+        throw std::out_of_range{"unregistered profiler region"};
+    }
+
+    state_ = &p.impl_->local();
+    static_cast<ThreadState*>(state_)->read(counts_);
+    ticks_ = __rdtsc();
+}
+
+profiler::scope::~scope()
+{
+    const std::uint64_t ticks = __rdtsc() - ticks_;
+    ThreadState* const state = static_cast<ThreadState*>(state_);
+
+    std::uint64_t counts[max_counters];
+    state->read(counts);
+
+    for (std::size_t i = 0; i != state->count; ++i) {
+        counts[i] -= counts_[i];
+    }
+
+    state->add(region_, ticks, counts);
+}
+
+} // namespace cpuidpp
@@ -0,0 +1,88 @@
+/**
+ * @brief %cpuidpp thermal and power management enumeration implementation.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <cpuidpp/cpuidpp.hpp>
+#include <cpuidpp/power.hpp>
+#include <cpuidpp/source.hpp>
+
+#include "cpuid.hpp"
+
+namespace cpuidpp {
+
+namespace {
+
+constexpr bool bit(unsigned value, unsigned index) noexcept
+{
+    return ((value >> index) & 1U) != 0;
+}
+
+power_info query_power(const snapshot& s, const cpuid_source* source)
+{
+    power_info result{};
+
+    if (s.max_leaf >= 6) {
+        unsigned info[4] = {};
+        // EAX=6
+        detail::cpuid(source, info, 6);
+
+        result.digital_thermal_sensor = bit(info[0], 0);
+        result.turbo = bit(info[0], 1);
+        result.arat = bit(info[0], 2);
+        result.power_limit_notification = bit(info[0], 4);
+        result.package_thermal = bit(info[0], 6);
+        result.hwp = bit(info[0], 7);
+        result.hwp_notification = bit(info[0], 8);
+        result.hwp_activity_window = bit(info[0], 9);
+        result.hwp_epp = bit(info[0], 10);
+        result.hwp_package_request = bit(info[0], 11);
+        result.hdc = bit(info[0], 13);
+        result.turbo_max = bit(info[0], 14);
+        result.hardware_feedback = bit(info[0], 19);
+        result.thread_director = bit(info[0], 23);
+
+        result.thermal_thresholds = info[1] & 0xfU;
+
+        result.aperf_mperf = bit(info[2], 0);
+        result.energy_perf_bias = bit(info[2], 3);
+
+        if (result.thread_director) {
+            result.thread_director_classes = (info[2] >> 8U) & 0xffU;
+        }
+    }
+
+    // EAX=0x80000007 has already been captured by the snapshot
+    const unsigned apm = s.words[snapshot::leaf80000007_edx];
+
+    result.hw_pstate = bit(apm, 7);
+    result.invariant_tsc = bit(apm, 8);
+    result.core_performance_boost = bit(apm, 9);
+    result.eff_freq_read_only = bit(apm, 10);
+    result.power_reporting = bit(apm, 12);
+
+    return result;
+}
+
+} // namespace
+
+const power_info& power_capabilities()
+{
+    static const power_info instance =
+        query_power(features(), detail::active_source());
+    return instance;
+}
+
+power_info power_capabilities(const cpuid_source& source)
+{
+    snapshot s;
+    detect(s, source);
+
+    return query_power(s, &source);
+}
+
+} // namespace cpuidpp
@@ -0,0 +1,127 @@
+/**
+ * @brief %cpuidpp Resource Director Technology enumeration implementation.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <cpuidpp/cpuidpp.hpp>
+#include <cpuidpp/rdt.hpp>
+#include <cpuidpp/source.hpp>
+
+#include "cpuid.hpp"
+
+namespace cpuidpp {
+
+namespace {
+
+//! Resource types reported by leaf 0x10 subleaf 0 @c EBX.
+constexpr unsigned L3Allocation = 1;
+constexpr unsigned L2Allocation = 2;
+constexpr unsigned BandwidthAllocation = 3;
+
+//! Throttling values are percentages.
+constexpr unsigned MaxBandwidth = 100;
+
+rdt_cache_allocation query_cache_allocation(const cpuid_source* source,
+                                            unsigned subleaf)
+{
+    rdt_cache_allocation result{};
+    unsigned info[4] = {};
+
+    // EAX=0x10 ECX=subleaf
+    detail::cpuidex(source, info, 0x10, subleaf);
+
+    result.supported = true;
+    result.ways = (info[0] & 0x1fU) + 1;
+    result.shared_ways = info[1];
+    result.cdp = ((info[2] >> 2U) & 1U) != 0;
+    result.noncontiguous = ((info[2] >> 3U) & 1U) != 0;
+    result.classes = (info[3] & 0xffffU) + 1;
+
+    return result;
+}
+
+rdt_info query_rdt(const snapshot& s, const cpuid_source* source)
+{
+    rdt_info result{};
+    unsigned info[4] = {};
+
+    if (s.pqm() && s.max_leaf >= 0xF) {
+        rdt_monitoring& m = result.monitoring;
+
+        // EAX=0xF ECX=0
+        detail::cpuidex(source, info, 0xF, 0);
+
+        m.max_rmid = info[1];
+        m.l3 = ((info[3] >> 1U) & 1U) != 0;
+
+        if (m.l3) {
+            // EAX=0xF ECX=1
+            detail::cpuidex(source, info, 0xF, 1);
+
+            m.counter_width = 24 + (info[0] & 0xffU);
+            m.overflow_bit = ((info[0] >> 8U) & 1U) != 0;
+            m.upscaling_factor = info[1];
+            m.l3_max_rmid = info[2];
+            m.l3_occupancy = (info[3] & 1U) != 0;
+            m.total_bandwidth = ((info[3] >> 1U) & 1U) != 0;
+            m.local_bandwidth = ((info[3] >> 2U) & 1U) != 0;
+        }
+    }
+
+    if (s.pqe() && s.max_leaf >= 0x10) {
+        // EAX=0x10 ECX=0
+        detail::cpuidex(source, info, 0x10, 0);
+
+        const unsigned resources = info[1];
+
+        if (((resources >> L3Allocation) & 1U) != 0) {
+            result.l3 = query_cache_allocation(source, L3Allocation);
+        }
+
+        if (((resources >> L2Allocation) & 1U) != 0) {
+            result.l2 = query_cache_allocation(source, L2Allocation);
+        }
+
+        if (((resources >> BandwidthAllocation) & 1U) != 0) {
+            rdt_bandwidth_allocation& b = result.bandwidth;
+
+            // EAX=0x10 ECX=3
+            detail::cpuidex(source, info, 0x10, BandwidthAllocation);
+
+            b.supported = true;
+            b.max_throttle = (info[0] & 0xfffU) + 1;
+            b.linear = ((info[2] >> 2U) & 1U) != 0;
+            b.classes = (info[3] & 0xffffU) + 1;
+
+            // resctrl accepts multiples of the smallest throttling step
+            if (b.linear && b.max_throttle < MaxBandwidth) {
+                b.granularity = MaxBandwidth - b.max_throttle;
+            }
+        }
+    }
+
+    return result;
+}
+
+} // namespace
+
+const rdt_info& rdt_capabilities()
+{
+    static const rdt_info instance =
+        query_rdt(features(), detail::active_source());
+    return instance;
+}
+
+rdt_info rdt_capabilities(const cpuid_source& source)
+{
+    snapshot s;
+    detect(s, source);
+
+    return query_rdt(s, &source);
+}
+
+} // namespace cpuidpp
@@ -0,0 +1,116 @@
+/**
+ * @brief %cpuidpp pluggable CPUID sources implementation.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <cpuidpp/dump.hpp>
+#include <cpuidpp/source.hpp>
+
+#include "cpuid.hpp"
+
+#include <cstring>
+#include <utility>
+
+namespace cpuidpp {
+
+namespace {
+
+/**
+ * @brief Executes @c CPUID on the calling thread.
+ *
+ * The processor index is ignored. Callers querying a specific processor pin
+ * the thread to it beforehand.
+ */
+class HardwareSource final : public cpuid_source
+{
+public:
+    void query(std::uint32_t /*cpu*/, std::uint32_t leaf,
+               std::uint32_t subleaf,
+               std::uint32_t (&regs)[4]) const override
+    {
+        unsigned info[4] = {};
+        detail::execute_cpuidex(info, leaf, subleaf);
+        std::memcpy(regs, info, sizeof regs);
+    }
+
+    std::uint64_t xcr0() const override
+    {
+        unsigned info[4] = {};
+        detail::execute_cpuid(info, 0);
+
+        if (info[0] < 1) {
+            return 0;
+        }
+
+        detail::execute_cpuid(info, 1);
+
+        // XGETBV faults unless the OS has enabled XSAVE
+        return ((info[2] >> 27U) & 1U) != 0 ? detail::xgetbv(0) : 0;
+    }
+
+    std::vector<std::uint32_t> cpus() const override
+    {
+        return std::vector<std::uint32_t>{};
+    }
+};
+
+} // namespace
+
+constexpr std::uint32_t cpuid_source::any_cpu;
+
+cpuid_source::~cpuid_source() = default;
+
+const cpuid_source& hardware_cpuid() noexcept
+{
+    static const HardwareSource instance;
+    return instance;
+}
+
+cpuid_recorder::cpuid_recorder(const cpuid_source& source)
+    : source_(source)
+{
+}
+
+void cpuid_recorder::query(std::uint32_t cpu, std::uint32_t leaf,
+                           std::uint32_t subleaf,
+                           std::uint32_t (&regs)[4]) const
+{
+    source_.query(cpu, leaf, subleaf, regs);
+
+    cpuid_record r{};
+    r.cpu = cpu;
+    r.leaf = leaf;
+    r.subleaf = subleaf;
+    std::memcpy(r.regs, regs, sizeof r.regs);
+
+    const std::lock_guard<std::mutex> lock{mutex_};
+    records_.push_back(r);
+}
+
+std::uint64_t cpuid_recorder::xcr0() const
+{
+    return source_.xcr0();
+}
+
+std::vector<std::uint32_t> cpuid_recorder::cpus() const
+{
+    return source_.cpus();
+}
+
+cpuid_dump cpuid_recorder::dump() const
+{
+    std::vector<cpuid_record> records;
+
+    {
+        const std::lock_guard<std::mutex> lock{mutex_};
+        records = records_;
+    }
+
+    return cpuid_dump{std::move(records), source_.xcr0()};
+}
+
+} // namespace cpuidpp
@@ -0,0 +1,157 @@
+/**
+ * @brief %cpuidpp instrumentation of CPUID executions implementation.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <cpuidpp/statistics.hpp>
+
+#include "cpuid.hpp"
+
+#include <cstdlib>
+
+namespace cpuidpp {
+
+namespace {
+
+// Counters of the basic, hypervisor and extended leaves followed by a single
+// counter of all other leaves
+constexpr unsigned BasicLeaves = 0x100;
+constexpr unsigned HypervisorLeaves = 0x200;
+constexpr unsigned ExtendedLeaves = 0x100;
+constexpr unsigned SlotCount =
+    BasicLeaves + HypervisorLeaves + ExtendedLeaves + 1;
+constexpr std::uint32_t OtherLeaves = ~std::uint32_t{0};
+
+struct Counter
+{
+    std::atomic<std::uint64_t> executions;
+    std::atomic<std::uint64_t> total_cycles;
+    std::atomic<std::uint64_t> max_cycles;
+};
+
+// Zero-initialized before any dynamic initialization
+Counter counters[SlotCount];
+
+unsigned slot_of(std::uint32_t leaf) noexcept
+{
+    if (leaf < BasicLeaves) {
+        return leaf;
+    }
+
+    if (leaf - 0x40000000U < HypervisorLeaves) {
+        return BasicLeaves + (leaf - 0x40000000U);
+    }
+
+    if (leaf - 0x80000000U < ExtendedLeaves) {
+        return BasicLeaves + HypervisorLeaves + (leaf - 0x80000000U);
+    }
+
+    return SlotCount - 1;
+}
+
+std::uint32_t leaf_of(unsigned slot) noexcept
+{
+    if (slot < BasicLeaves) {
+        return slot;
+    }
+
+    if (slot < BasicLeaves + HypervisorLeaves) {
+        return 0x40000000U + (slot - BasicLeaves);
+    }
+
+    if (slot < SlotCount - 1) {
+        return 0x80000000U + (slot - BasicLeaves - HypervisorLeaves);
+    }
+
+    return OtherLeaves;
+}
+
+} // namespace
+
+namespace detail {
+
+// Zero-initialized before any dynamic initialization
+std::atomic<bool> statistics_enabled;
+std::atomic<cpuid_hook> installed_hook;
+
+void record_cpuid(unsigned leaf, unsigned subleaf,
+                  std::uint64_t cycles) noexcept
+{
+    if (statistics_enabled.load(std::memory_order_relaxed)) {
+        Counter& c = counters[slot_of(leaf)];
+
+        c.executions.fetch_add(1, std::memory_order_relaxed);
+        c.total_cycles.fetch_add(cycles, std::memory_order_relaxed);
+
+        std::uint64_t max = c.max_cycles.load(std::memory_order_relaxed);
+
+        while (max < cycles &&
+               !c.max_cycles.compare_exchange_weak(max, cycles,
+                   std::memory_order_relaxed)) {
+        }
+    }
+
+    if (const cpuid_hook fn = installed_hook.load(std::memory_order_relaxed)) {
+        fn(leaf, subleaf, cycles);
+    }
+}
+
+void load_environment_statistics() noexcept
+{
+    const char* const value = std::getenv("CPUIDPP_STATISTICS");
+
+    if (value != nullptr && *value != '\0') {
+        enable_cpuid_statistics(true);
+    }
+}
+
+} // namespace detail
+
+void enable_cpuid_statistics(bool enable) noexcept
+{
+    detail::statistics_enabled.store(enable, std::memory_order_relaxed);
+}
+
+bool cpuid_statistics_enabled() noexcept
+{
+    return detail::statistics_enabled.load(std::memory_order_relaxed);
+}
+
+std::vector<leaf_statistics> cpuid_statistics()
+{
+    std::vector<leaf_statistics> result;
+
+    for (unsigned slot = 0; slot != SlotCount; ++slot) {
+        const Counter& c = counters[slot];
+        const std::uint64_t executions =
+            c.executions.load(std::memory_order_relaxed);
+
+        if (executions != 0) {
+            result.push_back(leaf_statistics{leaf_of(slot), executions,
+                c.total_cycles.load(std::memory_order_relaxed),
+                c.max_cycles.load(std::memory_order_relaxed)});
+        }
+    }
+
+    return result;
+}
+
+void reset_cpuid_statistics() noexcept
+{
+    for (Counter& c : counters) {
+        c.executions.store(0, std::memory_order_relaxed);
+        c.total_cycles.store(0, std::memory_order_relaxed);
+        c.max_cycles.store(0, std::memory_order_relaxed);
+    }
+}
+
+void set_cpuid_hook(cpuid_hook hook) noexcept
+{
+    detail::installed_hook.store(hook, std::memory_order_relaxed);
+}
+
+} // namespace cpuidpp
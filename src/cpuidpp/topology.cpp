@@ -0,0 +1,655 @@
+/**
+ * @brief %cpuidpp processor topology implementation.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <cpuidpp/cpuidpp.hpp>
+#include <cpuidpp/source.hpp>
+#include <cpuidpp/topology.hpp>
+
+#include "affinity.hpp"
+#include "cpuid.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+#include <utility>
+
+namespace cpuidpp {
+
+namespace {
+
+/**
+ * @brief Highest subleaf enumerated by the walks over the topology and cache
+ *        leaves.
+ *
+ * Bounds the walks if a source never reports a terminating subleaf. The dump
+ * capture applies the same limit.
+ */
+constexpr unsigned MaxSubleaf = 63;
+
+/**
+ * @brief Queries the topology leaves of a single logical processor.
+ *
+ * The topology leaves report the APIC ID of the executing logical processor.
+ * The queries therefore carry the index of the processor a replayed source
+ * answers them for.
+ */
+struct Query
+{
+    const cpuid_source& source;
+    std::uint32_t cpu;
+
+    void cpuid(unsigned* info, unsigned leaf) const
+    {
+        detail::cpuid(&source, info, leaf, cpu);
+    }
+
+    void cpuidex(unsigned* info, unsigned leaf, unsigned subleaf) const
+    {
+        detail::cpuidex(&source, info, leaf, subleaf, cpu);
+    }
+};
+
+//! Returns the number of bits required to represent @p count distinct values.
+unsigned bit_width(unsigned count)
+{
+    unsigned width = 0;
+
+    while ((1U << width) < count) {
+        ++width;
+    }
+
+    return width;
+}
+
+//! Returns a mask of the @p width lowest bits.
+std::uint32_t low_mask(unsigned width)
+{
+    return width >= 32 ? ~std::uint32_t{0} : (std::uint32_t{1} << width) - 1;
+}
+
+/**
+ * @brief x2APIC ID along with the number of its low bits identifying the
+ *        entities within each topology level.
+ *
+ * The shifts follow the convention of leaf 0x1F: shifting the ID right by the
+ * shift of a level yields the identifier of the enclosing level.
+ */
+struct ApicLayout
+{
+    std::uint32_t apic_id;
+    unsigned smt_shift;
+    unsigned core_shift;
+    unsigned module_shift;
+    unsigned tile_shift;
+    unsigned die_shift;
+    unsigned package_shift;
+};
+
+/**
+ * @brief Enumerates the extended topology leaf 0x1F or 0xB.
+ *
+ * @return @c false if the processor does not support the leaf.
+ */
+bool query_extended_topology(const snapshot& s, const Query& q, unsigned leaf,
+                             ApicLayout& layout)
+{
+    if (s.max_leaf < leaf) {
+        return false;
+    }
+
+    unsigned info[4] = {};
+    // EAX=leaf ECX=0
+    q.cpuidex(info, leaf, 0);
+
+    // A zero EBX indicates an unsupported leaf
+    if (info[1] == 0) {
+        return false;
+    }
+
+    // Level types reported by ECX[15:8]
+    enum { Invalid, SMT, Core, Module, Tile, Die, DieGroup, LevelCount };
+
+    unsigned shifts[LevelCount] = {};
+    unsigned last = 0;
+
+    layout.apic_id = info[3];
+
+    for (unsigned subleaf = 0; subleaf <= MaxSubleaf; ++subleaf) {
+        // EAX=leaf ECX=subleaf
+        q.cpuidex(info, leaf, subleaf);
+
+        const unsigned type = (info[2] >> 8U) & 0xffU;
+
+        if (type == Invalid) {
+            break;
+        }
+
+        last = info[0] & 0x1fU;
+
+        if (type < LevelCount) {
+            shifts[type] = last;
+        }
+    }
+
+    layout.smt_shift = shifts[SMT];
+    layout.core_shift = std::max(shifts[Core], layout.smt_shift);
+    layout.module_shift = std::max(shifts[Module], layout.core_shift);
+    layout.tile_shift = std::max(shifts[Tile], layout.module_shift);
+    layout.die_shift = std::max(shifts[Die], layout.tile_shift);
+    layout.package_shift = std::max(last, layout.die_shift);
+
+    return true;
+}
+
+//! Derives the topology from the initial APIC ID of leaf 1.
+void query_legacy_topology(const snapshot& s, const Query& q, bool amd,
+                           ApicLayout& layout)
+{
+    unsigned info[4] = {};
+    // EAX=1
+    q.cpuid(info, 1);
+
+    layout.apic_id = info[1] >> 24U;
+
+    const unsigned logical = s.htt() ? (info[1] >> 16U) & 0xffU : 1;
+    unsigned cores = 1;
+
+    if (amd && s.max_extended_leaf >= 0x80000008) {
+        // EAX=0x80000008
+        q.cpuid(info, 0x80000008);
+
+        cores = (info[2] & 0xffU) + 1;
+    }
+    else if (!amd && s.max_leaf >= 4) {
+        // EAX=4 ECX=0
+        q.cpuidex(info, 4, 0);
+
+        cores = (info[0] >> 26U) + 1;
+    }
+
+    layout.package_shift = bit_width(std::max(logical, cores));
+    layout.smt_shift = bit_width(std::max(logical / cores, 1U));
+    layout.core_shift = layout.package_shift;
+    layout.module_shift = layout.package_shift;
+    layout.tile_shift = layout.package_shift;
+    layout.die_shift = layout.package_shift;
+}
+
+/**
+ * @brief Determines the number of low APIC ID bits distinguishing the logical
+ *        processors sharing the last level cache.
+ *
+ * @return @c false if the processor does not enumerate its caches.
+ */
+bool query_llc_shift(const snapshot& s, const Query& q, bool amd,
+                     unsigned& shift)
+{
+    unsigned leaf;
+
+    if (amd && s.topoext() && s.max_extended_leaf >= 0x8000001D) {
+        leaf = 0x8000001D;
+    }
+    else if (!amd && s.max_leaf >= 4) {
+        leaf = 4;
+    }
+    else {
+        return false;
+    }
+
+    unsigned info[4] = {};
+    unsigned last_level = 0;
+
+    for (unsigned subleaf = 0; subleaf <= MaxSubleaf; ++subleaf) {
+        // EAX=leaf ECX=subleaf
+        q.cpuidex(info, leaf, subleaf);
+
+        const unsigned type = info[0] & 0x1fU;
+        const unsigned level = (info[0] >> 5U) & 0x7U;
+
+        // No more caches
+        if (type == 0) {
+            break;
+        }
+
+        // Instruction caches do not hold shared data
+        if (type != 2 && level > last_level) {
+            last_level = level;
+            shift = bit_width(((info[0] >> 14U) & 0xfffU) + 1);
+        }
+    }
+
+    return last_level != 0;
+}
+
+//! Queries the topology leaves of the logical processor @p q refers to.
+logical_cpu query_logical_cpu(const snapshot& s, const Query& q)
+{
+    const bool amd = std::memcmp(s.vendor_id, "AuthenticAMD", 12) == 0;
+
+    ApicLayout layout{};
+
+    if (!query_extended_topology(s, q, 0x1F, layout) &&
+        !query_extended_topology(s, q, 0xB, layout)) {
+        query_legacy_topology(s, q, amd, layout);
+    }
+
+    logical_cpu cpu{};
+
+    cpu.apic_id = layout.apic_id;
+    cpu.smt = layout.apic_id & low_mask(layout.smt_shift);
+    cpu.core = layout.apic_id >> layout.smt_shift;
+    cpu.module = layout.apic_id >> layout.core_shift;
+    cpu.die = layout.apic_id >> layout.tile_shift;
+    cpu.package = layout.apic_id >> layout.package_shift;
+
+    unsigned llc_shift = 0;
+
+    cpu.llc = query_llc_shift(s, q, amd, llc_shift)
+        ? layout.apic_id >> llc_shift : cpu.package;
+
+    if (amd && s.topoext() && s.max_extended_leaf >= 0x8000001E) {
+        unsigned info[4] = {};
+        // EAX=0x8000001E
+        q.cpuid(info, 0x8000001E);
+
+        // The node ID is unique across the system
+        cpu.die = info[2] & 0xffU;
+    }
+
+    if (s.hybrid() && s.max_leaf >= 0x1A) {
+        unsigned info[4] = {};
+        // EAX=0x1A ECX=0
+        q.cpuidex(info, 0x1A, 0);
+
+        cpu.type = static_cast<core_type>(info[0] >> 24U);
+        cpu.native_model = info[0] & 0xffffffU;
+    }
+
+    return cpu;
+}
+
+std::vector<logical_cpu> collect_topology(const cpuid_source& source)
+{
+    snapshot s;
+    detect(s, source);
+
+    const std::vector<std::uint32_t> replayed = source.cpus();
+
+    if (!replayed.empty()) {
+        std::vector<logical_cpu> cpus;
+        cpus.reserve(replayed.size());
+
+        for (std::uint32_t index : replayed) {
+            cpus.push_back(query_logical_cpu(s, Query{source, index}));
+            cpus.back().index = index;
+        }
+
+        return cpus;
+    }
+
+    const std::vector<unsigned> indices = detail::available_cpus();
+
+    if (indices.empty()) {
+        return std::vector<logical_cpu>(1,
+            query_logical_cpu(s, Query{source, cpuid_source::any_cpu}));
+    }
+
+    std::vector<logical_cpu> cpus(indices.size());
+
+    const std::vector<bool> invoked = detail::run_on_each(indices,
+        [&s, &source, &cpus, &indices](std::size_t i)
+        {
+            cpus[i] = query_logical_cpu(s, Query{source, indices[i]});
+            cpus[i].index = indices[i];
+        });
+
+    // Drop the logical processors the threads could not be pinned to
+    std::size_t count = 0;
+
+    for (std::size_t i = 0; i != cpus.size(); ++i) {
+        if (invoked[i]) {
+            cpus[count++] = cpus[i];
+        }
+    }
+
+    cpus.resize(count);
+
+    return cpus;
+}
+
+//! Counts the distinct values of @p member among @p cpus.
+std::size_t count_distinct(const std::vector<logical_cpu>& cpus,
+                           std::uint32_t logical_cpu::* member)
+{
+    std::vector<std::uint32_t> ids;
+    ids.reserve(cpus.size());
+
+    for (const logical_cpu& cpu : cpus) {
+        ids.push_back(cpu.*member);
+    }
+
+    std::sort(ids.begin(), ids.end());
+
+    return static_cast<std::size_t>(
+        std::unique(ids.begin(), ids.end()) - ids.begin());
+}
+
+/**
+ * @brief Logical processor ranked for @ref topology::place().
+ *
+ * Domains are numbered in the order of their package and identifier.
+ */
+struct Slot
+{
+    std::uint32_t index;
+    std::size_t package;
+    std::size_t domain;
+    std::size_t domain_in_package;
+    std::size_t rank;
+};
+
+//! Returns the distinct last level cache domains ordered by package.
+std::vector<std::pair<std::uint32_t, std::uint32_t>> llc_domains(
+    const std::vector<logical_cpu>& cpus)
+{
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> domains;
+    domains.reserve(cpus.size());
+
+    for (const logical_cpu& cpu : cpus) {
+        domains.emplace_back(cpu.package, cpu.llc);
+    }
+
+    std::sort(domains.begin(), domains.end());
+    domains.erase(std::unique(domains.begin(), domains.end()),
+                  domains.end());
+
+    return domains;
+}
+
+//! Returns the position of the domain of @p cpu among the sorted @p domains.
+std::size_t domain_of(
+    const std::vector<std::pair<std::uint32_t, std::uint32_t>>& domains,
+    const logical_cpu& cpu)
+{
+    return static_cast<std::size_t>(
+        std::lower_bound(domains.begin(), domains.end(),
+                         std::make_pair(cpu.package, cpu.llc)) -
+        domains.begin());
+}
+
+} // namespace
+
+topology::topology(std::vector<logical_cpu> cpus)
+    : cpus_{std::move(cpus)}
+    , cores_{count_distinct(cpus_, &logical_cpu::core)}
+    , packages_{count_distinct(cpus_, &logical_cpu::package)}
+    , hybrid_{std::any_of(cpus_.begin(), cpus_.end(),
+        [this](const logical_cpu& cpu)
+        {
+            return cpu.type != cpus_.front().type;
+        })}
+{
+}
+
+const std::vector<logical_cpu>& topology::cpus() const noexcept
+{
+    return cpus_;
+}
+
+const logical_cpu* topology::find(unsigned index) const noexcept
+{
+    const auto pos = std::lower_bound(cpus_.begin(), cpus_.end(), index,
+        [](const logical_cpu& cpu, unsigned value)
+        {
+            return cpu.index < value;
+        });
+
+    return pos != cpus_.end() && pos->index == index ? &*pos : nullptr;
+}
+
+std::size_t topology::cores() const noexcept
+{
+    return cores_;
+}
+
+std::size_t topology::packages() const noexcept
+{
+    return packages_;
+}
+
+cpu_set topology::all() const
+{
+    cpu_set result;
+
+    for (const logical_cpu& cpu : cpus_) {
+        result.insert(cpu.index);
+    }
+
+    return result;
+}
+
+cpu_set topology::one_per_core() const
+{
+    std::vector<const logical_cpu*> sorted;
+    sorted.reserve(cpus_.size());
+
+    for (const logical_cpu& cpu : cpus_) {
+        sorted.push_back(&cpu);
+    }
+
+    std::sort(sorted.begin(), sorted.end(),
+        [](const logical_cpu* lhs, const logical_cpu* rhs)
+        {
+            return std::make_pair(lhs->core, lhs->smt) <
+                std::make_pair(rhs->core, rhs->smt);
+        });
+
+    cpu_set result;
+
+    for (std::size_t i = 0; i != sorted.size(); ++i) {
+        if (i == 0 || sorted[i - 1]->core != sorted[i]->core) {
+            result.insert(sorted[i]->index);
+        }
+    }
+
+    return result;
+}
+
+cpu_set topology::siblings(unsigned index) const
+{
+    cpu_set result;
+
+    if (const logical_cpu* const cpu = find(index)) {
+        for (const logical_cpu& other : cpus_) {
+            if (other.core == cpu->core) {
+                result.insert(other.index);
+            }
+        }
+    }
+
+    return result;
+}
+
+cpu_set topology::package(std::uint32_t package) const
+{
+    cpu_set result;
+
+    for (const logical_cpu& cpu : cpus_) {
+        if (cpu.package == package) {
+            result.insert(cpu.index);
+        }
+    }
+
+    return result;
+}
+
+std::vector<cpu_set> topology::cache_domains() const
+{
+    const std::vector<std::pair<std::uint32_t, std::uint32_t>> domains =
+        llc_domains(cpus_);
+    std::vector<cpu_set> result(domains.size());
+
+    for (const logical_cpu& cpu : cpus_) {
+        result[domain_of(domains, cpu)].insert(cpu.index);
+    }
+
+    return result;
+}
+
+std::vector<cpu_set> topology::place(std::size_t workers, placement policy,
+                                     bool one_per_core) const
+{
+    const std::vector<std::pair<std::uint32_t, std::uint32_t>> domains =
+        llc_domains(cpus_);
+
+    // Logical processors of each domain ordered by core and SMT index
+    std::vector<std::vector<const logical_cpu*>> members(domains.size());
+
+    for (const logical_cpu& cpu : cpus_) {
+        members[domain_of(domains, cpu)].push_back(&cpu);
+    }
+
+    std::vector<Slot> slots;
+    slots.reserve(cpus_.size());
+
+    // Size of each domain in slots
+    std::vector<std::size_t> capacity(domains.size());
+    std::size_t package = 0;
+    std::size_t domain_in_package = 0;
+
+    for (std::size_t d = 0; d != domains.size(); ++d) {
+        if (d != 0 && domains[d].first != domains[d - 1].first) {
+            ++package;
+            domain_in_package = 0;
+        }
+
+        std::vector<const logical_cpu*>& cpus = members[d];
+
+        std::sort(cpus.begin(), cpus.end(),
+            [](const logical_cpu* lhs, const logical_cpu* rhs)
+            {
+                return std::make_pair(lhs->core, lhs->smt) <
+                    std::make_pair(rhs->core, rhs->smt);
+            });
+
+        std::size_t cores = 0;
+
+        for (std::size_t i = 0; i != cpus.size(); ++i) {
+            if (i == 0 || cpus[i - 1]->core != cpus[i]->core) {
+                ++cores;
+            }
+        }
+
+        // The n-th sibling of each core ranks after the preceding siblings of
+        // all cores
+        std::size_t core = 0;
+        std::size_t sibling = 0;
+
+        for (std::size_t i = 0; i != cpus.size(); ++i) {
+            if (i != 0 && cpus[i - 1]->core != cpus[i]->core) {
+                ++core;
+                sibling = 0;
+            }
+            else if (i != 0) {
+                ++sibling;
+            }
+
+            if (sibling != 0 && one_per_core) {
+                continue;
+            }
+
+            slots.push_back(Slot{cpus[i]->index, package, d,
+                domain_in_package, sibling * cores + core});
+            ++capacity[d];
+        }
+
+        ++domain_in_package;
+    }
+
+    if (slots.empty()) {
+        return std::vector<cpu_set>{};
+    }
+
+    if (policy == placement::compact) {
+        // Start with the first domain holding all workers
+        const auto fits = std::find_if(capacity.begin(), capacity.end(),
+            [workers](std::size_t size)
+            {
+                return size >= workers;
+            });
+        const std::size_t first = fits != capacity.end()
+            ? static_cast<std::size_t>(fits - capacity.begin()) : 0;
+        const std::size_t count = domains.size();
+
+        std::sort(slots.begin(), slots.end(),
+            [first, count](const Slot& lhs, const Slot& rhs)
+            {
+                return std::make_pair((lhs.domain + count - first) % count,
+                                      lhs.rank) <
+                    std::make_pair((rhs.domain + count - first) % count,
+                                   rhs.rank);
+            });
+    }
+    else {
+        std::sort(slots.begin(), slots.end(),
+            [](const Slot& lhs, const Slot& rhs)
+            {
+                return std::make_tuple(lhs.rank, lhs.domain_in_package,
+                                       lhs.package) <
+                    std::make_tuple(rhs.rank, rhs.domain_in_package,
+                                    rhs.package);
+            });
+    }
+
+    std::vector<cpu_set> result(workers);
+
+    for (std::size_t i = 0; i != workers; ++i) {
+        result[i].insert(slots[i % slots.size()].index);
+    }
+
+    return result;
+}
+
+bool topology::hybrid() const noexcept
+{
+    return hybrid_;
+}
+
+cpu_set topology::cpus_of_type(core_type type) const
+{
+    cpu_set result;
+
+    for (const logical_cpu& cpu : cpus_) {
+        if (cpu.type == type) {
+            result.insert(cpu.index);
+        }
+    }
+
+    return result;
+}
+
+cpu_set topology::performance_cpus() const
+{
+    return hybrid_ ? cpus_of_type(core_type::performance) : all();
+}
+
+const topology& cpu_topology()
+{
+    static const topology instance{collect_topology(
+        detail::replay_source != nullptr ? *detail::replay_source
+                                         : hardware_cpuid())};
+    return instance;
+}
+
+topology cpu_topology(const cpuid_source& source)
+{
+    return topology{collect_topology(source)};
+}
+
+} // namespace cpuidpp
@@ -0,0 +1,203 @@
+/**
+ * @brief %cpuidpp Time Stamp Counter implementation.
+ * @file
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <cpuidpp/hypervisor.hpp>
+#include <cpuidpp/tsc.hpp>
+
+#include "cpuid.hpp"
+
+namespace cpuidpp {
+
+namespace {
+
+// The frequency is a property of the current processor even if another
+// machine is replayed.
+void cpuid(unsigned* info, unsigned leaf)
+{
+    detail::cpuid(detail::host_source, info, leaf);
+}
+
+void cpuidex(unsigned* info, unsigned leaf, unsigned subleaf)
+{
+    detail::cpuidex(detail::host_source, info, leaf, subleaf);
+}
+
+struct Frequency
+{
+    std::uint64_t hz;
+    frequency_source source;
+};
+
+//! Measures the Time Stamp Counter frequency against the steady clock.
+std::uint64_t calibrate()
+{
+    using clock = std::chrono::steady_clock;
+
+    const clock::time_point start = clock::now();
+    const std::uint64_t first = tsc_clock::ticks();
+
+    clock::time_point stop;
+
+    do {
+        stop = clock::now();
+    } while (stop - start < std::chrono::milliseconds{10});
+
+    const std::uint64_t last = tsc_clock::ticks();
+    const auto elapsed =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start);
+
+    return static_cast<std::uint64_t>(
+        static_cast<double>(last - first) * 1e9 /
+        static_cast<double>(elapsed.count()));
+}
+
+Frequency query_frequency()
+{
+    snapshot s = features();
+    unsigned info[4] = {};
+
+    // A replayed machine does not determine the frequency of the current one
+    const cpuid_source& host = detail::host_source != nullptr
+        ? *detail::host_source
+        : hardware_cpuid();
+
+    if (detail::replay_source != nullptr) {
+        detect(s, host);
+    }
+
+    if (s.max_leaf >= 0x15) {
+        // EAX=0x15
+        cpuidex(info, 0x15, 0);
+
+        const std::uint64_t denominator = info[0];
+        const std::uint64_t numerator = info[1];
+        std::uint64_t crystal = info[2];
+
+        if (denominator != 0 && numerator != 0) {
+            // Some processors do not enumerate the crystal frequency. Derive
+            // it from the base frequency.
+            if (crystal == 0 && s.max_leaf >= 0x16) {
+                // EAX=0x16
+                cpuid(info, 0x16);
+
+                crystal = std::uint64_t{info[0] & 0xffffU} * 1000000U *
+                    denominator / numerator;
+            }
+
+            if (crystal != 0) {
+                return Frequency{crystal * numerator / denominator,
+                                 frequency_source::cpuid};
+            }
+        }
+    }
+
+    if (s.max_leaf >= 0x16) {
+        // EAX=0x16
+        cpuid(info, 0x16);
+
+        // Base frequency in MHz
+        if ((info[0] & 0xffffU) != 0) {
+            return Frequency{std::uint64_t{info[0] & 0xffffU} * 1000000U,
+                             frequency_source::cpuid};
+        }
+    }
+
+    const hypervisor_info hv = detail::replay_source != nullptr
+        ? current_hypervisor(host)
+        : current_hypervisor();
+
+    if (hv.tsc_frequency != 0) {
+        return Frequency{hv.tsc_frequency, frequency_source::hypervisor};
+    }
+
+    return Frequency{calibrate(), frequency_source::calibration};
+}
+
+const Frequency& frequency()
+{
+    static const Frequency instance = query_frequency();
+    return instance;
+}
+
+/**
+ * @brief Determines the conversion factor from @p hz to nanoseconds in the
+ *        layout of @ref detail::tsc_to_nanoseconds.
+ *
+ * An unknown frequency reports ticks as nanoseconds rather than dividing by
+ * zero.
+ */
+std::uint64_t make_scale(std::uint64_t hz) noexcept
+{
+    if (hz == 0) {
+        return (std::uint64_t{1} << 32U) | 1U;
+    }
+
+    std::uint64_t multiplier;
+    unsigned shift;
+
+    // Use the largest shift that keeps the multiplier within 32 bits for the
+    // best precision. Without a shift, the multiplier does not exceed 10^9.
+    for (shift = 32; ; --shift) {
+        multiplier = (std::uint64_t{1000000000U} << shift) / hz;
+
+        if (multiplier <= 0xffffffffU || shift == 0) {
+            break;
+        }
+    }
+
+    return (multiplier << 32U) | (std::uint64_t{shift} << 1U) | 1U;
+}
+
+} // namespace
+
+constexpr bool tsc_clock::is_steady;
+
+std::uint64_t tsc_frequency()
+{
+    return frequency().hz;
+}
+
+frequency_source tsc_frequency_source()
+{
+    return frequency().source;
+}
+
+namespace detail {
+
+// Zero-initialized before any dynamic initialization
+std::atomic<std::uint64_t> tsc_to_nanoseconds;
+
+std::uint64_t init_tsc_to_nanoseconds() noexcept
+{
+    std::uint64_t scale = tsc_to_nanoseconds.load(std::memory_order_relaxed);
+
+    if (scale != 0) {
+        return scale;
+    }
+
+    std::uint64_t hz;
+
+    // Querying the hypervisor allocates
+    try {
+        hz = tsc_frequency();
+    }
+    catch (...) {
+        hz = calibrate();
+    }
+
+    // A concurrent caller may overwrite the factor with an equivalent one
+    scale = make_scale(hz);
+    tsc_to_nanoseconds.store(scale, std::memory_order_relaxed);
+
+    return scale;
+}
+
+} // namespace detail
+
+} // namespace cpuidpp
@@ -0,0 +1,55 @@
+/**
+ * @file
+ * @brief Helpers shared by the tests.
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef CPUIDPP_TESTS_CHECK_HPP
+#define CPUIDPP_TESTS_CHECK_HPP
+
+#include <cstdint>
+#include <iostream>
+
+#include <cpuidpp/source.hpp>
+
+/**
+ * @brief Reports @p expr and increments the @c failures counter in scope
+ *        unless @p expr holds.
+ */
+#define CPUIDPP_CHECK(expr)                                             \
+    do {                                                                \
+        if (!(expr)) {                                                  \
+            std::cerr << __FILE__ << ':' << __LINE__ << ": " #expr "\n";\
+            ++failures;                                                 \
+        }                                                               \
+    } while (0)
+
+namespace tests {
+
+constexpr std::uint32_t any = cpuidpp::cpuid_source::any_cpu;
+
+//! Creates a record answering a query of @p leaf and @p subleaf on @p cpu.
+inline cpuidpp::cpuid_record make_record(std::uint32_t cpu,
+                                         std::uint32_t leaf,
+                                         std::uint32_t subleaf,
+                                         std::uint32_t eax, std::uint32_t ebx,
+                                         std::uint32_t ecx, std::uint32_t edx)
+{
+    return cpuidpp::cpuid_record{cpu, leaf, subleaf, {eax, ebx, ecx, edx}};
+}
+
+//! Creates a record answering a query of @p leaf and @p subleaf on any processor.
+inline cpuidpp::cpuid_record make_record(std::uint32_t leaf,
+                                         std::uint32_t subleaf,
+                                         std::uint32_t eax, std::uint32_t ebx,
+                                         std::uint32_t ecx, std::uint32_t edx)
+{
+    return make_record(any, leaf, subleaf, eax, ebx, ecx, edx);
+}
+
+} // namespace tests
+
+#endif // !defined(CPUIDPP_TESTS_CHECK_HPP)
@@ -0,0 +1,123 @@
+/**
+ * @file
+ * @brief Checks the enumeration of the Advanced Matrix Extensions.
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <cpuidpp/amx.hpp>
+#include <cpuidpp/cpuidpp.hpp>
+#include <cpuidpp/dump.hpp>
+#include <cpuidpp/feature.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+using tests::make_record;
+
+//! Leaves of a Sapphire Rapids processor relevant to AMX.
+std::vector<cpuidpp::cpuid_record> sapphire_rapids()
+{
+    return std::vector<cpuidpp::cpuid_record>{
+        make_record(0x0, 0, 0x1e, 0x756e6547, 0x6c65746e, 0x49656e69),
+        make_record(0x1, 0, 0x806f8, 0, 1U << 27U, 0),
+        // AMX-BF16, AMX-TILE and AMX-INT8
+        make_record(0x7, 0, 1, 0, 0, (1U << 22U) | (1U << 24U) | (1U << 25U)),
+        // AMX-FP16
+        make_record(0x7, 1, 1U << 21U, 0, 0, 0),
+        // 8 KiB of tile data supporting XFD
+        make_record(0xD, 18, 0x2000, 0x340, 0x6, 0),
+        make_record(0x1D, 0, 1, 0, 0, 0),
+        // 8 tiles of 16 rows by 64 bytes
+        make_record(0x1D, 1, 0x04002000, 0x00080040, 0x10, 0),
+        make_record(0x1E, 0, 0, 0x4010, 0, 0),
+    };
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+
+    const cpuidpp::amx_info& amx = cpuidpp::amx_capabilities();
+
+    std::clog << "AMX: tile " << amx.tile << ", INT8 " << amx.int8
+        << ", BF16 " << amx.bf16 << ", FP16 " << amx.fp16 << ", OS "
+        << amx.os_support << ", XFD " << amx.xfd << ", usable "
+        << cpuidpp::amx_usable() << '\n';
+
+    for (const cpuidpp::tile_palette& p : amx.palettes) {
+        std::clog << "palette: " << p.max_names << " tiles of " << p.max_rows
+            << " rows by " << p.bytes_per_row << " bytes\n";
+    }
+
+    CPUIDPP_CHECK(amx.tile == cpuidpp::amx_tile());
+    CPUIDPP_CHECK(amx.os_support == cpuidpp::os_amx());
+    CPUIDPP_CHECK(amx.tile || amx.palettes.empty());
+    CPUIDPP_CHECK(!cpuidpp::amx_usable() || amx.supported());
+    CPUIDPP_CHECK(cpuidpp::request_amx_permission() == cpuidpp::amx_usable());
+
+    // The OS enables the tile configuration and data state
+    const cpuidpp::cpuid_dump spr{sapphire_rapids(), 0x602e7};
+    const cpuidpp::amx_info replayed = cpuidpp::amx_capabilities(spr);
+
+    CPUIDPP_CHECK(replayed.tile);
+    CPUIDPP_CHECK(replayed.int8);
+    CPUIDPP_CHECK(replayed.bf16);
+    CPUIDPP_CHECK(replayed.fp16);
+    CPUIDPP_CHECK(replayed.os_support);
+    CPUIDPP_CHECK(replayed.xfd);
+    CPUIDPP_CHECK(replayed.supported());
+    CPUIDPP_CHECK(replayed.palettes.size() == 1);
+    CPUIDPP_CHECK(replayed.tmul_max_k == 16);
+    CPUIDPP_CHECK(replayed.tmul_max_n == 64);
+
+    if (!replayed.palettes.empty()) {
+        const cpuidpp::tile_palette& p = replayed.palettes.front();
+
+        CPUIDPP_CHECK(p.total_tile_bytes == 8192);
+        CPUIDPP_CHECK(p.bytes_per_tile == 1024);
+        CPUIDPP_CHECK(p.bytes_per_row == 64);
+        CPUIDPP_CHECK(p.max_names == 8);
+        CPUIDPP_CHECK(p.max_rows == 16);
+    }
+
+    cpuidpp::snapshot s;
+    cpuidpp::detect(s, spr);
+
+    CPUIDPP_CHECK(cpuidpp::supports_all({cpuidpp::feature::amx_tile,
+        cpuidpp::feature::amx_int8, cpuidpp::feature::amx_bf16}, s));
+
+    // The tile state is not enabled, e.g., by an older kernel
+    const cpuidpp::cpuid_dump no_state{sapphire_rapids(), 0xe7};
+    const cpuidpp::amx_info disabled = cpuidpp::amx_capabilities(no_state);
+
+    CPUIDPP_CHECK(disabled.tile);
+    CPUIDPP_CHECK(!disabled.os_support);
+    CPUIDPP_CHECK(!disabled.supported());
+
+    cpuidpp::detect(s, no_state);
+
+    CPUIDPP_CHECK(!cpuidpp::supports_all({cpuidpp::feature::amx_tile}, s));
+    CPUIDPP_CHECK(!cpuidpp::supports_any({cpuidpp::feature::amx_bf16}, s));
+
+    // The number of enumerated palettes is bounded. Replace the record of the
+    // highest palette.
+    std::vector<cpuidpp::cpuid_record> garbage = sapphire_rapids();
+    garbage[5] = make_record(0x1D, 0, 0xffffffff, 0, 0, 0);
+
+    const cpuidpp::amx_info bounded =
+        cpuidpp::amx_capabilities(cpuidpp::cpuid_dump{garbage, 0x602e7});
+
+    CPUIDPP_CHECK(bounded.palettes.size() == 63);
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file
+ * @brief Checks the cache line sizes and the padded storage.
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <cpuidpp/cacheline.hpp>
+#include <cpuidpp/cpuidpp.hpp>
+#include <cpuidpp/dump.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+using tests::make_record;
+
+//! Intel processor prefetching 128-byte line pairs.
+std::vector<cpuidpp::cpuid_record> adjacent_line_prefetch()
+{
+    return std::vector<cpuidpp::cpuid_record>{
+        make_record(0x0, 0, 0x4, 0x756e6547, 0x6c65746e, 0x49656e69),
+        // CLFLUSH of 8 quadwords
+        make_record(0x1, 0, 0x306f2, 0x0800, 0, 1U << 19U),
+        // Descriptors 0xFF (see leaf 4) and 0xF1 (128-byte prefetching)
+        make_record(0x2, 0, 0x00f1ff01, 0, 0, 0),
+        // 48 KiB L1 data cache with 64-byte lines
+        make_record(0x4, 0, 0x21, 0x02c0003f, 63, 0),
+    };
+}
+
+bool is_aligned(const void* p, std::size_t alignment)
+{
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+
+    const cpuidpp::cache_line_info& lines = cpuidpp::cache_lines();
+
+    std::clog << "CLFLUSH " << lines.clflush_size << " B, L1D line "
+        << lines.l1d_line_size << " B, prefetch " << lines.prefetch_size
+        << " B, constructive " << lines.constructive_interference_size
+        << " B, destructive " << lines.destructive_interference_size
+        << " B\n";
+
+    CPUIDPP_CHECK(&cpuidpp::cache_lines() == &lines);
+    CPUIDPP_CHECK(cpuidpp::clfsh() == (lines.clflush_size != 0));
+    CPUIDPP_CHECK(lines.constructive_interference_size != 0);
+    CPUIDPP_CHECK(lines.destructive_interference_size >=
+                  lines.constructive_interference_size);
+    CPUIDPP_CHECK(lines.destructive_interference_size >= lines.prefetch_size);
+
+    const std::size_t line = lines.destructive_interference_size;
+
+    CPUIDPP_CHECK(cpuidpp::padded_size(0) == line);
+    CPUIDPP_CHECK(cpuidpp::padded_size(1) == line);
+    CPUIDPP_CHECK(cpuidpp::padded_size(line) == line);
+    CPUIDPP_CHECK(cpuidpp::padded_size(line + 1) == 2 * line);
+
+    void* p = cpuidpp::aligned_allocate(100, 256);
+    CPUIDPP_CHECK(is_aligned(p, 256));
+    cpuidpp::aligned_deallocate(p);
+    cpuidpp::aligned_deallocate(nullptr);
+
+    std::vector<int, cpuidpp::cache_aligned_allocator<int>> v(1000, 1);
+    CPUIDPP_CHECK(is_aligned(v.data(), line));
+
+    cpuidpp::padded_array<std::atomic<std::uint64_t>> counters{8};
+
+    CPUIDPP_CHECK(counters.size() == 8);
+    CPUIDPP_CHECK(counters.stride() == line);
+    CPUIDPP_CHECK(is_aligned(&counters[0], line));
+    CPUIDPP_CHECK(reinterpret_cast<const char*>(&counters[1]) -
+                  reinterpret_cast<const char*>(&counters[0]) ==
+                  static_cast<std::ptrdiff_t>(line));
+
+    for (std::size_t i = 0; i != counters.size(); ++i) {
+        CPUIDPP_CHECK(counters[i].load() == 0);
+        counters[i].fetch_add(i);
+    }
+
+    cpuidpp::padded_array<std::atomic<std::uint64_t>> moved{
+        std::move(counters)};
+
+    CPUIDPP_CHECK(counters.size() == 0);
+    CPUIDPP_CHECK(moved.size() == 8);
+    CPUIDPP_CHECK(moved[7].load() == 7);
+
+    const cpuidpp::cpuid_dump pairs{adjacent_line_prefetch(), 0};
+    const cpuidpp::cache_line_info replayed = cpuidpp::cache_lines(pairs);
+
+    CPUIDPP_CHECK(replayed.clflush_size == 64);
+    CPUIDPP_CHECK(replayed.l1d_line_size == 64);
+    CPUIDPP_CHECK(replayed.prefetch_size == 128);
+    CPUIDPP_CHECK(replayed.constructive_interference_size == 64);
+    CPUIDPP_CHECK(replayed.destructive_interference_size == 128);
+
+    // Without CLFLUSH and cache information 64 bytes are assumed
+    const cpuidpp::cpuid_dump bare{std::vector<cpuidpp::cpuid_record>{
+        make_record(0x0, 0, 0x1, 0x756e6547, 0x6c65746e, 0x49656e69)}, 0};
+    const cpuidpp::cache_line_info unknown = cpuidpp::cache_lines(bare);
+
+    CPUIDPP_CHECK(unknown.clflush_size == 0);
+    CPUIDPP_CHECK(unknown.l1d_line_size == 0);
+    CPUIDPP_CHECK(unknown.prefetch_size == 0);
+    CPUIDPP_CHECK(unknown.destructive_interference_size == 64);
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
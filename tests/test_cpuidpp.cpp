@@ -7,6 +7,7 @@
  * http://www.boost.org/LICENSE_1_0.txt)
  */
 
+#include <cstdlib>
 #include <iomanip>
 #include <iostream>
 
@@ -14,17 +15,46 @@
 
 #define CPUIDPP_FEATURE(name) #name
 #define CPUIDPP_SUPPORTED_FEATURE(out, name)                                        \
-    out << std::setw(20) << std::left << CPUIDPP_FEATURE(name) << ' '               \
+    out << std::setw(24) << std::left << CPUIDPP_FEATURE(name) << ' '               \
         << std::setw(4)  << std::right << (cpuidpp::name() ? "yes" : "no")          \
         << '\n'                                                                     \
-        ;
+        ;                                                                           \
+    if (cpuidpp::features().name() != cpuidpp::name()) {                            \
+        out << CPUIDPP_FEATURE(name) << ": snapshot mismatch\n";                    \
+        ++mismatches;                                                               \
+    }
 
 
 int main()
 {
+    int mismatches = 0;
+
     std::clog << "vendor: " << cpuidpp::vendor() << std::endl;
     std::clog << "model: " << cpuidpp::model() << std::endl;
 
+    if (cpuidpp::vendor() != cpuidpp::vendor_name()) {
+        std::clog << "vendor_name: mismatch\n";
+        ++mismatches;
+    }
+
+    if (cpuidpp::model() != cpuidpp::model_name()) {
+        std::clog << "model_name: mismatch\n";
+        ++mismatches;
+    }
+
+    for (const cpuidpp::cache& c : cpuidpp::cache_info()) {
+        const char* const types[] = { "", "data", "instruction", "unified" };
+
+        std::clog << "L" << c.level << ' '
+            << types[static_cast<int>(c.type)] << ": "
+            << c.size / 1024 << " KiB, "
+            << c.line_size << " B line, "
+            << c.ways << "-way, "
+            << c.sets << " sets, "
+            << (c.inclusive ? "inclusive" : "non-inclusive") << ", "
+            << "shared by " << c.shared_by << '\n';
+    }
+
     CPUIDPP_SUPPORTED_FEATURE(std::clog, abm);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, acpi);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, adx);
@@ -32,21 +62,60 @@ int main()
     CPUIDPP_SUPPORTED_FEATURE(std::clog, amd_3dnow);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, amd_3dnowext);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, amd_3dnowprefetch);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, amx_bf16);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, amx_fp16);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, amx_int8);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, amx_tile);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, apic);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, avx);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx10);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx10_128);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx10_256);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx10_512);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx10_usable);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, avx2);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx2_usable);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512_4fmaps);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512_4fmaps_usable);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512_4vnniw);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512_4vnniw_usable);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512bf16);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512bf16_usable);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512bitalg);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512bitalg_usable);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512bw);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512bw_usable);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512cd);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512cd_usable);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512dq);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512dq_usable);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512er);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512er_usable);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512f);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512f_usable);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512fp16);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512fp16_usable);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512ifma);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512ifma_usable);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512pf);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512pf_usable);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512vbmi);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512vbmi2);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512vbmi2_usable);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512vbmi_usable);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512vl);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512vl_usable);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512vnni);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512vnni_usable);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512vpopcntdq);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx512vpopcntdq_usable);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx_ifma);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx_ifma_usable);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx_ne_convert);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx_ne_convert_usable);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx_usable);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx_vnni);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, avx_vnni_usable);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, bmi1);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, bmi2);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, clflushopt);
@@ -64,22 +133,31 @@ int main()
     CPUIDPP_SUPPORTED_FEATURE(std::clog, ds);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, ds_cpl);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, dtes64);
-    CPUIDPP_SUPPORTED_FEATURE(std::clog, erms);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, eist);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, erms);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, extapic);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, f16c);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, f16c_usable);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, fma);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, fma4);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, fma_usable);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, fpu);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, fsgsbase);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, fsrc);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, fsrm);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, fsrs);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, fxsr);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, fxsr_opt);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, fzrm);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, gfni);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, hle);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, htt);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, hybrid);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, hypervisor);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, ia64);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, ibs);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, intel_pt);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, invariant_tsc);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, invpcid);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, lahf_lm);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, lm);
@@ -97,6 +175,9 @@ int main()
     CPUIDPP_SUPPORTED_FEATURE(std::clog, mtrr);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, nodeid_msr);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, nx);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, os_amx);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, os_avx);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, os_avx512);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, ospke);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, osvw);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, oxsave);
@@ -153,11 +234,17 @@ int main()
     CPUIDPP_SUPPORTED_FEATURE(std::clog, tsc);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, tsc_deadline);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, umip);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, vaes);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, vaes_usable);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, vme);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, vmx);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, vpclmulqdq);
+    CPUIDPP_SUPPORTED_FEATURE(std::clog, vpclmulqdq_usable);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, wdt);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, x2apic);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, xop);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, xsave);
     CPUIDPP_SUPPORTED_FEATURE(std::clog, xtpr);
+
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -0,0 +1,114 @@
+/**
+ * @file
+ * @brief Checks the selection of dispatched implementations.
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <cstdlib>
+#include <iostream>
+
+#include <cpuidpp/dispatch.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+int generic(int value)
+{
+    return value;
+}
+
+int avx2(int value)
+{
+    return value + 2;
+}
+
+int avx512(int value)
+{
+    return value + 512;
+}
+
+struct Kernels
+{
+    int (*scale)(int);
+    int (*offset)(int);
+};
+
+const Kernels generic_kernels{generic, generic};
+const Kernels avx2_kernels{avx2, avx2};
+
+cpuidpp::snapshot make_snapshot(bool has_avx2, bool has_avx512f)
+{
+    cpuidpp::snapshot s{};
+
+    s.words[cpuidpp::snapshot::leaf7_ebx] =
+        (has_avx2 ? 1U << 5 : 0U) | (has_avx512f ? 1U << 16 : 0U);
+
+    return s;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+
+    using dispatcher = cpuidpp::dispatcher<int(int)>;
+
+    const dispatcher none{
+        {
+            {avx512, {&cpuidpp::snapshot::avx512f}},
+            {avx2, {&cpuidpp::snapshot::avx2}},
+            {generic, {}}
+        },
+        make_snapshot(false, false)
+    };
+
+    const dispatcher some{
+        {
+            {avx512, {&cpuidpp::snapshot::avx512f, &cpuidpp::snapshot::avx2}},
+            {avx2, {&cpuidpp::snapshot::avx2}},
+            {generic, {}}
+        },
+        make_snapshot(true, false)
+    };
+
+    const dispatcher all{
+        {
+            {avx512, {&cpuidpp::snapshot::avx512f, &cpuidpp::snapshot::avx2}},
+            {avx2, {&cpuidpp::snapshot::avx2}},
+            {generic, {}}
+        },
+        make_snapshot(true, true)
+    };
+
+    CPUIDPP_CHECK(none.target() == generic);
+    CPUIDPP_CHECK(some.target() == avx2);
+    CPUIDPP_CHECK(all.target() == avx512);
+    CPUIDPP_CHECK(all(1) == 513);
+
+    const cpuidpp::dispatch_table<Kernels> kernels{
+        {
+            {&avx2_kernels, {&cpuidpp::snapshot::avx2}},
+            {&generic_kernels, {}}
+        },
+        make_snapshot(true, false)
+    };
+
+    CPUIDPP_CHECK(kernels->scale == avx2);
+    CPUIDPP_CHECK((*kernels).offset(1) == 3);
+
+    const dispatcher current{
+        {
+            {avx2, {&cpuidpp::snapshot::avx2}},
+            {generic, {}}
+        }
+    };
+
+    CPUIDPP_CHECK(current.target() == (cpuidpp::avx2() ? avx2 : generic));
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
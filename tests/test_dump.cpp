@@ -0,0 +1,241 @@
+/**
+ * @file
+ * @brief Checks capturing, saving and loading CPUID dumps.
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <cpuidpp/dump.hpp>
+#include <cpuidpp/source.hpp>
+#include <cpuidpp/topology.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+using tests::any;
+using tests::make_record;
+
+bool same_snapshot(const cpuidpp::snapshot& lhs, const cpuidpp::snapshot& rhs)
+{
+    return std::memcmp(lhs.words, rhs.words, sizeof lhs.words) == 0 &&
+        lhs.max_leaf == rhs.max_leaf &&
+        lhs.max_extended_leaf == rhs.max_extended_leaf &&
+        std::strcmp(lhs.vendor_id, rhs.vendor_id) == 0 &&
+        std::strcmp(lhs.brand, rhs.brand) == 0;
+}
+
+/**
+ * @brief Describes an AMD processor with AVX-512, a single L1 data cache and
+ *        two SMT siblings sharing a core.
+ */
+cpuidpp::cpuid_dump make_amd_dump()
+{
+    std::vector<cpuidpp::cpuid_record> records{
+        // "AuthenticAMD"
+        make_record(any, 0x0, 0, 0xB, 0x68747541, 0x444d4163, 0x69746e65),
+        // XSAVE, OSXSAVE and AVX
+        make_record(any, 0x1, 0, 0x00a00f11, 0, 0x1c000000, 0),
+        // AVX512F
+        make_record(any, 0x7, 0, 0, 1U << 16U, 0, 0),
+        // SMT level followed by the core level for each logical processor
+        make_record(0, 0xB, 0, 1, 2, 0x100, 0),
+        make_record(0, 0xB, 1, 1, 2, 0x201, 0),
+        make_record(1, 0xB, 0, 1, 2, 0x100, 1),
+        make_record(1, 0xB, 1, 1, 2, 0x201, 1),
+        make_record(any, 0x80000000, 0, 0x8000001E, 0, 0, 0),
+        // TOPOEXT
+        make_record(any, 0x80000001, 0, 0, 0, 1U << 22U, 0),
+        // 32 KiB 8-way L1 data cache with 64 sets of 64 B lines
+        make_record(any, 0x8000001D, 0, 0x21, 0x01c0003f, 63, 0),
+    };
+
+    return cpuidpp::cpuid_dump{std::move(records), 0xe7};
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+
+    const char* const path = "test_dump.bin";
+
+    const cpuidpp::cpuid_dump captured = cpuidpp::cpuid_dump::capture();
+
+    std::clog << "captured " << captured.size() << " records\n";
+
+    CPUIDPP_CHECK(!captured.empty());
+    CPUIDPP_CHECK(captured.matches_host());
+
+    const cpuidpp::cpuid_record* const leaf0 = captured.find(0, 0);
+
+    CPUIDPP_CHECK(leaf0 != nullptr);
+
+    if (leaf0 != nullptr) {
+        CPUIDPP_CHECK(leaf0->regs[0] == cpuidpp::features().max_leaf);
+    }
+
+    CPUIDPP_CHECK(captured.find(0x7fffffff, 0) == nullptr);
+
+    cpuidpp::snapshot replayed;
+    cpuidpp::detect(replayed, captured);
+
+    CPUIDPP_CHECK(same_snapshot(replayed, cpuidpp::features()));
+
+    CPUIDPP_CHECK(captured.save(path));
+
+    cpuidpp::cpuid_dump loaded;
+
+    CPUIDPP_CHECK(loaded.load(path));
+    CPUIDPP_CHECK(loaded.size() == captured.size());
+    CPUIDPP_CHECK(loaded.xcr0() == captured.xcr0());
+    CPUIDPP_CHECK(loaded.fingerprint() == captured.fingerprint());
+    CPUIDPP_CHECK(loaded.matches_host());
+    CPUIDPP_CHECK(loaded.size() == captured.size() &&
+                  std::memcmp(loaded.begin(), captured.begin(),
+                              captured.size() *
+                                  sizeof(cpuidpp::cpuid_record)) == 0);
+
+    cpuidpp::snapshot from_file;
+    cpuidpp::detect(from_file, loaded);
+
+    CPUIDPP_CHECK(same_snapshot(from_file, cpuidpp::features()));
+
+    // Moving preserves the mapping
+    const cpuidpp::cpuid_dump moved{std::move(loaded)};
+
+    CPUIDPP_CHECK(loaded.empty());
+    CPUIDPP_CHECK(moved.size() == captured.size());
+    CPUIDPP_CHECK(moved.find(0, 0) != nullptr);
+
+    // A different processor signature makes the dump stale
+    if (std::FILE* const file = std::fopen(path, "r+b")) {
+        // Offset of the signature in the fingerprint
+        std::fseek(file, 32, SEEK_SET);
+        std::fputc(0xff, file);
+        std::fclose(file);
+    }
+
+    cpuidpp::cpuid_dump stale;
+
+    CPUIDPP_CHECK(stale.load(path));
+    CPUIDPP_CHECK(!stale.matches_host());
+
+    // A record count exceeding the file size is rejected without allocating
+    // storage for it
+    if (std::FILE* const file = std::fopen(path, "r+b")) {
+        // Offset of the record count
+        std::fseek(file, 12, SEEK_SET);
+
+        for (int i = 0; i != 4; ++i) {
+            std::fputc(0xff, file);
+        }
+
+        std::fclose(file);
+    }
+
+    cpuidpp::cpuid_dump oversized;
+
+    CPUIDPP_CHECK(!oversized.load(path));
+    CPUIDPP_CHECK(oversized.empty());
+
+    // Truncated files are rejected
+    if (std::FILE* const file = std::fopen(path, "wb")) {
+        std::fputs("CPUIDPPD", file);
+        std::fclose(file);
+    }
+
+    cpuidpp::cpuid_dump truncated;
+
+    CPUIDPP_CHECK(!truncated.load(path));
+    CPUIDPP_CHECK(truncated.empty());
+    CPUIDPP_CHECK(!truncated.load("does-not-exist.bin"));
+
+    std::remove(path);
+
+    // Recording the queries of the library reproduces its results
+    cpuidpp::cpuid_recorder recorder{cpuidpp::hardware_cpuid()};
+    cpuidpp::snapshot recorded;
+    cpuidpp::detect(recorded, recorder);
+
+    CPUIDPP_CHECK(same_snapshot(recorded, cpuidpp::features()));
+    CPUIDPP_CHECK(cpuidpp::cache_info(recorder).size() ==
+                  cpuidpp::cache_info().size());
+
+    const cpuidpp::cpuid_dump recording = recorder.dump();
+
+    CPUIDPP_CHECK(!recording.empty());
+    CPUIDPP_CHECK(recording.size() < captured.size());
+    CPUIDPP_CHECK(recording.fingerprint() == captured.fingerprint());
+
+    cpuidpp::snapshot rerecorded;
+    cpuidpp::detect(rerecorded, recording);
+
+    CPUIDPP_CHECK(same_snapshot(rerecorded, cpuidpp::features()));
+    CPUIDPP_CHECK(cpuidpp::cache_info(recording).size() ==
+                  cpuidpp::cache_info().size());
+
+    // Replaying another machine
+    const cpuidpp::cpuid_dump amd = make_amd_dump();
+
+    cpuidpp::snapshot other;
+    cpuidpp::detect(other, amd);
+
+    CPUIDPP_CHECK(std::strcmp(other.vendor_id, "AuthenticAMD") == 0);
+    CPUIDPP_CHECK(other.max_leaf == 0xB);
+    CPUIDPP_CHECK(other.topoext());
+    CPUIDPP_CHECK(other.avx512f_usable());
+    CPUIDPP_CHECK(!other.avx2());
+    CPUIDPP_CHECK(amd.fingerprint().signature == 0x00a00f11);
+
+    const std::vector<cpuidpp::cache> caches = cpuidpp::cache_info(amd);
+
+    CPUIDPP_CHECK(caches.size() == 1);
+
+    if (caches.size() == 1) {
+        CPUIDPP_CHECK(caches[0].type == cpuidpp::cache_type::data);
+        CPUIDPP_CHECK(caches[0].level == 1);
+        CPUIDPP_CHECK(caches[0].size == 32 * 1024);
+        CPUIDPP_CHECK(caches[0].ways == 8);
+    }
+
+    CPUIDPP_CHECK((amd.cpus() == std::vector<std::uint32_t>{0, 1}));
+
+    const cpuidpp::topology topo = cpuidpp::cpu_topology(amd);
+
+    CPUIDPP_CHECK(topo.cpus().size() == 2);
+    CPUIDPP_CHECK(topo.cores() == 1);
+    CPUIDPP_CHECK(topo.packages() == 1);
+    CPUIDPP_CHECK(topo.siblings(0).size() == 2);
+
+    // Older AMD processors encode the L2 associativity, e.g., 5 for 6 ways
+    const cpuidpp::cpuid_dump legacy{std::vector<cpuidpp::cpuid_record>{
+        make_record(any, 0x0, 0, 0x1, 0x68747541, 0x444d4163, 0x69746e65),
+        make_record(any, 0x80000000, 0, 0x80000006, 0, 0, 0),
+        make_record(any, 0x80000005, 0, 0, 0, 0, 0),
+        make_record(any, 0x80000006, 0, 0, 0,
+                    (384U << 16U) | (5U << 12U) | 64U, 0),
+    }, 0};
+
+    const std::vector<cpuidpp::cache> legacy_caches =
+        cpuidpp::cache_info(legacy);
+
+    CPUIDPP_CHECK(legacy_caches.size() == 1);
+
+    if (legacy_caches.size() == 1) {
+        CPUIDPP_CHECK(legacy_caches[0].level == 2);
+        CPUIDPP_CHECK(legacy_caches[0].ways == 6);
+        CPUIDPP_CHECK(legacy_caches[0].sets == 1024);
+    }
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,382 @@
+/**
+ * @file
+ * @brief Checks the feature enumeration and the compile-time baseline.
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <cstdlib>
+#include <iostream>
+
+#include <cpuidpp/feature.hpp>
+
+#include "check.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+static_assert(cpuidpp::has<cpuidpp::feature::sse2>(),
+              "SSE2 is part of the x86-64 baseline");
+#endif // defined(__x86_64__) || defined(_M_X64)
+
+#if defined(__AVX2__)
+static_assert(cpuidpp::has<cpuidpp::feature::avx2>(),
+              "AVX2 is enabled by the compiler");
+#else
+static_assert(!cpuidpp::is_baseline<cpuidpp::feature::avx2>::value,
+              "AVX2 is not enabled by the compiler");
+#endif // defined(__AVX2__)
+
+namespace {
+
+constexpr cpuidpp::feature_set v3_kernel{
+    cpuidpp::feature::avx2, cpuidpp::feature::bmi2, cpuidpp::feature::fma,
+    cpuidpp::feature::f16c, cpuidpp::feature::movbe
+};
+
+static_assert(v3_kernel.contains(cpuidpp::feature::bmi2),
+              "feature_set is constructed at compile time");
+static_assert(!v3_kernel.contains(cpuidpp::feature::avx),
+              "feature_set contains only the given features");
+static_assert((v3_kernel | cpuidpp::feature_set{cpuidpp::feature::avx})
+                  .contains(cpuidpp::feature::avx),
+              "union contains the features of both sets");
+
+} // namespace
+
+// A usable feature requires exactly the state of its *_usable() accessor
+#define CPUIDPP_CHECK_USABLE(name)                                      \
+    {                                                                   \
+        cpuidpp::snapshot s{};                                          \
+        s.words[cpuidpp::word_of(cpuidpp::feature::name)] =             \
+            1U << cpuidpp::bit_of(cpuidpp::feature::name);              \
+        s.words[cpuidpp::snapshot::xcr0] =                              \
+            cpuidpp::required_state_of(cpuidpp::feature::name);         \
+        CPUIDPP_CHECK(s.name##_usable());                               \
+        s.words[cpuidpp::snapshot::xcr0] = 0x6U;                        \
+        CPUIDPP_CHECK(s.name##_usable() ==                              \
+            cpuidpp::supports_all({cpuidpp::feature::name}, s));        \
+    }
+
+// Setting only the bit of the enumerator must set the flag of the accessor
+#define CPUIDPP_CHECK_FEATURE(name)                                     \
+    {                                                                   \
+        cpuidpp::snapshot s{};                                          \
+        s.words[cpuidpp::word_of(cpuidpp::feature::name)] =             \
+            1U << cpuidpp::bit_of(cpuidpp::feature::name);              \
+        CPUIDPP_CHECK(s.name());                                        \
+        CPUIDPP_CHECK(cpuidpp::test(s, cpuidpp::feature::name));        \
+    }
+
+int main()
+{
+    int failures = 0;
+
+    CPUIDPP_CHECK_FEATURE(fpu)
+    CPUIDPP_CHECK_FEATURE(vme)
+    CPUIDPP_CHECK_FEATURE(de)
+    CPUIDPP_CHECK_FEATURE(pse)
+    CPUIDPP_CHECK_FEATURE(tsc)
+    CPUIDPP_CHECK_FEATURE(msr)
+    CPUIDPP_CHECK_FEATURE(pae)
+    CPUIDPP_CHECK_FEATURE(mce)
+    CPUIDPP_CHECK_FEATURE(cx8)
+    CPUIDPP_CHECK_FEATURE(apic)
+    CPUIDPP_CHECK_FEATURE(sep)
+    CPUIDPP_CHECK_FEATURE(mtrr)
+    CPUIDPP_CHECK_FEATURE(pge)
+    CPUIDPP_CHECK_FEATURE(mca)
+    CPUIDPP_CHECK_FEATURE(cmov)
+    CPUIDPP_CHECK_FEATURE(pat)
+    CPUIDPP_CHECK_FEATURE(pse36)
+    CPUIDPP_CHECK_FEATURE(psn)
+    CPUIDPP_CHECK_FEATURE(clfsh)
+    CPUIDPP_CHECK_FEATURE(ds)
+    CPUIDPP_CHECK_FEATURE(acpi)
+    CPUIDPP_CHECK_FEATURE(mmx)
+    CPUIDPP_CHECK_FEATURE(fxsr)
+    CPUIDPP_CHECK_FEATURE(sse)
+    CPUIDPP_CHECK_FEATURE(sse2)
+    CPUIDPP_CHECK_FEATURE(ss)
+    CPUIDPP_CHECK_FEATURE(htt)
+    CPUIDPP_CHECK_FEATURE(tm)
+    CPUIDPP_CHECK_FEATURE(ia64)
+    CPUIDPP_CHECK_FEATURE(pbe)
+    CPUIDPP_CHECK_FEATURE(sse3)
+    CPUIDPP_CHECK_FEATURE(pclmulqdq)
+    CPUIDPP_CHECK_FEATURE(dtes64)
+    CPUIDPP_CHECK_FEATURE(monitor)
+    CPUIDPP_CHECK_FEATURE(ds_cpl)
+    CPUIDPP_CHECK_FEATURE(vmx)
+    CPUIDPP_CHECK_FEATURE(smx)
+    CPUIDPP_CHECK_FEATURE(eist)
+    CPUIDPP_CHECK_FEATURE(tm2)
+    CPUIDPP_CHECK_FEATURE(ssse3)
+    CPUIDPP_CHECK_FEATURE(cnxt_id)
+    CPUIDPP_CHECK_FEATURE(sdbg)
+    CPUIDPP_CHECK_FEATURE(fma)
+    CPUIDPP_CHECK_FEATURE(cx16)
+    CPUIDPP_CHECK_FEATURE(xtpr)
+    CPUIDPP_CHECK_FEATURE(pdcm)
+    CPUIDPP_CHECK_FEATURE(pcid)
+    CPUIDPP_CHECK_FEATURE(dca)
+    CPUIDPP_CHECK_FEATURE(sse4_1)
+    CPUIDPP_CHECK_FEATURE(sse4_2)
+    CPUIDPP_CHECK_FEATURE(x2apic)
+    CPUIDPP_CHECK_FEATURE(movbe)
+    CPUIDPP_CHECK_FEATURE(popcnt)
+    CPUIDPP_CHECK_FEATURE(tsc_deadline)
+    CPUIDPP_CHECK_FEATURE(aes)
+    CPUIDPP_CHECK_FEATURE(xsave)
+    CPUIDPP_CHECK_FEATURE(oxsave)
+    CPUIDPP_CHECK_FEATURE(avx)
+    CPUIDPP_CHECK_FEATURE(f16c)
+    CPUIDPP_CHECK_FEATURE(rdrnd)
+    CPUIDPP_CHECK_FEATURE(hypervisor)
+    CPUIDPP_CHECK_FEATURE(fsgsbase)
+    CPUIDPP_CHECK_FEATURE(sgx)
+    CPUIDPP_CHECK_FEATURE(bmi1)
+    CPUIDPP_CHECK_FEATURE(hle)
+    CPUIDPP_CHECK_FEATURE(avx2)
+    CPUIDPP_CHECK_FEATURE(smep)
+    CPUIDPP_CHECK_FEATURE(bmi2)
+    CPUIDPP_CHECK_FEATURE(erms)
+    CPUIDPP_CHECK_FEATURE(invpcid)
+    CPUIDPP_CHECK_FEATURE(rtm)
+    CPUIDPP_CHECK_FEATURE(pqm)
+    CPUIDPP_CHECK_FEATURE(mpx)
+    CPUIDPP_CHECK_FEATURE(pqe)
+    CPUIDPP_CHECK_FEATURE(avx512f)
+    CPUIDPP_CHECK_FEATURE(avx512dq)
+    CPUIDPP_CHECK_FEATURE(rdseed)
+    CPUIDPP_CHECK_FEATURE(adx)
+    CPUIDPP_CHECK_FEATURE(smap)
+    CPUIDPP_CHECK_FEATURE(avx512ifma)
+    CPUIDPP_CHECK_FEATURE(pcommit)
+    CPUIDPP_CHECK_FEATURE(clflushopt)
+    CPUIDPP_CHECK_FEATURE(clwb)
+    CPUIDPP_CHECK_FEATURE(intel_pt)
+    CPUIDPP_CHECK_FEATURE(avx512pf)
+    CPUIDPP_CHECK_FEATURE(avx512er)
+    CPUIDPP_CHECK_FEATURE(avx512cd)
+    CPUIDPP_CHECK_FEATURE(sha)
+    CPUIDPP_CHECK_FEATURE(avx512bw)
+    CPUIDPP_CHECK_FEATURE(avx512vl)
+    CPUIDPP_CHECK_FEATURE(prefetchwt1)
+    CPUIDPP_CHECK_FEATURE(avx512vbmi)
+    CPUIDPP_CHECK_FEATURE(umip)
+    CPUIDPP_CHECK_FEATURE(pku)
+    CPUIDPP_CHECK_FEATURE(ospke)
+    CPUIDPP_CHECK_FEATURE(avx512vbmi2)
+    CPUIDPP_CHECK_FEATURE(gfni)
+    CPUIDPP_CHECK_FEATURE(vaes)
+    CPUIDPP_CHECK_FEATURE(vpclmulqdq)
+    CPUIDPP_CHECK_FEATURE(avx512vnni)
+    CPUIDPP_CHECK_FEATURE(avx512bitalg)
+    CPUIDPP_CHECK_FEATURE(avx512vpopcntdq)
+    CPUIDPP_CHECK_FEATURE(rdpid)
+    CPUIDPP_CHECK_FEATURE(sgx_lc)
+    CPUIDPP_CHECK_FEATURE(avx512_4vnniw)
+    CPUIDPP_CHECK_FEATURE(avx512_4fmaps)
+    CPUIDPP_CHECK_FEATURE(fsrm)
+    CPUIDPP_CHECK_FEATURE(hybrid)
+    CPUIDPP_CHECK_FEATURE(amx_bf16)
+    CPUIDPP_CHECK_FEATURE(avx512fp16)
+    CPUIDPP_CHECK_FEATURE(amx_tile)
+    CPUIDPP_CHECK_FEATURE(amx_int8)
+    CPUIDPP_CHECK_FEATURE(avx_vnni)
+    CPUIDPP_CHECK_FEATURE(avx512bf16)
+    CPUIDPP_CHECK_FEATURE(fzrm)
+    CPUIDPP_CHECK_FEATURE(fsrs)
+    CPUIDPP_CHECK_FEATURE(fsrc)
+    CPUIDPP_CHECK_FEATURE(amx_fp16)
+    CPUIDPP_CHECK_FEATURE(avx_ifma)
+    CPUIDPP_CHECK_FEATURE(avx_ne_convert)
+    CPUIDPP_CHECK_FEATURE(avx10)
+    CPUIDPP_CHECK_FEATURE(avx10_128)
+    CPUIDPP_CHECK_FEATURE(avx10_256)
+    CPUIDPP_CHECK_FEATURE(avx10_512)
+    CPUIDPP_CHECK_FEATURE(syscall)
+    CPUIDPP_CHECK_FEATURE(mp)
+    CPUIDPP_CHECK_FEATURE(nx)
+    CPUIDPP_CHECK_FEATURE(mmxext)
+    CPUIDPP_CHECK_FEATURE(fxsr_opt)
+    CPUIDPP_CHECK_FEATURE(pdpe1gb)
+    CPUIDPP_CHECK_FEATURE(rdtscp)
+    CPUIDPP_CHECK_FEATURE(lm)
+    CPUIDPP_CHECK_FEATURE(amd_3dnowext)
+    CPUIDPP_CHECK_FEATURE(amd_3dnow)
+    CPUIDPP_CHECK_FEATURE(lahf_lm)
+    CPUIDPP_CHECK_FEATURE(cmp_legacy)
+    CPUIDPP_CHECK_FEATURE(svm)
+    CPUIDPP_CHECK_FEATURE(extapic)
+    CPUIDPP_CHECK_FEATURE(cr8_legacy)
+    CPUIDPP_CHECK_FEATURE(abm)
+    CPUIDPP_CHECK_FEATURE(sse4a)
+    CPUIDPP_CHECK_FEATURE(misalignsse)
+    CPUIDPP_CHECK_FEATURE(amd_3dnowprefetch)
+    CPUIDPP_CHECK_FEATURE(osvw)
+    CPUIDPP_CHECK_FEATURE(ibs)
+    CPUIDPP_CHECK_FEATURE(xop)
+    CPUIDPP_CHECK_FEATURE(skinit)
+    CPUIDPP_CHECK_FEATURE(wdt)
+    CPUIDPP_CHECK_FEATURE(lwp)
+    CPUIDPP_CHECK_FEATURE(fma4)
+    CPUIDPP_CHECK_FEATURE(tce)
+    CPUIDPP_CHECK_FEATURE(nodeid_msr)
+    CPUIDPP_CHECK_FEATURE(tbm)
+    CPUIDPP_CHECK_FEATURE(topoext)
+    CPUIDPP_CHECK_FEATURE(perfctr_core)
+    CPUIDPP_CHECK_FEATURE(perfctr_nb)
+    CPUIDPP_CHECK_FEATURE(dbx)
+    CPUIDPP_CHECK_FEATURE(perftsc)
+    CPUIDPP_CHECK_FEATURE(pcx_l2i)
+    CPUIDPP_CHECK_FEATURE(invariant_tsc)
+
+    CPUIDPP_CHECK_USABLE(avx)
+    CPUIDPP_CHECK_USABLE(avx10)
+    CPUIDPP_CHECK_USABLE(avx2)
+    CPUIDPP_CHECK_USABLE(avx512_4fmaps)
+    CPUIDPP_CHECK_USABLE(avx512_4vnniw)
+    CPUIDPP_CHECK_USABLE(avx512bf16)
+    CPUIDPP_CHECK_USABLE(avx512bitalg)
+    CPUIDPP_CHECK_USABLE(avx512bw)
+    CPUIDPP_CHECK_USABLE(avx512cd)
+    CPUIDPP_CHECK_USABLE(avx512dq)
+    CPUIDPP_CHECK_USABLE(avx512er)
+    CPUIDPP_CHECK_USABLE(avx512f)
+    CPUIDPP_CHECK_USABLE(avx512fp16)
+    CPUIDPP_CHECK_USABLE(avx512ifma)
+    CPUIDPP_CHECK_USABLE(avx512pf)
+    CPUIDPP_CHECK_USABLE(avx512vbmi)
+    CPUIDPP_CHECK_USABLE(avx512vbmi2)
+    CPUIDPP_CHECK_USABLE(avx512vl)
+    CPUIDPP_CHECK_USABLE(avx512vnni)
+    CPUIDPP_CHECK_USABLE(avx512vpopcntdq)
+    CPUIDPP_CHECK_USABLE(avx_ifma)
+    CPUIDPP_CHECK_USABLE(avx_ne_convert)
+    CPUIDPP_CHECK_USABLE(avx_vnni)
+    CPUIDPP_CHECK_USABLE(f16c)
+    CPUIDPP_CHECK_USABLE(fma)
+    CPUIDPP_CHECK_USABLE(vaes)
+    CPUIDPP_CHECK_USABLE(vpclmulqdq)
+
+    // The AVX10 version is only defined if AVX10 is supported
+    cpuidpp::snapshot avx10{};
+    avx10.words[cpuidpp::snapshot::leaf24_ebx] = 0x70001U;
+
+    CPUIDPP_CHECK(avx10.avx10_version() == 0);
+
+    avx10.words[cpuidpp::snapshot::leaf7_1_edx] = 1U << 19U;
+
+    CPUIDPP_CHECK(avx10.avx10_version() == 1);
+    CPUIDPP_CHECK(avx10.avx10_512());
+    CPUIDPP_CHECK(!cpuidpp::supports_all({cpuidpp::feature::avx10_512}, avx10));
+
+    avx10.words[cpuidpp::snapshot::xcr0] = 0xe7U;
+
+    CPUIDPP_CHECK(cpuidpp::supports_all({cpuidpp::feature::avx10,
+        cpuidpp::feature::avx10_256, cpuidpp::feature::avx10_512}, avx10));
+
+    cpuidpp::snapshot v3{};
+    v3.words[cpuidpp::snapshot::leaf1_ecx] =
+        (1U << 12U) | (1U << 22U) | (1U << 29U);
+    v3.words[cpuidpp::snapshot::leaf7_ebx] = (1U << 5U) | (1U << 8U);
+
+    // The YMM state is missing
+    CPUIDPP_CHECK(!cpuidpp::supports_all(v3_kernel, v3));
+    CPUIDPP_CHECK(cpuidpp::supports_any(v3_kernel, v3));
+
+    v3.words[cpuidpp::snapshot::xcr0] = 0x6U;
+
+    CPUIDPP_CHECK(cpuidpp::supports_all(v3_kernel, v3));
+    CPUIDPP_CHECK(cpuidpp::supports_all({}, v3));
+    CPUIDPP_CHECK(!cpuidpp::supports_any({}, v3));
+    CPUIDPP_CHECK(!cpuidpp::supports_all(
+        v3_kernel | cpuidpp::feature_set{cpuidpp::feature::avx512f}, v3));
+    CPUIDPP_CHECK(!cpuidpp::supports_any(
+        {cpuidpp::feature::avx512f, cpuidpp::feature::sse4a}, v3));
+
+    // Build the levels one after another
+    cpuidpp::snapshot level{};
+
+    CPUIDPP_CHECK(cpuidpp::x86_64_level(level) == 0);
+    CPUIDPP_CHECK(cpuidpp::meets_level(0, level));
+
+    level.words[cpuidpp::snapshot::leaf1_edx] = (1U << 0U) | (1U << 8U) |
+        (1U << 15U) | (1U << 23U) | (1U << 24U) | (1U << 25U) | (1U << 26U);
+    level.words[cpuidpp::snapshot::leaf80000001_edx] = (1U << 11U) | (1U << 29U);
+
+    CPUIDPP_CHECK(cpuidpp::x86_64_level(level) == 1);
+
+    level.words[cpuidpp::snapshot::leaf1_ecx] = (1U << 0U) | (1U << 9U) |
+        (1U << 13U) | (1U << 19U) | (1U << 20U) | (1U << 23U);
+
+    // LAHF/SAHF in 64-bit mode is missing
+    CPUIDPP_CHECK(cpuidpp::x86_64_level(level) == 1);
+
+    level.words[cpuidpp::snapshot::leaf80000001_ecx] = 1U << 0U;
+
+    CPUIDPP_CHECK(cpuidpp::x86_64_level(level) == 2);
+
+    level.words[cpuidpp::snapshot::leaf1_ecx] |= (1U << 12U) | (1U << 22U) |
+        (1U << 27U) | (1U << 28U) | (1U << 29U);
+    level.words[cpuidpp::snapshot::leaf7_ebx] =
+        (1U << 3U) | (1U << 5U) | (1U << 8U);
+    level.words[cpuidpp::snapshot::leaf80000001_ecx] |= 1U << 5U;
+
+    // The OS does not enable the YMM state
+    CPUIDPP_CHECK(cpuidpp::x86_64_level(level) == 2);
+
+    level.words[cpuidpp::snapshot::xcr0] = 0x7U;
+
+    CPUIDPP_CHECK(cpuidpp::x86_64_level(level) == 3);
+
+    level.words[cpuidpp::snapshot::leaf7_ebx] |= (1U << 16U) | (1U << 17U) |
+        (1U << 28U) | (1U << 30U) | (1U << 31U);
+
+    CPUIDPP_CHECK(cpuidpp::x86_64_level(level) == 3);
+
+    level.words[cpuidpp::snapshot::xcr0] = 0xe7U;
+
+    CPUIDPP_CHECK(cpuidpp::x86_64_level(level) == 4);
+    CPUIDPP_CHECK(cpuidpp::meets_level(3, level));
+    CPUIDPP_CHECK(!cpuidpp::meets_level(5, level));
+
+    const cpuidpp::snapshot& s = cpuidpp::features();
+
+    CPUIDPP_CHECK(cpuidpp::supports_all(v3_kernel) ==
+                  (s.avx2_usable() && s.bmi2() && s.fma_usable() &&
+                   s.f16c_usable() && s.movbe()));
+
+    CPUIDPP_CHECK(cpuidpp::has<cpuidpp::feature::avx2>() == s.avx2_usable() ||
+                  cpuidpp::is_baseline<cpuidpp::feature::avx2>::value);
+    CPUIDPP_CHECK(cpuidpp::has<cpuidpp::feature::avx512f>() ==
+                      s.avx512f_usable() ||
+                  cpuidpp::is_baseline<cpuidpp::feature::avx512f>::value);
+    CPUIDPP_CHECK(cpuidpp::has<cpuidpp::feature::bmi2>() == s.bmi2() ||
+                  cpuidpp::is_baseline<cpuidpp::feature::bmi2>::value);
+
+    // AVX2 without the YMM state enabled by the OS is not usable
+    cpuidpp::snapshot no_state{};
+    no_state.words[cpuidpp::snapshot::leaf7_ebx] = 1U << 5;
+
+    CPUIDPP_CHECK(cpuidpp::has<cpuidpp::feature::avx2>(no_state) ==
+                  cpuidpp::is_baseline<cpuidpp::feature::avx2>::value);
+
+    no_state.words[cpuidpp::snapshot::xcr0] = 0x6U;
+
+    CPUIDPP_CHECK(cpuidpp::has<cpuidpp::feature::avx2>(no_state));
+
+    std::clog << "x86-64 level: " << cpuidpp::x86_64_level() << '\n';
+
+#if defined(__x86_64__) || defined(_M_X64)
+    CPUIDPP_CHECK(cpuidpp::x86_64_level() >= 1);
+#endif // defined(__x86_64__) || defined(_M_X64)
+
+    std::clog << "avx2: "
+        << (cpuidpp::is_baseline<cpuidpp::feature::avx2>::value
+            ? "baseline" : "runtime") << '\n';
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file
+ * @brief Checks the decoding of the hypervisor leaves.
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <cpuidpp/cpuidpp.hpp>
+#include <cpuidpp/dump.hpp>
+#include <cpuidpp/hypervisor.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+using tests::make_record;
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+
+    const cpuidpp::hypervisor_info& hv = cpuidpp::current_hypervisor();
+
+    std::clog << "hypervisor: " << cpuidpp::to_string(hv.vendor) << " ("
+        << hv.signature << "), max leaf 0x" << std::hex << hv.max_leaf
+        << ", KVM features 0x" << hv.kvm_features << std::dec
+        << ", TSC " << hv.tsc_frequency << " Hz, APIC " << hv.apic_frequency
+        << " Hz\n";
+
+    CPUIDPP_CHECK(hv.virtualized() == cpuidpp::hypervisor());
+    CPUIDPP_CHECK(!hv.virtualized() || hv.base_leaf >= 0x40000000);
+    CPUIDPP_CHECK(hv.vendor == cpuidpp::hypervisor_vendor::kvm ||
+                  hv.kvm_features == 0);
+    CPUIDPP_CHECK(&cpuidpp::current_hypervisor() == &hv);
+
+    // KVM exposing the Hyper-V interface for Windows guests
+    const cpuidpp::cpuid_dump kvm{std::vector<cpuidpp::cpuid_record>{
+        make_record(0x0, 0, 1, 0x756e6547, 0x6c65746e, 0x49656e69),
+        make_record(0x1, 0, 0, 0, 1U << 31U, 0),
+        // "Microsoft Hv"
+        make_record(0x40000000, 0, 0x40000005, 0x7263694d, 0x666f736f,
+                    0x76482074),
+        // "KVMKVMKVM"
+        make_record(0x40000100, 0, 0x40000110, 0x4b4d564b, 0x564b4d56,
+                    0x0000004d),
+        // PV EOI and PV TLB flush along with the realtime hint
+        make_record(0x40000101, 0, (1U << 6U) | (1U << 9U), 0, 0, 1),
+        // 2.1 GHz TSC and 1 GHz APIC timer
+        make_record(0x40000110, 0, 2100000, 1000000, 0, 0),
+    }, 0};
+
+    const cpuidpp::hypervisor_info replayed = cpuidpp::current_hypervisor(kvm);
+
+    CPUIDPP_CHECK(replayed.vendor == cpuidpp::hypervisor_vendor::kvm);
+    CPUIDPP_CHECK(std::strcmp(replayed.signature, "KVMKVMKVM") == 0);
+    CPUIDPP_CHECK(replayed.hyperv_compatible);
+    CPUIDPP_CHECK(replayed.base_leaf == 0x40000100);
+    CPUIDPP_CHECK(replayed.max_leaf == 0x40000110);
+    CPUIDPP_CHECK(replayed.has(cpuidpp::kvm_feature::pv_eoi));
+    CPUIDPP_CHECK(replayed.has(cpuidpp::kvm_feature::pv_tlb_flush));
+    CPUIDPP_CHECK(!replayed.has(cpuidpp::kvm_feature::steal_time));
+    CPUIDPP_CHECK(replayed.dedicated_cpus());
+    CPUIDPP_CHECK(replayed.tsc_frequency == 2100000000);
+    CPUIDPP_CHECK(replayed.apic_frequency == 1000000000);
+
+    // Without the hypervisor bit the range is not examined
+    const cpuidpp::cpuid_dump bare{std::vector<cpuidpp::cpuid_record>{
+        make_record(0x0, 0, 1, 0x756e6547, 0x6c65746e, 0x49656e69),
+        make_record(0x1, 0, 0, 0, 0, 0),
+        make_record(0x40000000, 0, 0x40000001, 0x4b4d564b, 0x564b4d56,
+                    0x0000004d),
+    }, 0};
+
+    const cpuidpp::hypervisor_info metal = cpuidpp::current_hypervisor(bare);
+
+    CPUIDPP_CHECK(!metal.virtualized());
+    CPUIDPP_CHECK(!metal.has(cpuidpp::kvm_feature::clocksource));
+    CPUIDPP_CHECK(std::strcmp(cpuidpp::to_string(metal.vendor), "none") == 0);
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,168 @@
+/**
+ * @file
+ * @brief Checks the memory operations strategy and the dispatched kernels.
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include <cpuidpp/memops.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+//! Largest buffer used to exercise the non-temporal kernels.
+constexpr std::size_t MaxBuffer = 64 * 1024 * 1024;
+
+cpuidpp::cache make_cache(unsigned level, cpuidpp::cache_type type,
+                          std::size_t size, unsigned shared_by)
+{
+    cpuidpp::cache c{};
+
+    c.level = level;
+    c.type = type;
+    c.size = size;
+    c.shared_by = shared_by;
+
+    return c;
+}
+
+//! Copies and fills @p n bytes at the offsets 0 to 3 and verifies the result.
+bool round_trip(std::size_t n)
+{
+    std::vector<unsigned char> src(n + 3);
+    std::vector<unsigned char> dst(n + 3);
+
+    for (std::size_t i = 0; i != src.size(); ++i) {
+        src[i] = static_cast<unsigned char>(i * 7 + 1);
+    }
+
+    for (std::size_t offset = 0; offset != 4; ++offset) {
+        const std::size_t length = n - offset;
+
+        std::fill(dst.begin(), dst.end(), 0);
+
+        if (cpuidpp::copy(dst.data() + offset, src.data(), length) !=
+            dst.data() + offset) {
+            return false;
+        }
+
+        if (!std::equal(src.begin(), src.begin() + length,
+                        dst.begin() + offset) ||
+            dst[offset + length] != 0) {
+            return false;
+        }
+
+        cpuidpp::fill(dst.data() + offset, 0xa5, length);
+
+        if (std::count(dst.begin() + offset, dst.begin() + offset + length,
+                       0xa5) != static_cast<std::ptrdiff_t>(length) ||
+            dst[offset + length] != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+
+    const cpuidpp::memory_strategy& m = cpuidpp::memory_operations();
+
+    std::clog << "ERMS " << m.erms << ", FSRM " << m.fsrm << ", FZRM "
+        << m.fzrm << ", FSRS " << m.fsrs << ", FSRC " << m.fsrc
+        << ", vector " << m.vector_bytes << " B, REP MOVSB from "
+        << m.rep_movsb_threshold << " B, REP STOSB from "
+        << m.rep_stosb_threshold << " B, non-temporal from "
+        << m.non_temporal_threshold << " B\n";
+
+    CPUIDPP_CHECK(m.erms == cpuidpp::erms());
+    CPUIDPP_CHECK(m.fsrm == cpuidpp::fsrm());
+    CPUIDPP_CHECK(m.erms || m.rep_movsb_threshold == 0);
+    CPUIDPP_CHECK(m.non_temporal_threshold >= 0x4040);
+    CPUIDPP_CHECK(&cpuidpp::memory_operations() == &m);
+
+    // Sizes around each threshold
+    std::vector<std::size_t> sizes{4, 63, 64, 4095, 4096, 100000};
+
+    for (std::size_t threshold : {m.rep_movsb_threshold,
+                                  m.rep_stosb_threshold,
+                                  m.non_temporal_threshold}) {
+        if (threshold >= 4 && threshold < MaxBuffer) {
+            sizes.push_back(threshold - 1);
+            sizes.push_back(threshold);
+            sizes.push_back(threshold * 2 + 13);
+        }
+    }
+
+    for (std::size_t n : sizes) {
+        if (!round_trip(n)) {
+            std::cerr << "round trip of " << n << " bytes failed\n";
+            ++failures;
+        }
+    }
+
+    // 32 MiB of L3 shared by 64 logical processors
+    cpuidpp::snapshot s{};
+    s.words[cpuidpp::snapshot::leaf1_edx] = 1U << 26U;
+    s.words[cpuidpp::snapshot::leaf7_ebx] = 1U << 9U;
+
+    const std::vector<cpuidpp::cache> caches{
+        make_cache(1, cpuidpp::cache_type::data, 48 * 1024, 2),
+        make_cache(1, cpuidpp::cache_type::instruction, 32 * 1024, 2),
+        make_cache(2, cpuidpp::cache_type::unified, 2048 * 1024, 2),
+        make_cache(3, cpuidpp::cache_type::unified, 32 * 1024 * 1024, 64),
+    };
+
+    cpuidpp::memory_strategy plan =
+        cpuidpp::plan_memory_operations(s, caches);
+
+    CPUIDPP_CHECK(plan.erms);
+    CPUIDPP_CHECK(plan.vector_bytes == 16);
+    CPUIDPP_CHECK(plan.rep_movsb_threshold == 2048);
+    CPUIDPP_CHECK(plan.rep_stosb_threshold == 2048);
+    CPUIDPP_CHECK(plan.non_temporal_threshold == 384 * 1024);
+
+    // AVX-512 widens the REP MOVSB threshold unless FSRM is supported
+    s.words[cpuidpp::snapshot::leaf7_ebx] |= 1U << 16U;
+    s.words[cpuidpp::snapshot::xcr0] = 0xe7U;
+
+    plan = cpuidpp::plan_memory_operations(s, caches);
+
+    CPUIDPP_CHECK(plan.vector_bytes == 64);
+    CPUIDPP_CHECK(plan.rep_movsb_threshold == 8192);
+
+    s.words[cpuidpp::snapshot::leaf7_edx] = 1U << 4U;
+    plan = cpuidpp::plan_memory_operations(s, caches);
+
+    CPUIDPP_CHECK(plan.fsrm);
+    CPUIDPP_CHECK(plan.rep_movsb_threshold == 2112);
+
+    // Without cache information 1 MiB per logical processor is assumed
+    plan = cpuidpp::plan_memory_operations(s, {});
+
+    CPUIDPP_CHECK(plan.non_temporal_threshold == 768 * 1024);
+
+    // Without SSE2, non-temporal stores are never used
+    plan = cpuidpp::plan_memory_operations(cpuidpp::snapshot{}, caches);
+
+    CPUIDPP_CHECK(!plan.erms);
+    CPUIDPP_CHECK(plan.vector_bytes == 0);
+    CPUIDPP_CHECK(plan.rep_movsb_threshold == 0);
+    CPUIDPP_CHECK(plan.non_temporal_threshold ==
+                  std::numeric_limits<std::size_t>::max());
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,195 @@
+/**
+ * @file
+ * @brief Checks the performance monitoring enumeration and the profiler.
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <cpuidpp/cpuidpp.hpp>
+#include <cpuidpp/dump.hpp>
+#include <cpuidpp/pmu.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+using tests::make_record;
+
+//! Intel processor with eight 48-bit counters and three fixed counters.
+std::vector<cpuidpp::cpuid_record> intel_pmu()
+{
+    return std::vector<cpuidpp::cpuid_record>{
+        make_record(0x0, 0, 0xA, 0x756e6547, 0x6c65746e, 0x49656e69),
+        // Version 5 enumerating 8 events of which LLC misses are unavailable
+        make_record(0xA, 0, 0x08300805, 1U << 4U, 0, 0x603),
+    };
+}
+
+//! AMD processor with the core extensions and PerfMonV2.
+std::vector<cpuidpp::cpuid_record> amd_pmu()
+{
+    return std::vector<cpuidpp::cpuid_record>{
+        make_record(0x0, 0, 0x10, 0x68747541, 0x444d4163, 0x69746e65),
+        make_record(0x80000000, 0, 0x80000022, 0, 0, 0),
+        // PerfCtrExtCore and PerfCtrExtNB
+        make_record(0x80000001, 0, 0, 0, (1U << 23U) | (1U << 24U), 0),
+        make_record(0x80000022, 0, 1, 6, 0, 0),
+    };
+}
+
+volatile std::uint64_t sink;
+
+void work()
+{
+    std::uint64_t sum = 0;
+
+    for (std::uint64_t i = 0; i != 10000; ++i) {
+        sum += i * i;
+    }
+
+    sink = sum;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+
+    const cpuidpp::pmu_info& pmu = cpuidpp::pmu_capabilities();
+
+    std::clog << "PMU: version " << pmu.version << ", "
+        << pmu.general_counters << " x " << pmu.general_width
+        << "-bit general, " << pmu.fixed_counters << " x "
+        << pmu.fixed_width << "-bit fixed, events 0x" << std::hex
+        << pmu.events << std::dec << ", perfctr_core " << pmu.perfctr_core
+        << '\n';
+
+    CPUIDPP_CHECK(&cpuidpp::pmu_capabilities() == &pmu);
+    CPUIDPP_CHECK(pmu.perfctr_core == cpuidpp::perfctr_core());
+    CPUIDPP_CHECK(pmu.version != 0 || pmu.events == 0);
+    CPUIDPP_CHECK(pmu.general_counters == 0 || pmu.general_width != 0);
+
+    const cpuidpp::pmu_info intel =
+        cpuidpp::pmu_capabilities(cpuidpp::cpuid_dump{intel_pmu(), 0});
+
+    CPUIDPP_CHECK(intel.version == 5);
+    CPUIDPP_CHECK(intel.general_counters == 8);
+    CPUIDPP_CHECK(intel.general_width == 48);
+    CPUIDPP_CHECK(intel.fixed_counters == 3);
+    CPUIDPP_CHECK(intel.fixed_width == 48);
+    CPUIDPP_CHECK(intel.events == 0xef);
+    CPUIDPP_CHECK(intel.supports(cpuidpp::pmu_event::instructions_retired));
+    CPUIDPP_CHECK(intel.supports(cpuidpp::pmu_event::topdown_slots));
+    CPUIDPP_CHECK(!intel.supports(cpuidpp::pmu_event::llc_misses));
+
+    const cpuidpp::pmu_info amd =
+        cpuidpp::pmu_capabilities(cpuidpp::cpuid_dump{amd_pmu(), 0});
+
+    CPUIDPP_CHECK(amd.version == 2);
+    CPUIDPP_CHECK(amd.general_counters == 6);
+    CPUIDPP_CHECK(amd.general_width == 48);
+    CPUIDPP_CHECK(amd.perfctr_core);
+    CPUIDPP_CHECK(amd.perfctr_nb);
+
+    cpuidpp::profiler p;
+    const std::size_t outer = p.region("outer");
+    const std::size_t inner = p.region("inner");
+
+    std::clog << "profiler counters available: " << p.available() << '\n';
+
+    const auto run = [&p, outer, inner]
+    {
+        for (int i = 0; i != 100; ++i) {
+            cpuidpp::profiler::scope o{p, outer};
+            work();
+
+            cpuidpp::profiler::scope s{p, inner};
+            work();
+        }
+    };
+
+    std::thread worker{run};
+    run();
+    worker.join();
+
+    const std::vector<cpuidpp::region_statistics> stats = p.statistics();
+
+    CPUIDPP_CHECK(stats.size() == 2);
+
+    for (const cpuidpp::region_statistics& r : stats) {
+        std::clog << r.name << ": " << r.calls << " calls, " << r.ticks
+            << " ticks";
+
+        for (std::uint64_t count : r.counts) {
+            std::clog << ", " << count;
+        }
+
+        std::clog << '\n';
+
+        CPUIDPP_CHECK(r.calls == 200);
+        CPUIDPP_CHECK(r.ticks != 0);
+        CPUIDPP_CHECK(r.counts.size() == p.counters().size());
+    }
+
+    if (stats.size() == 2) {
+        CPUIDPP_CHECK(stats[0].name == "outer" && stats[1].name == "inner");
+        CPUIDPP_CHECK(stats[0].ticks >= stats[1].ticks);
+
+        // The instructions of the outer region include the inner one
+        if (p.available()) {
+            CPUIDPP_CHECK(stats[0].counts[1] > stats[1].counts[1]);
+        }
+    }
+
+    // Thread identifiers are reused once a thread is joined. The
+    // measurements of the exited threads must be retained nevertheless.
+    for (int i = 0; i != 3; ++i) {
+        std::thread sequential{run};
+        sequential.join();
+    }
+
+    const std::vector<cpuidpp::region_statistics> retired = p.statistics();
+
+    CPUIDPP_CHECK(retired.size() == 2);
+
+    for (const cpuidpp::region_statistics& r : retired) {
+        CPUIDPP_CHECK(r.calls == 500);
+    }
+
+    bool unregistered = false;
+
+    try {
+        cpuidpp::profiler::scope s{p, stats.size()};
+    }
+    catch (const std::out_of_range&) {
+        unregistered = true;
+    }
+
+    CPUIDPP_CHECK(unregistered);
+
+    bool overflow = false;
+
+    try {
+        for (std::size_t i = stats.size(); i <= cpuidpp::profiler::max_regions;
+             ++i) {
+            p.region("region");
+        }
+    }
+    catch (const std::length_error&) {
+        overflow = true;
+    }
+
+    CPUIDPP_CHECK(overflow);
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
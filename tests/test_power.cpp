@@ -0,0 +1,120 @@
+/**
+ * @file
+ * @brief Checks the thermal and power management enumeration.
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <cpuidpp/cpuidpp.hpp>
+#include <cpuidpp/dump.hpp>
+#include <cpuidpp/power.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+using tests::make_record;
+
+//! Hybrid Intel desktop processor.
+std::vector<cpuidpp::cpuid_record> intel_hybrid()
+{
+    return std::vector<cpuidpp::cpuid_record>{
+        make_record(0x0, 0, 0x20, 0x756e6547, 0x6c65746e, 0x49656e69),
+        // DTS, Turbo Boost, ARAT, PLN, ECMD, PTM, HWP with notifications,
+        // activity window, EPP and package requests, HDC, Turbo Boost Max
+        // 3.0, HWP capabilities changes, HFI and Thread Director
+        make_record(0x6, 0, 0x0088eff7, 2, 0x401 | (1U << 3U), 0),
+        make_record(0x80000000, 0, 0x80000008, 0, 0, 0),
+        // Invariant TSC
+        make_record(0x80000007, 0, 0, 0, 0, 1U << 8U),
+    };
+}
+
+//! AMD processor with Core Performance Boost.
+std::vector<cpuidpp::cpuid_record> amd_boost()
+{
+    return std::vector<cpuidpp::cpuid_record>{
+        make_record(0x0, 0, 0x10, 0x68747541, 0x444d4163, 0x69746e65),
+        // ARAT and effective frequency interface
+        make_record(0x6, 0, 0x4, 0, 0x1, 0),
+        make_record(0x80000000, 0, 0x80000008, 0, 0, 0),
+        // HwPstate, invariant TSC, CPB, EffFreqRO and power reporting
+        make_record(0x80000007, 0, 0, 0, 0, 0x1780),
+    };
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+
+    const cpuidpp::power_info& power = cpuidpp::power_capabilities();
+
+    std::clog << "boost " << power.boost() << ", ARAT " << power.arat
+        << ", HWP " << power.hwp << ", EPP " << power.hwp_epp
+        << ", APERF/MPERF " << power.aperf_mperf << ", invariant TSC "
+        << power.invariant_tsc << '\n';
+
+    CPUIDPP_CHECK(&cpuidpp::power_capabilities() == &power);
+    CPUIDPP_CHECK(power.invariant_tsc == cpuidpp::invariant_tsc());
+    CPUIDPP_CHECK(power.hwp || !power.hwp_epp);
+
+    const cpuidpp::power_info intel =
+        cpuidpp::power_capabilities(cpuidpp::cpuid_dump{intel_hybrid(), 0});
+
+    CPUIDPP_CHECK(intel.digital_thermal_sensor);
+    CPUIDPP_CHECK(intel.thermal_thresholds == 2);
+    CPUIDPP_CHECK(intel.turbo);
+    CPUIDPP_CHECK(intel.turbo_max);
+    CPUIDPP_CHECK(intel.arat);
+    CPUIDPP_CHECK(intel.power_limit_notification);
+    CPUIDPP_CHECK(intel.package_thermal);
+    CPUIDPP_CHECK(intel.hwp);
+    CPUIDPP_CHECK(intel.hwp_notification);
+    CPUIDPP_CHECK(intel.hwp_activity_window);
+    CPUIDPP_CHECK(intel.hwp_epp);
+    CPUIDPP_CHECK(intel.hwp_package_request);
+    CPUIDPP_CHECK(intel.hdc);
+    CPUIDPP_CHECK(intel.hardware_feedback);
+    CPUIDPP_CHECK(intel.thread_director);
+    CPUIDPP_CHECK(intel.thread_director_classes == 4);
+    CPUIDPP_CHECK(intel.aperf_mperf);
+    CPUIDPP_CHECK(intel.energy_perf_bias);
+    CPUIDPP_CHECK(intel.invariant_tsc);
+    CPUIDPP_CHECK(!intel.core_performance_boost);
+    CPUIDPP_CHECK(intel.boost());
+
+    const cpuidpp::power_info amd =
+        cpuidpp::power_capabilities(cpuidpp::cpuid_dump{amd_boost(), 0});
+
+    CPUIDPP_CHECK(!amd.turbo);
+    CPUIDPP_CHECK(!amd.hwp);
+    CPUIDPP_CHECK(amd.arat);
+    CPUIDPP_CHECK(amd.aperf_mperf);
+    CPUIDPP_CHECK(amd.core_performance_boost);
+    CPUIDPP_CHECK(amd.hw_pstate);
+    CPUIDPP_CHECK(amd.eff_freq_read_only);
+    CPUIDPP_CHECK(amd.power_reporting);
+    CPUIDPP_CHECK(amd.invariant_tsc);
+    CPUIDPP_CHECK(amd.boost());
+
+    // Processors without leaf 6 report nothing
+    const cpuidpp::power_info none = cpuidpp::power_capabilities(
+        cpuidpp::cpuid_dump{std::vector<cpuidpp::cpuid_record>{
+            make_record(0x0, 0, 0x5, 0x756e6547, 0x6c65746e, 0x49656e69)},
+            0});
+
+    CPUIDPP_CHECK(!none.boost());
+    CPUIDPP_CHECK(!none.arat);
+    CPUIDPP_CHECK(!none.aperf_mperf);
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
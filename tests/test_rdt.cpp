@@ -0,0 +1,124 @@
+/**
+ * @file
+ * @brief Checks the enumeration of the Resource Director Technology.
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <cpuidpp/cpuidpp.hpp>
+#include <cpuidpp/dump.hpp>
+#include <cpuidpp/rdt.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+using tests::make_record;
+
+//! Leaves of a server processor relevant to RDT.
+std::vector<cpuidpp::cpuid_record> server()
+{
+    return std::vector<cpuidpp::cpuid_record>{
+        make_record(0x0, 0, 0x1b, 0x756e6547, 0x6c65746e, 0x49656e69),
+        // PQM and PQE
+        make_record(0x7, 0, 0, (1U << 12U) | (1U << 15U), 0, 0),
+        // 192 RMIDs monitoring the L3
+        make_record(0xF, 0, 0, 0xbf, 0, 1U << 1U),
+        // 44-bit counters with an overflow bit, occupancy and bandwidth
+        make_record(0xF, 1, 0x114, 0x10000, 0xbf, 0x7),
+        // L3 CAT and MBA
+        make_record(0x10, 0, 0, (1U << 1U) | (1U << 3U), 0, 0),
+        // 11 ways of which 2 are shared, CDP and 16 classes of service
+        make_record(0x10, 1, 0xa, 0x600, 1U << 2U, 0xf),
+        // Linear throttling up to 90 % and 8 classes of service
+        make_record(0x10, 3, 89, 0, 1U << 2U, 0x7),
+    };
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+
+    const cpuidpp::rdt_info& rdt = cpuidpp::rdt_capabilities();
+
+    std::clog << "monitoring: L3 " << rdt.monitoring.l3 << ", RMIDs "
+        << rdt.monitoring.max_rmid << '\n'
+        << "L3 CAT: " << rdt.l3.supported << ", " << rdt.l3.ways
+        << " ways, " << rdt.l3.classes << " classes, CDP " << rdt.l3.cdp
+        << '\n'
+        << "L2 CAT: " << rdt.l2.supported << ", " << rdt.l2.ways
+        << " ways, " << rdt.l2.classes << " classes\n"
+        << "MBA: " << rdt.bandwidth.supported << ", max "
+        << rdt.bandwidth.max_throttle << ", granularity "
+        << rdt.bandwidth.granularity << '\n';
+
+    CPUIDPP_CHECK(&cpuidpp::rdt_capabilities() == &rdt);
+    CPUIDPP_CHECK(cpuidpp::pqm() || !rdt.monitoring.l3);
+    CPUIDPP_CHECK(cpuidpp::pqe() || !rdt.l3.supported);
+    CPUIDPP_CHECK(cpuidpp::pqe() || !rdt.bandwidth.supported);
+
+    const cpuidpp::rdt_info replayed =
+        cpuidpp::rdt_capabilities(cpuidpp::cpuid_dump{server(), 0});
+
+    const cpuidpp::rdt_monitoring& m = replayed.monitoring;
+
+    CPUIDPP_CHECK(m.max_rmid == 191);
+    CPUIDPP_CHECK(m.l3);
+    CPUIDPP_CHECK(m.l3_max_rmid == 191);
+    CPUIDPP_CHECK(m.l3_occupancy);
+    CPUIDPP_CHECK(m.total_bandwidth);
+    CPUIDPP_CHECK(m.local_bandwidth);
+    CPUIDPP_CHECK(m.upscaling_factor == 0x10000);
+    CPUIDPP_CHECK(m.counter_width == 44);
+    CPUIDPP_CHECK(m.overflow_bit);
+
+    CPUIDPP_CHECK(replayed.l3.supported);
+    CPUIDPP_CHECK(replayed.l3.ways == 11);
+    CPUIDPP_CHECK(replayed.l3.shared_ways == 0x600);
+    CPUIDPP_CHECK(replayed.l3.classes == 16);
+    CPUIDPP_CHECK(replayed.l3.cdp);
+    CPUIDPP_CHECK(!replayed.l3.noncontiguous);
+    CPUIDPP_CHECK(!replayed.l2.supported);
+    CPUIDPP_CHECK(replayed.l2.ways == 0);
+
+    CPUIDPP_CHECK(replayed.bandwidth.supported);
+    CPUIDPP_CHECK(replayed.bandwidth.max_throttle == 90);
+    CPUIDPP_CHECK(replayed.bandwidth.linear);
+    CPUIDPP_CHECK(replayed.bandwidth.granularity == 10);
+    CPUIDPP_CHECK(replayed.bandwidth.classes == 8);
+
+    // Partition the 11 ways, e.g., into 4 isolated and 7 shared ones
+    CPUIDPP_CHECK(replayed.l3.mask(0, 4) == 0xf);
+    CPUIDPP_CHECK(replayed.l3.mask(4, 7) == 0x7f0);
+    CPUIDPP_CHECK(replayed.l3.mask(4, 8) == 0);
+    CPUIDPP_CHECK(replayed.l3.mask(11, 1) == 0);
+    CPUIDPP_CHECK(replayed.l3.mask(0, 0) == 0);
+
+    cpuidpp::rdt_cache_allocation wide{};
+    wide.ways = 32;
+
+    CPUIDPP_CHECK(wide.mask(0, 32) == ~std::uint32_t{0});
+
+    // Without PQM and PQE the leaves are not decoded
+    std::vector<cpuidpp::cpuid_record> records = server();
+    records[1] = make_record(0x7, 0, 0, 0, 0, 0);
+
+    const cpuidpp::rdt_info none =
+        cpuidpp::rdt_capabilities(cpuidpp::cpuid_dump{records, 0});
+
+    CPUIDPP_CHECK(!none.monitoring.l3);
+    CPUIDPP_CHECK(none.monitoring.max_rmid == 0);
+    CPUIDPP_CHECK(!none.l3.supported);
+    CPUIDPP_CHECK(!none.bandwidth.supported);
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
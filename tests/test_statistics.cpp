@@ -0,0 +1,115 @@
+/**
+ * @file
+ * @brief Checks the instrumentation of CPUID executions.
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <cpuidpp/cpuidpp.hpp>
+#include <cpuidpp/statistics.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+std::atomic<unsigned> hooked{0};
+
+void count_execution(std::uint32_t /*leaf*/, std::uint32_t /*subleaf*/,
+                     std::uint64_t /*cycles*/)
+{
+    hooked.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::uint64_t total_executions()
+{
+    std::uint64_t total = 0;
+
+    for (const cpuidpp::leaf_statistics& s : cpuidpp::cpuid_statistics()) {
+        total += s.executions;
+    }
+
+    return total;
+}
+
+const cpuidpp::leaf_statistics* find(
+    const std::vector<cpuidpp::leaf_statistics>& stats, std::uint32_t leaf)
+{
+    for (const cpuidpp::leaf_statistics& s : stats) {
+        if (s.leaf == leaf) {
+            return &s;
+        }
+    }
+
+    return nullptr;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+
+    // Initialize the library state before counting
+    const bool avx2 = cpuidpp::avx2();
+
+    cpuidpp::enable_cpuid_statistics(true);
+    cpuidpp::reset_cpuid_statistics();
+
+    CPUIDPP_CHECK(cpuidpp::cpuid_statistics_enabled());
+    CPUIDPP_CHECK(cpuidpp::cpuid_statistics().empty());
+
+    // Queries after initialization do not execute CPUID
+    CPUIDPP_CHECK(cpuidpp::avx2() == avx2);
+    CPUIDPP_CHECK(cpuidpp::features().avx2() == avx2);
+    cpuidpp::vendor();
+    cpuidpp::cache_info();
+
+    CPUIDPP_CHECK(total_executions() == 0);
+
+    cpuidpp::snapshot s;
+    cpuidpp::detect(s);
+
+    const std::vector<cpuidpp::leaf_statistics> stats =
+        cpuidpp::cpuid_statistics();
+
+    for (const cpuidpp::leaf_statistics& leaf : stats) {
+        std::clog << "leaf 0x" << std::hex << leaf.leaf << std::dec << ": "
+            << leaf.executions << " executions, " << leaf.total_cycles
+            << " cycles, max " << leaf.max_cycles << '\n';
+
+        CPUIDPP_CHECK(leaf.executions > 0);
+        CPUIDPP_CHECK(leaf.max_cycles <= leaf.total_cycles);
+    }
+
+    const cpuidpp::leaf_statistics* const leaf0 = find(stats, 0);
+
+    CPUIDPP_CHECK(leaf0 != nullptr && leaf0->executions == 1);
+    CPUIDPP_CHECK(find(stats, 0x80000000) != nullptr);
+
+    // The hook is invoked independently of the statistics
+    cpuidpp::enable_cpuid_statistics(false);
+    cpuidpp::reset_cpuid_statistics();
+    cpuidpp::set_cpuid_hook(count_execution);
+
+    cpuidpp::detect(s);
+
+    CPUIDPP_CHECK(hooked.load() > 0);
+    CPUIDPP_CHECK(total_executions() == 0);
+
+    cpuidpp::set_cpuid_hook(nullptr);
+
+    const unsigned calls = hooked.load();
+    cpuidpp::detect(s);
+
+    CPUIDPP_CHECK(hooked.load() == calls);
+    CPUIDPP_CHECK(total_executions() == 0);
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
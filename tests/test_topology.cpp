@@ -0,0 +1,280 @@
+/**
+ * @file
+ * @brief Prints the processor topology.
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <cpuidpp/dump.hpp>
+#include <cpuidpp/topology.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+using tests::any;
+using tests::make_record;
+
+/**
+ * @brief Describes two AMD packages with two core complexes each. Every
+ *        complex consists of two cores with two SMT siblings sharing an L3.
+ *
+ * The x2APIC ID of each logical processor equals its OS index.
+ */
+cpuidpp::cpuid_dump make_epyc_dump()
+{
+    std::vector<cpuidpp::cpuid_record> records{
+        // "AuthenticAMD"
+        make_record(any, 0x0, 0, 0xB, 0x68747541, 0x444d4163, 0x69746e65),
+        make_record(any, 0x80000000, 0, 0x8000001D, 0, 0, 0),
+        // TOPOEXT
+        make_record(any, 0x80000001, 0, 0, 0, 1U << 22U, 0),
+        // L1 data cache shared by 2 and L3 shared by 4 logical processors
+        make_record(any, 0x8000001D, 0, 0x21 | (1U << 14U), 0x01c0003f, 63, 0),
+        make_record(any, 0x8000001D, 1, 0x63 | (3U << 14U), 0x03c0003f, 8191,
+                    0),
+    };
+
+    for (std::uint32_t cpu = 0; cpu != 16; ++cpu) {
+        // SMT level followed by the core level
+        records.push_back(make_record(cpu, 0xB, 0, 1, 2, 0x100, cpu));
+        records.push_back(make_record(cpu, 0xB, 1, 3, 8, 0x201, cpu));
+    }
+
+    return cpuidpp::cpuid_dump{std::move(records), 0xe7};
+}
+
+/**
+ * @brief Describes a hybrid Intel processor with two performance cores of two
+ *        SMT siblings each and four efficiency cores without SMT.
+ *
+ * The logical processors 0 to 3 belong to the performance cores and 4 to 7
+ * to the efficiency cores.
+ */
+cpuidpp::cpuid_dump make_hybrid_dump()
+{
+    std::vector<cpuidpp::cpuid_record> records{
+        // "GenuineIntel"
+        make_record(any, 0x0, 0, 0x1A, 0x756e6547, 0x6c65746e, 0x49656e69),
+        // Hybrid
+        make_record(any, 0x7, 0, 0, 0, 0, 1U << 15U),
+    };
+
+    const std::uint32_t apic_ids[] = {0, 1, 2, 3, 8, 10, 12, 14};
+
+    for (std::uint32_t cpu = 0; cpu != 8; ++cpu) {
+        const std::uint32_t apic_id = apic_ids[cpu];
+        // Core (0x40) or Atom (0x20) along with the native model ID
+        const std::uint32_t type = cpu < 4 ? 0x40 : 0x20;
+
+        records.push_back(make_record(cpu, 0xB, 0, 1, 2, 0x100, apic_id));
+        records.push_back(make_record(cpu, 0xB, 1, 4, 8, 0x201, apic_id));
+        records.push_back(make_record(cpu, 0x1A, 0, (type << 24U) | 1U, 0, 0,
+                                      0));
+    }
+
+    return cpuidpp::cpuid_dump{std::move(records), 0xe7};
+}
+
+/**
+ * @brief Source whose topology and cache leaves never report a terminating
+ *        subleaf.
+ */
+class EndlessSource : public cpuidpp::cpuid_source
+{
+public:
+    void query(std::uint32_t, std::uint32_t leaf, std::uint32_t subleaf,
+               std::uint32_t (&regs)[4]) const override
+    {
+        regs[0] = regs[1] = regs[2] = regs[3] = 0;
+
+        switch (leaf) {
+            case 0x0:
+                // "GenuineIntel"
+                regs[0] = 0xB;
+                regs[1] = 0x756e6547;
+                regs[2] = 0x6c65746e;
+                regs[3] = 0x49656e69;
+                break;
+            case 0x4:
+                // Level 1 data cache
+                regs[0] = 0x21;
+                break;
+            case 0xB:
+                // SMT level
+                regs[0] = 1;
+                regs[1] = 1;
+                regs[2] = 0x100 | (subleaf & 0xffU);
+                break;
+        }
+    }
+
+    std::uint64_t xcr0() const override
+    {
+        return 0;
+    }
+
+    std::vector<std::uint32_t> cpus() const override
+    {
+        return std::vector<std::uint32_t>{0};
+    }
+};
+
+//! Returns the logical processor of each single-processor mask.
+std::vector<unsigned> assigned(const std::vector<cpuidpp::cpu_set>& masks)
+{
+    std::vector<unsigned> result;
+
+    for (const cpuidpp::cpu_set& mask : masks) {
+        const std::vector<unsigned> cpus = mask.to_vector();
+        result.push_back(cpus.size() == 1 ? cpus.front() : ~0U);
+    }
+
+    return result;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+
+    const cpuidpp::topology& t = cpuidpp::cpu_topology();
+
+    std::clog << "cpus: " << t.cpus().size()
+        << ", cores: " << t.cores()
+        << ", packages: " << t.packages() << '\n';
+
+    std::clog << std::setw(6) << "cpu"
+        << std::setw(10) << "apic"
+        << std::setw(6) << "smt"
+        << std::setw(8) << "core"
+        << std::setw(8) << "module"
+        << std::setw(6) << "llc"
+        << std::setw(6) << "die"
+        << std::setw(9) << "package"
+        << std::setw(6) << "type"
+        << std::setw(10) << "model" << '\n';
+
+    for (const cpuidpp::logical_cpu& cpu : t.cpus()) {
+        std::clog << std::setw(6) << cpu.index
+            << std::setw(10) << cpu.apic_id
+            << std::setw(6) << cpu.smt
+            << std::setw(8) << cpu.core
+            << std::setw(8) << cpu.module
+            << std::setw(6) << cpu.llc
+            << std::setw(6) << cpu.die
+            << std::setw(9) << cpu.package
+            << std::setw(6) << std::hex << static_cast<unsigned>(cpu.type)
+            << std::setw(10) << cpu.native_model << std::dec << '\n';
+
+        CPUIDPP_CHECK(t.find(cpu.index) == &cpu);
+        CPUIDPP_CHECK(t.siblings(cpu.index).contains(cpu.index));
+    }
+
+    CPUIDPP_CHECK(!t.cpus().empty());
+    CPUIDPP_CHECK(t.all().size() == t.cpus().size());
+    CPUIDPP_CHECK(t.one_per_core().size() == t.cores());
+    CPUIDPP_CHECK(t.packages() >= 1 && t.packages() <= t.cores());
+    CPUIDPP_CHECK(!t.performance_cpus().empty());
+    CPUIDPP_CHECK(t.hybrid() || t.performance_cpus() == t.all());
+    CPUIDPP_CHECK(!t.cache_domains().empty());
+    CPUIDPP_CHECK(t.place(3, cpuidpp::placement::compact).size() == 3);
+
+    const cpuidpp::topology epyc = cpuidpp::cpu_topology(make_epyc_dump());
+
+    CPUIDPP_CHECK(epyc.cpus().size() == 16);
+    CPUIDPP_CHECK(epyc.cores() == 8);
+    CPUIDPP_CHECK(epyc.packages() == 2);
+
+    const std::vector<cpuidpp::cpu_set> domains = epyc.cache_domains();
+
+    CPUIDPP_CHECK(domains.size() == 4);
+
+    for (std::size_t d = 0; d != domains.size(); ++d) {
+        CPUIDPP_CHECK(domains[d].size() == 4);
+        CPUIDPP_CHECK(domains[d].contains(static_cast<unsigned>(d * 4)));
+    }
+
+    // Cores receive a worker before their SMT siblings
+    CPUIDPP_CHECK((assigned(epyc.place(4, cpuidpp::placement::compact)) ==
+                   std::vector<unsigned>{0, 2, 1, 3}));
+    CPUIDPP_CHECK((assigned(epyc.place(2, cpuidpp::placement::compact,
+                                       true)) ==
+                   std::vector<unsigned>{0, 2}));
+    // Workers exceeding a domain continue in the same package
+    CPUIDPP_CHECK((assigned(epyc.place(6, cpuidpp::placement::compact)) ==
+                   std::vector<unsigned>{0, 2, 1, 3, 4, 6}));
+    // Packages alternate before the domains within a package
+    CPUIDPP_CHECK((assigned(epyc.place(4, cpuidpp::placement::spread,
+                                       true)) ==
+                   std::vector<unsigned>{0, 8, 4, 12}));
+
+    const std::vector<cpuidpp::cpu_set> wrapped =
+        epyc.place(10, cpuidpp::placement::spread, true);
+
+    CPUIDPP_CHECK(wrapped.size() == 10);
+    CPUIDPP_CHECK(wrapped[8] == wrapped[0] && wrapped[9] == wrapped[1]);
+
+    const cpuidpp::topology hybrid = cpuidpp::cpu_topology(make_hybrid_dump());
+
+    CPUIDPP_CHECK(hybrid.cpus().size() == 8);
+    CPUIDPP_CHECK(hybrid.cores() == 6);
+    CPUIDPP_CHECK(hybrid.hybrid());
+
+    for (const cpuidpp::logical_cpu& cpu : hybrid.cpus()) {
+        CPUIDPP_CHECK(cpu.type == (cpu.index < 4
+            ? cpuidpp::core_type::performance
+            : cpuidpp::core_type::efficiency));
+        CPUIDPP_CHECK(cpu.native_model == 1);
+    }
+
+    CPUIDPP_CHECK((hybrid.cpus_of_type(cpuidpp::core_type::performance)
+        .to_vector() == std::vector<unsigned>{0, 1, 2, 3}));
+    CPUIDPP_CHECK((hybrid.cpus_of_type(cpuidpp::core_type::efficiency)
+        .to_vector() == std::vector<unsigned>{4, 5, 6, 7}));
+    CPUIDPP_CHECK(hybrid.cpus_of_type(cpuidpp::core_type::unknown).empty());
+    CPUIDPP_CHECK(hybrid.performance_cpus() ==
+                  hybrid.cpus_of_type(cpuidpp::core_type::performance));
+    CPUIDPP_CHECK(hybrid.siblings(0).size() == 2);
+    CPUIDPP_CHECK(hybrid.siblings(4).size() == 1);
+
+    // A processor with a single core type is not hybrid
+    CPUIDPP_CHECK(!epyc.hybrid());
+    CPUIDPP_CHECK(epyc.performance_cpus() == epyc.all());
+
+    // Walks over subleaves terminate even if the source never ends them
+    const EndlessSource endless;
+
+    CPUIDPP_CHECK(cpuidpp::cpu_topology(endless).cpus().size() == 1);
+    CPUIDPP_CHECK(cpuidpp::cache_info(endless).size() == 64);
+
+    // Compact placement skips a domain too small to hold all workers
+    std::vector<cpuidpp::logical_cpu> partial(epyc.cpus().begin() + 2,
+                                              epyc.cpus().end());
+    const cpuidpp::topology restricted{std::move(partial)};
+
+    CPUIDPP_CHECK((assigned(restricted.place(3,
+                                             cpuidpp::placement::compact)) ==
+                   std::vector<unsigned>{4, 6, 5}));
+    CPUIDPP_CHECK(cpuidpp::topology{{}}.place(2,
+                  cpuidpp::placement::spread).empty());
+
+    cpuidpp::cpu_set set;
+    set.insert(3);
+    set.insert(70);
+    CPUIDPP_CHECK(set.size() == 2 && set.words().size() == 2);
+    set.erase(70);
+    CPUIDPP_CHECK(set.words().size() == 1 && set.contains(3));
+    CPUIDPP_CHECK(set.to_vector() == std::vector<unsigned>{3});
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file
+ * @brief Compares the Time Stamp Counter clock with the steady clock.
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#include <cpuidpp/tsc.hpp>
+
+#include "check.hpp"
+
+int main()
+{
+    int failures = 0;
+
+    const char* const sources[] = { "cpuid", "hypervisor", "calibration" };
+
+    std::clog << "invariant: " << (cpuidpp::invariant_tsc() ? "yes" : "no")
+        << '\n' << "frequency: " << cpuidpp::tsc_frequency() << " Hz ("
+        << sources[static_cast<int>(cpuidpp::tsc_frequency_source())] << ")\n";
+
+    CPUIDPP_CHECK(cpuidpp::tsc_frequency() > 0);
+    CPUIDPP_CHECK(cpuidpp::tsc_clock::steady() == cpuidpp::invariant_tsc());
+
+    // Keep the computation of the conversion factor out of the measurement
+    cpuidpp::tsc_clock::init();
+
+    const auto steady_start = std::chrono::steady_clock::now();
+    const cpuidpp::tsc_clock::time_point start = cpuidpp::tsc_clock::now();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+
+    const cpuidpp::tsc_clock::time_point stop =
+        cpuidpp::tsc_clock::serialized_now();
+    const auto steady_stop = std::chrono::steady_clock::now();
+
+    const auto elapsed = stop - start;
+    const auto steady_elapsed = std::chrono::duration_cast<
+        std::chrono::nanoseconds>(steady_stop - steady_start);
+
+    std::clog << "elapsed: " << elapsed.count() << " ns (steady clock: "
+        << steady_elapsed.count() << " ns)\n";
+
+    CPUIDPP_CHECK(elapsed.count() > 0);
+    // Allow for a coarse tolerance since the threads may be preempted
+    CPUIDPP_CHECK(elapsed > steady_elapsed / 2 && elapsed < steady_elapsed * 2);
+
+    CPUIDPP_CHECK(cpuidpp::tsc_clock::to_duration(cpuidpp::tsc_frequency())
+        - std::chrono::seconds{1} < std::chrono::microseconds{1});
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
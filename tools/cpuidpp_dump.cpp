@@ -0,0 +1,166 @@
+/**
+ * @file
+ * @brief Captures and inspects %cpuidpp dumps.
+ *
+ * @code
+ * cpuidpp_dump capture <file>
+ * cpuidpp_dump show <file>
+ * @endcode
+ *
+ * @c capture executes all @c CPUID leaves, including the topology leaves of
+ * each logical processor, and saves them to @c file. @c show prints the
+ * records of a dump along with the processor, caches and topology they
+ * describe. Replaying the dump through the @c CPUIDPP_REPLAY environment
+ * variable reproduces them in any program using the library.
+ *
+ * @copyright © 2024 Sergiu Deitsch. Distributed under the Boost Software
+ * License, Version 1.0. (See accompanying file LICENSE or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <cpuidpp/cpuidpp.hpp>
+#include <cpuidpp/dump.hpp>
+#include <cpuidpp/feature.hpp>
+#include <cpuidpp/hypervisor.hpp>
+#include <cpuidpp/power.hpp>
+#include <cpuidpp/rdt.hpp>
+#include <cpuidpp/topology.hpp>
+
+namespace {
+
+int usage()
+{
+    std::fputs("usage: cpuidpp_dump capture <file>\n"
+               "       cpuidpp_dump show <file>\n", stderr);
+    return EXIT_FAILURE;
+}
+
+int capture(const char* path)
+{
+    const cpuidpp::cpuid_dump dump = cpuidpp::cpuid_dump::capture_all_cpus();
+
+    if (!dump.save(path)) {
+        std::fprintf(stderr, "cpuidpp_dump: cannot write %s\n", path);
+        return EXIT_FAILURE;
+    }
+
+    std::printf("%zu records of %zu logical processors written to %s\n",
+                dump.size(), dump.cpus().size(), path);
+
+    return EXIT_SUCCESS;
+}
+
+const char* cache_type_name(cpuidpp::cache_type type)
+{
+    switch (type) {
+    case cpuidpp::cache_type::data:
+        return "data";
+    case cpuidpp::cache_type::instruction:
+        return "instruction";
+    case cpuidpp::cache_type::unified:
+        return "unified";
+    default:
+        return "unknown";
+    }
+}
+
+int show(const char* path)
+{
+    cpuidpp::cpuid_dump dump;
+
+    if (!dump.load(path)) {
+        std::fprintf(stderr, "cpuidpp_dump: %s is not a valid dump\n", path);
+        return EXIT_FAILURE;
+    }
+
+    std::printf("%-8s %-10s %-8s %-10s %-10s %-10s %-10s\n", "cpu", "leaf",
+                "subleaf", "eax", "ebx", "ecx", "edx");
+
+    for (const cpuidpp::cpuid_record& r : dump) {
+        char cpu[16] = "*";
+
+        if (r.cpu != cpuidpp::cpuid_dump::any_cpu) {
+            std::snprintf(cpu, sizeof cpu, "%u", static_cast<unsigned>(r.cpu));
+        }
+
+        std::printf("%-8s 0x%08x %-8u 0x%08x 0x%08x 0x%08x 0x%08x\n", cpu,
+                    static_cast<unsigned>(r.leaf),
+                    static_cast<unsigned>(r.subleaf),
+                    static_cast<unsigned>(r.regs[0]),
+                    static_cast<unsigned>(r.regs[1]),
+                    static_cast<unsigned>(r.regs[2]),
+                    static_cast<unsigned>(r.regs[3]));
+    }
+
+    cpuidpp::snapshot s;
+    cpuidpp::detect(s, dump);
+
+    std::printf("\nvendor:     %s\n", s.vendor_id);
+    std::printf("model:      %s\n", s.brand);
+    std::printf("xcr0:       0x%llx\n",
+                static_cast<unsigned long long>(dump.xcr0()));
+    std::printf("x86-64:     v%u\n", cpuidpp::x86_64_level(s));
+    std::printf("host:       %s\n", dump.matches_host() ? "yes" : "no");
+    std::printf("hypervisor: %s\n",
+                cpuidpp::to_string(cpuidpp::current_hypervisor(dump).vendor));
+
+    for (const cpuidpp::cache& c : cpuidpp::cache_info(dump)) {
+        std::printf("L%u %-11s %zu KiB, %u-way, %u B lines, shared by %u\n",
+                    c.level, cache_type_name(c.type), c.size / 1024, c.ways,
+                    c.line_size, c.shared_by);
+    }
+
+    const cpuidpp::power_info power = cpuidpp::power_capabilities(dump);
+
+    std::printf("power:      boost %s, ARAT %s, HWP %s, EPP %s, APERF/MPERF %s\n",
+                power.boost() ? "yes" : "no", power.arat ? "yes" : "no",
+                power.hwp ? "yes" : "no", power.hwp_epp ? "yes" : "no",
+                power.aperf_mperf ? "yes" : "no");
+
+    const cpuidpp::rdt_info rdt = cpuidpp::rdt_capabilities(dump);
+
+    for (const cpuidpp::rdt_cache_allocation* cat : {&rdt.l3, &rdt.l2}) {
+        if (cat->supported) {
+            std::printf("L%d CAT:     %u ways, %u classes of service%s\n",
+                        cat == &rdt.l3 ? 3 : 2, cat->ways, cat->classes,
+                        cat->cdp ? ", CDP" : "");
+        }
+    }
+
+    if (rdt.bandwidth.supported) {
+        std::printf("MBA:        up to %u %%, %u classes of service\n",
+                    rdt.bandwidth.max_throttle, rdt.bandwidth.classes);
+    }
+
+    const cpuidpp::topology topo = cpuidpp::cpu_topology(dump);
+
+    std::printf("topology:   %zu logical processors, %zu cores, %zu packages, "
+                "%zu cache domains\n", topo.cpus().size(), topo.cores(),
+                topo.packages(), topo.cache_domains().size());
+
+    return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc != 3) {
+        return usage();
+    }
+
+    if (std::strcmp(argv[1], "capture") == 0) {
+        return capture(argv[2]);
+    }
+
+    if (std::strcmp(argv[1], "show") == 0) {
+        return show(argv[2]);
+    }
+
+    return usage();
+}